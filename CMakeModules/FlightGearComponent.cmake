@@ -17,3 +17,23 @@ macro(flightgear_component name sources)
     set_property(GLOBAL APPEND PROPERTY FG_GROUPS_C "${fc}@")
     set_property(GLOBAL APPEND PROPERTY FG_GROUPS_H "${fh}@")
 endmacro()
+
+# Extra compile flags for a single source of a component.  Source file
+# properties are only visible in the directory setting them, so they are
+# recorded here and applied by setup_fgfs_source_flags() in the directories
+# defining the executables.
+macro(flightgear_source_flags source flags)
+    set_property(GLOBAL
+        APPEND PROPERTY FG_SOURCE_FLAGS "${CMAKE_CURRENT_SOURCE_DIR}/${source}=${flags}")
+endmacro()
+
+function(setup_fgfs_source_flags)
+    get_property(sourceFlags GLOBAL PROPERTY FG_SOURCE_FLAGS)
+    foreach(entry ${sourceFlags})
+        string(FIND "${entry}" "=" sep)
+        string(SUBSTRING "${entry}" 0 ${sep} source)
+        math(EXPR sep "${sep} + 1")
+        string(SUBSTRING "${entry}" ${sep} -1 flags)
+        set_source_files_properties(${source} PROPERTIES COMPILE_FLAGS "${flags}")
+    endforeach()
+endfunction()
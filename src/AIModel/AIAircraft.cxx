@@ -550,6 +550,7 @@ void FGAIAircraft::getGroundElev(double dt) {
             double alt;
             if (getGroundElevationM(SGGeod::fromGeodM(pos, 20000), alt, 0))
             {
+                setGroundElevationM(alt);
                 tgt_altitude_ft = alt * SG_METER_TO_FEET;
                 if (isStationary())
                 {
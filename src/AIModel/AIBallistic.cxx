@@ -508,8 +508,10 @@ void FGAIBallistic::setForcePath(const string& p) {
 
 bool FGAIBallistic::getHtAGL(double start) {
     const simgear::BVHMaterial* mat = 0;
+    double elev_m;
     if (getGroundElevationM(SGGeod::fromGeodM(pos, start),
-        _elevation_m, &mat)) {
+        elev_m, &mat)) {
+            setGroundElevationM(elev_m);
             const SGMaterial* material = dynamic_cast<const SGMaterial*>(mat);
             _ht_agl_ft = pos.getElevationFt() - _elevation_m * SG_METER_TO_FEET;
 
@@ -732,6 +734,10 @@ void FGAIBallistic::Run(double dt) {
         _wind_from_north = 0;
         _wind_from_east = 0;
     }
+    else if (const auto* atmosphere = getAtmosphere()) {
+        _wind_from_north = atmosphere->windFromNorthFps;
+        _wind_from_east = atmosphere->windFromEastFps;
+    }
     else {
         _wind_from_north = manager->get_wind_from_north();
         _wind_from_east = manager->get_wind_from_east();
@@ -187,7 +187,6 @@ private:
     double _load_resistance; // ground load resistanc N/m^2
     double _frictionFactor;  // dimensionless modifier for Coefficient of Friction
     bool   _solid;           // if true ground is solid for FDMs
-    double _elevation_m;     // ground elevation in meters
     bool   _force_stabilised;// if true, object will align to external force
     bool   _slave_to_ac;     // if true, object will be slaved to the parent ac pos and orientation
     bool   _slave_load_to_ac;// if true, object will be slaved to the parent ac pos
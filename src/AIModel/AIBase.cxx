@@ -44,6 +44,7 @@
 #include <Main/globals.hxx>
 #include <Main/fg_props.hxx>
 #include <Scenery/scenery.hxx>
+#include <Scenery/terrainquery.hxx>
 #include <Scripting/NasalSys.hxx>
 #include <Scripting/NasalModelData.hxx>
 #include <Sound/fg_fx.hxx>
@@ -164,6 +165,8 @@ FGAIBase::FGAIBase(object_type ot, bool enableHot) :
     pos = SGGeod::fromDeg(0, 0);
     speed = 0;
     altitude_ft = 0;
+    _elevation_m = 0;
+    _hasGroundElevation = false;
     speed_north_deg_sec = 0;
     speed_east_deg_sec = 0;
     turn_radius_ft = 0;
@@ -858,8 +861,14 @@ SGVec3d FGAIBase::getCartPos() const {
 
 bool FGAIBase::getGroundElevationM(const SGGeod& pos, double& elev,
                                    const simgear::BVHMaterial** material) const {
-    return globals->get_scenery()->get_elevation_m(pos, elev, material,
-                                                   _model.get());
+    // The model lives in the models branch, never in the terrain one, so
+    // it cannot get in the way and the shared elevation cache can be used.
+    FGScenery* scenery = globals->get_scenery();
+    if (FGTerrainQuery* query = scenery->get_terrain_query()) {
+        return query->get_elevation_m(pos, elev, material);
+    }
+
+    return scenery->get_elevation_m(pos, elev, material, _model.get());
 }
 
 double FGAIBase::_getCartPosX() const {
@@ -972,11 +981,19 @@ double FGAIBase::_getAltitude() const {
 }
 
 double FGAIBase::_getAltitudeAGL(SGGeod inpos, double start){
-    getGroundElevationM(SGGeod::fromGeodM(inpos, start),
-        _elevation_m, NULL);
+    double elev_m;
+    if (getGroundElevationM(SGGeod::fromGeodM(inpos, start), elev_m, NULL))
+        setGroundElevationM(elev_m);
     return inpos.getElevationFt() - _elevation_m * SG_METER_TO_FEET;
 }
 
+bool FGAIBase::getGroundClearanceFt(double& clearanceFt) const {
+    if (!_hasGroundElevation)
+        return false;
+    clearanceFt = pos.getElevationFt() - _elevation_m * SG_METER_TO_FEET;
+    return true;
+}
+
 bool FGAIBase::_getServiceable() const {
     return serviceable;
 }
@@ -33,6 +33,8 @@
 
 #include <simgear/math/sg_geodesy.hxx>
 
+#include <Environment/atmospherefield.hxx>
+
 namespace osg { class PagedLOD; }
 
 namespace simgear {
@@ -124,6 +126,8 @@ public:
 
     bool getDie();
     bool isValid() const;
+    bool isInvisible() const
+    { return invisible; }
 
     void setFlightPlan(std::unique_ptr<FGAIFlightPlan> f);
 
@@ -136,6 +140,30 @@ public:
     bool getGroundElevationM(const SGGeod& pos, double& elev,
                              const simgear::BVHMaterial** material) const;
 
+    /**
+     * Altitude above the terrain under the model.  The default reports the
+     * last ground elevation recorded with setGroundElevationM(); models
+     * which know their clearance otherwise override this.
+     *
+     * @return false if the model does not know the ground under it
+     */
+    virtual bool getGroundClearanceFt(double& clearanceFt) const;
+
+    /**
+     * Wind and air mass at the model's position, set by FGAIManager before
+     * each update.  NULL when the environment does not provide them (yet).
+     */
+    const Environment::AtmosphereField::Sample* getAtmosphere() const
+    { return _hasAtmosphere ? &_atmosphere : nullptr; }
+
+    void setAtmosphere(const Environment::AtmosphereField::Sample& atmosphere)
+    {
+        _atmosphere = atmosphere;
+        _hasAtmosphere = true;
+    }
+
+    void clearAtmosphere() { _hasAtmosphere = false; }
+
 
     double _getCartPosX() const;
     double _getCartPosY() const;
@@ -143,7 +171,14 @@ public:
 
     osg::PagedLOD* getSceneBranch() const;
 protected:
+    void setGroundElevationM(double elevM)
+    {
+        _elevation_m = elevM;
+        _hasGroundElevation = true;
+    }
+
     double _elevation_m;
+    bool _hasGroundElevation;
 
     double _maxRangeInterior;
 
@@ -267,6 +302,9 @@ private:
 
     SGSharedPtr<FGFX>  _fx;
 
+    Environment::AtmosphereField::Sample _atmosphere;
+    bool _hasAtmosphere = false;
+
     std::vector<std::string> resolveModelPath(ModelSearchOrder searchOrder);
 
 public:
@@ -33,6 +33,7 @@
 #include <Airports/airport.hxx>
 #include <Scripting/NasalSys.hxx>
 #include <Add-ons/AddonManager.hxx>
+#include <Environment/environment_mgr.hxx>
 
 #include "AIManager.hxx"
 #include "AIAircraft.hxx"
@@ -133,6 +134,7 @@ FGAIManager::init() {
     wind_from_north_node = fgGetNode("/environment/wind-from-north-fps",true);
 
     user_altitude_agl_node  = fgGetNode("/position/altitude-agl-ft", true);
+    user_ground_elev_node   = fgGetNode("/position/ground-elev-ft", true);
     user_speed_node     = fgGetNode("/velocities/uBody-fps", true);
 
     globals->get_commands()->addCommand("load-scenario", this, &FGAIManager::loadScenarioCommand);
@@ -361,6 +363,8 @@ FGAIManager::update(double dt)
 
     ai_list.erase(ai_list.begin(), firstAlive);
 
+    updateAtmosphere();
+
     // every remaining item is alive. update them in turn, but guard for
     // exceptions, so a single misbehaving AI object doesn't bring down the
     // entire subsystem.
@@ -379,6 +383,80 @@ FGAIManager::update(double dt)
     } // of live AI objects iteration
 
     thermal_lift_node->setDoubleValue( strength );  // for thermals
+    updateTrafficSnapshot();
+}
+
+void
+FGAIManager::updateAtmosphere()
+{
+    FGEnvironmentMgr* envMgr = globals->get_subsystem<FGEnvironmentMgr>();
+    updateAtmosphere(envMgr ? &envMgr->getAtmosphereField() : nullptr, ai_list,
+                     user_ground_elev_node->getDoubleValue());
+}
+
+void
+FGAIManager::updateAtmosphere(const Environment::AtmosphereField* field,
+                              const ai_list_type& models, double userGroundFt)
+{
+    // without a field, models fall back to the user's values rather than
+    // keep a sample which is no longer refreshed
+    if (!field || !field->valid()) {
+        for (FGAIBase* base : models) {
+            base->clearAtmosphere();
+        }
+        return;
+    }
+
+    // one query for all models, instead of each reading the user's values
+    _atmospherePoints.resize(models.size());
+    size_t i = 0;
+    for (FGAIBase* base : models) {
+        const double altitudeFt = base->getGeodPos().getElevationFt();
+        double clearanceFt;
+        if (!base->getGroundClearanceFt(clearanceFt)) {
+            clearanceFt = altitudeFt - userGroundFt;
+        }
+        _atmospherePoints[i].altitudeFt = altitudeFt;
+        _atmospherePoints[i].altitudeAglFt = std::max(clearanceFt, 0.0);
+        ++i;
+    }
+
+    field->sample(_atmospherePoints, _atmosphereSamples);
+
+    i = 0;
+    for (FGAIBase* base : models) {
+        base->setAtmosphere(_atmosphereSamples[i++]);
+    }
+}
+
+void
+FGAIManager::updateTrafficSnapshot()
+{
+    _trafficSnapshot.clear();
+    for (FGAIBase* base : ai_list) {
+        if (base->getDie()) {
+            continue;
+        }
+
+        const char* typeName = base->getTypeString();
+        unsigned flags = 0;
+        if (!strcmp(typeName, "aircraft")) {
+            flags |= FGAITrafficSnapshot::FlagAircraft;
+        } else if (base->isa(FGAIBase::otMultiplayer)) {
+            flags |= FGAITrafficSnapshot::FlagMultiplayer;
+        }
+
+        if (base->isInvisible()) {
+            flags |= FGAITrafficSnapshot::FlagInvisible;
+        }
+
+        _trafficSnapshot.add(base->getID(), base->getCallSign(), typeName, flags,
+                             base->getGeodPos(), base->_getHeading(),
+                             base->_getSpeed(), base->_getVS_fps(),
+                             base->_getProps());
+    }
+
+    _trafficSnapshot.finish();
 }
 
 /** update LOD settings of all AI/MP models */
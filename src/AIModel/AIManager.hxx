@@ -25,10 +25,15 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/structure/SGSharedPtr.hxx>
 
+#include <Environment/atmospherefield.hxx>
+
+#include "AITrafficSnapshot.hxx"
+
 class FGAIBase;
 class FGAIThermal;
 class FGAIAircraft;
@@ -93,6 +98,21 @@ public:
 
     double calcRangeFt(const SGVec3d& aCartPos, const FGAIBase* aObject) const;
 
+    /**
+     * @brief State of all live AI/MP objects as of the last update, for
+     * instruments looking for nearby traffic.
+     */
+    const FGAITrafficSnapshot& trafficSnapshot() const
+    { return _trafficSnapshot; }
+
+    /**
+     * @brief Give each of the models its sample of the field, or clear
+     * their atmosphere while there is no valid field.  Models which do not
+     * track the ground are taken to be over the terrain at userGroundFt.
+     */
+    void updateAtmosphere(const Environment::AtmosphereField* field,
+                          const ai_list_type& models, double userGroundFt);
+
     /**
      * @brief Retrieve the representation of the user's aircraft in the AI manager
      * the position and velocity of this object are slaved to the user's aircraft,
@@ -135,6 +155,7 @@ private:
     SGPropertyNode_ptr enabled;
     SGPropertyNode_ptr thermal_lift_node;
     SGPropertyNode_ptr user_altitude_agl_node;
+    SGPropertyNode_ptr user_ground_elev_node;
     SGPropertyNode_ptr user_speed_node;
     SGPropertyNode_ptr wind_from_east_node;
     SGPropertyNode_ptr wind_from_north_node;
@@ -152,6 +173,8 @@ private:
     double wind_from_north;
 
     void fetchUserState( double dt );
+    void updateTrafficSnapshot();
+    void updateAtmosphere();
 
     // used by thermals
     double range_nearest;
@@ -173,6 +196,12 @@ private:
     bool _radarEnabled = true,
         _radarDebugMode = false;
     double _radarRangeM = 0.0;
+
+    FGAITrafficSnapshot _trafficSnapshot;
+
+    // scratch space for the atmosphere batch query
+    std::vector<Environment::AtmosphereField::Point> _atmospherePoints;
+    std::vector<Environment::AtmosphereField::Sample> _atmosphereSamples;
 };
 
 #endif  // _FG_AIMANAGER_HXX
@@ -55,7 +55,6 @@ _initial_tunnel(false),
 _restart(false),
 _hdg_constant(0.01),
 _limit(100),
-_elevation_m(0),
 _elevation_ft(0),
 _tow_angle(0),
 _missed_count(0),
@@ -299,7 +298,6 @@ void FGAIShip::Run(double dt) {
         * speed * 1.686 / ft_per_deg_lon;
 
     // set new position
-    //cout << _name << " " << type << " run: " << _elevation_m << " " <<_elevation_ft << endl;
     pos.setLatitudeDeg(pos.getLatitudeDeg() + speed_north_deg_sec * dt);
     pos.setLongitudeDeg(pos.getLongitudeDeg() + speed_east_deg_sec * dt);
     pos.setElevationFt(tgt_altitude_ft);
@@ -43,6 +43,13 @@ public:
     virtual void reinit();
     virtual double getDefaultModelRadius() { return 200.0; }
 
+    // ships and ground vehicles move on the surface
+    bool getGroundClearanceFt(double& clearanceFt) const override
+    {
+        clearanceFt = 0.0;
+        return true;
+    }
+
     void setRudder(float r);
     void setRoll(double rl);
     void ProcessFlightPlan( double dt);
@@ -80,7 +87,7 @@ public:
 
     virtual const char* getTypeString(void) const { return "ship"; }
     double _rudder_constant, _speed_constant, _hdg_constant, _limit ;
-    double _elevation_m, _elevation_ft;
+    double _elevation_ft;
     double _missed_range, _tow_angle, _wait_count, _missed_count,_wp_range;
     double _dt_count, _next_run;
 
@@ -0,0 +1,182 @@
+// AITrafficSnapshot.cxx - per-frame, read-only view of all AI/MP traffic
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include "AITrafficSnapshot.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+// grid coordinates are packed into 21 bits each
+static const int CELL_COORD_BIAS = 1 << 20;
+
+FGAITrafficSnapshot::FGAITrafficSnapshot(double cellSizeM) :
+    _cellSizeM(cellSizeM)
+{
+}
+
+void FGAITrafficSnapshot::clear()
+{
+    ++_serial;
+    _id.clear();
+    _callsignHash.clear();
+    _typeName.clear();
+    _flags.clear();
+    _cart.clear();
+    _velocity.clear();
+    _groundCart.clear();
+    _latitudeDeg.clear();
+    _longitudeDeg.clear();
+    _altitudeFt.clear();
+    _headingDeg.clear();
+    _speedKt.clear();
+    _verticalFps.clear();
+    _props.clear();
+    _cellEntries.clear();
+    _cells.clear();
+}
+
+void FGAITrafficSnapshot::add(int id, const std::string& callsign,
+                              const char* typeName, unsigned flags,
+                              const SGGeod& pos, double headingDeg,
+                              double speedKt, double verticalFps,
+                              SGPropertyNode* props)
+{
+    _id.push_back(id);
+    _callsignHash.push_back(hashCallsign(callsign));
+    _typeName.push_back(typeName);
+    _flags.push_back(flags);
+    _cart.push_back(SGVec3d::fromGeod(pos));
+    _groundCart.push_back(SGVec3d::fromGeod(SGGeod::fromGeodM(pos, 0.0)));
+    _latitudeDeg.push_back(pos.getLatitudeDeg());
+    _longitudeDeg.push_back(pos.getLongitudeDeg());
+    _altitudeFt.push_back(pos.getElevationFt());
+    _headingDeg.push_back(headingDeg);
+    _speedKt.push_back(speedKt);
+    _verticalFps.push_back(verticalFps);
+    _props.push_back(props);
+
+    // local north/east/down velocity, rotated into the cartesian frame
+    const double hdg = headingDeg * SG_DEGREES_TO_RADIANS;
+    const double speedMps = speedKt * SG_KT_TO_MPS;
+    const SGVec3d ned(cos(hdg) * speedMps, sin(hdg) * speedMps,
+                      -verticalFps * SG_FEET_TO_METER);
+    _velocity.push_back(SGQuatd::fromLonLat(pos).backTransform(ned));
+}
+
+void FGAITrafficSnapshot::finish()
+{
+    const size_t count = _id.size();
+    std::vector<CellKey> keys(count);
+    _cellEntries.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const SGVec3d& p = _groundCart[i];
+        keys[i] = cellKey(cellCoord(p.x()), cellCoord(p.y()), cellCoord(p.z()));
+        _cellEntries[i] = i;
+    }
+
+    std::sort(_cellEntries.begin(), _cellEntries.end(),
+              [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+    _cells.clear();
+    for (size_t first = 0; first < count; ) {
+        const CellKey key = keys[_cellEntries[first]];
+        size_t last = first + 1;
+        while ((last < count) && (keys[_cellEntries[last]] == key)) {
+            ++last;
+        }
+
+        _cells[key] = std::make_pair(first, last);
+        first = last;
+    }
+}
+
+size_t FGAITrafficSnapshot::findInRange(const SGGeod& center, double rangeM,
+                                        std::vector<size_t>& result) const
+{
+    const size_t before = result.size();
+    if (_id.empty() || (rangeM < 0.0)) {
+        return 0;
+    }
+
+    const SGVec3d c = SGVec3d::fromGeod(SGGeod::fromGeodM(center, 0.0));
+    const double range2 = rangeM * rangeM;
+
+    const int reach = static_cast<int>(ceil(rangeM / _cellSizeM));
+    const double cellsToVisit = pow(2.0 * reach + 1.0, 3);
+    if (cellsToVisit >= static_cast<double>(_id.size())) {
+        // more cells than entries: a plain scan is cheaper
+        for (size_t i = 0; i < _groundCart.size(); ++i) {
+            if (distSqr(_groundCart[i], c) <= range2) {
+                result.push_back(i);
+            }
+        }
+
+        return result.size() - before;
+    }
+
+    const int cx = cellCoord(c.x());
+    const int cy = cellCoord(c.y());
+    const int cz = cellCoord(c.z());
+    for (int x = cx - reach; x <= cx + reach; ++x) {
+        for (int y = cy - reach; y <= cy + reach; ++y) {
+            for (int z = cz - reach; z <= cz + reach; ++z) {
+                auto it = _cells.find(cellKey(x, y, z));
+                if (it == _cells.end()) {
+                    continue;
+                }
+
+                for (size_t k = it->second.first; k < it->second.second; ++k) {
+                    const size_t i = _cellEntries[k];
+                    if (distSqr(_groundCart[i], c) <= range2) {
+                        result.push_back(i);
+                    }
+                }
+            }
+        }
+    }
+
+    return result.size() - before;
+}
+
+uint32_t FGAITrafficSnapshot::hashCallsign(const std::string& callsign)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : callsign) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+int FGAITrafficSnapshot::cellCoord(double v) const
+{
+    return static_cast<int>(floor(v / _cellSizeM));
+}
+
+FGAITrafficSnapshot::CellKey
+FGAITrafficSnapshot::cellKey(int x, int y, int z) const
+{
+    const CellKey mask = (1 << 21) - 1;
+    return ((CellKey(x + CELL_COORD_BIAS) & mask) << 42) |
+           ((CellKey(y + CELL_COORD_BIAS) & mask) << 21) |
+           (CellKey(z + CELL_COORD_BIAS) & mask);
+}
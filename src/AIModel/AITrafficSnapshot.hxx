@@ -0,0 +1,149 @@
+// AITrafficSnapshot.hxx - per-frame, read-only view of all AI/MP traffic
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef _FG_AITRAFFICSNAPSHOT_HXX
+#define _FG_AITRAFFICSNAPSHOT_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+#include <simgear/props/props.hxx>
+
+/**
+ * State of all AI and multiplayer objects, rebuilt once per frame by
+ * FGAIManager.
+ *
+ * Instruments such as TCAS and the weather radar used to walk the
+ * /ai/models children and read a dozen properties per model on every
+ * update, whether the model was near or not.  The snapshot keeps the
+ * same values in flat arrays (one per field, indexed by entry), together
+ * with a grid over the ground positions, so a consumer can ask for the
+ * entries within a given range and only touch those.
+ *
+ * Entries are only valid until the next rebuild; use id() to recognise an
+ * object across frames.
+ */
+class FGAITrafficSnapshot
+{
+public:
+    enum Flags {
+        FlagAircraft    = 1 << 0, ///< /ai/models/aircraft
+        FlagMultiplayer = 1 << 1, ///< /ai/models/multiplayer
+        FlagInvisible   = 1 << 2  ///< controls/invisible set
+    };
+
+    explicit FGAITrafficSnapshot(double cellSizeM = 10 * SG_NM_TO_METER);
+
+    /**
+     * Start a new snapshot, dropping all entries.
+     */
+    void clear();
+
+    /**
+     * Add an object.  typeName is the name of its /ai/models child and
+     * must stay valid for the lifetime of the snapshot (the values
+     * returned by FGAIBase::getTypeString() do).
+     */
+    void add(int id, const std::string& callsign, const char* typeName,
+             unsigned flags, const SGGeod& pos, double headingDeg,
+             double speedKt, double verticalFps, SGPropertyNode* props);
+
+    /**
+     * Build the spatial index once all entries are added.
+     */
+    void finish();
+
+    size_t size() const
+    { return _id.size(); }
+
+    bool empty() const
+    { return _id.empty(); }
+
+    /**
+     * Incremented on every rebuild.
+     */
+    unsigned int serial() const
+    { return _serial; }
+
+    int id(size_t i) const                   { return _id[i]; }
+    uint32_t callsignHash(size_t i) const    { return _callsignHash[i]; }
+    const char* typeName(size_t i) const     { return _typeName[i]; }
+    unsigned flags(size_t i) const           { return _flags[i]; }
+    const SGVec3d& cartPos(size_t i) const   { return _cart[i]; }
+    /// velocity in earth centered cartesian coordinates, m/s
+    const SGVec3d& cartVelocity(size_t i) const { return _velocity[i]; }
+    double latitudeDeg(size_t i) const       { return _latitudeDeg[i]; }
+    double longitudeDeg(size_t i) const      { return _longitudeDeg[i]; }
+    double altitudeFt(size_t i) const        { return _altitudeFt[i]; }
+    double headingDeg(size_t i) const        { return _headingDeg[i]; }
+    double speedKt(size_t i) const           { return _speedKt[i]; }
+    double verticalFps(size_t i) const       { return _verticalFps[i]; }
+
+    /**
+     * The model's /ai/models node, for consumers which need a value not in
+     * the snapshot or which publish results on it.
+     */
+    SGPropertyNode* props(size_t i) const    { return _props[i]; }
+
+    /**
+     * Collect the entries whose ground position is within rangeM of the
+     * ground position of center.  The distance is measured as a straight
+     * line between the points at sea level, which is never more than the
+     * distance along the surface, so no entry within rangeM over the
+     * surface is missed; callers do their own exact test.
+     *
+     * @return number of entries added to result
+     */
+    size_t findInRange(const SGGeod& center, double rangeM,
+                       std::vector<size_t>& result) const;
+
+    static uint32_t hashCallsign(const std::string& callsign);
+
+private:
+    typedef std::int64_t CellKey;
+
+    CellKey cellKey(int x, int y, int z) const;
+    int cellCoord(double v) const;
+
+    double _cellSizeM;
+    unsigned int _serial = 0;
+
+    std::vector<int> _id;
+    std::vector<uint32_t> _callsignHash;
+    std::vector<const char*> _typeName;
+    std::vector<unsigned> _flags;
+    std::vector<SGVec3d> _cart;
+    std::vector<SGVec3d> _velocity;
+    std::vector<SGVec3d> _groundCart; ///< position projected to sea level
+    std::vector<double> _latitudeDeg;
+    std::vector<double> _longitudeDeg;
+    std::vector<double> _altitudeFt;
+    std::vector<double> _headingDeg;
+    std::vector<double> _speedKt;
+    std::vector<double> _verticalFps;
+    std::vector<SGPropertyNode_ptr> _props;
+
+    /// entry indices, sorted by grid cell
+    std::vector<size_t> _cellEntries;
+    /// cell -> [first, last) range in _cellEntries
+    std::unordered_map<CellKey, std::pair<size_t, size_t> > _cells;
+};
+
+#endif // _FG_AITRAFFICSNAPSHOT_HXX
@@ -492,8 +492,13 @@ void FGAIWingman::Run(double dt) {
     double speed_east_deg_sec  = speed_east_fps / ft_per_deg_lon;
 
     //get wind components
-    _wind_from_north = manager->get_wind_from_north();
-    _wind_from_east = manager->get_wind_from_east();
+    if (const auto* atmosphere = getAtmosphere()) {
+        _wind_from_north = atmosphere->windFromNorthFps;
+        _wind_from_east = atmosphere->windFromEastFps;
+    } else {
+        _wind_from_north = manager->get_wind_from_north();
+        _wind_from_east = manager->get_wind_from_east();
+    }
 
     // convert wind speed (fps) to degrees lat/lon per second
     double wind_speed_from_north_deg_sec = _wind_from_north / ft_per_deg_lat;
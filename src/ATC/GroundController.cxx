@@ -139,10 +139,11 @@ void FGGroundController::announcePosition(int id,
         } else {
             activeTraffic.push_back(rec);   
         }
-        
+        segmentUsage.update(id, currentPosition, rec.getIntentions());
     } else {
         i->setPositionAndIntentions(currentPosition, intendedRoute);
         i->setPositionAndHeading(lat, lon, heading, speed, alt);
+        segmentUsage.update(id, currentPosition, i->getIntentions());
     }
 }
 
@@ -166,6 +167,7 @@ void FGGroundController::signOff(int id)
                "AI error: Aircraft without traffic record is signing off at " << SG_ORIGIN);
     } else {
         i = activeTraffic.erase(i);
+        segmentUsage.remove(id);
     }
 }
 /**
@@ -403,7 +405,7 @@ void FGGroundController::checkSpeedAdjustment(int id, double lat,
         */
         current->clearSpeedAdjustment();
         bool needBraking = false;
-        if (current->checkPositionAndIntentions(*closest)
+        if (segmentUsage.isOnOrIntends(current->getId(), closest->getCurrentPosition())
                 || otherReasonToSlowDown) {
             double maxAllowableDistance =
                 (1.1 * current->getRadius()) +
@@ -974,6 +976,12 @@ void FGGroundController::update(double dt)
         updateActiveTraffic(i, priority, now);
     }
 
+    for (i = activeTraffic.begin(); i != activeTraffic.end(); i++) {
+        if (!i->getAircraft() || i->getAircraft()->getDie()) {
+            segmentUsage.remove(i->getId()); // about to be erased below
+        }
+    }
+
     eraseDeadTraffic(startupTraffic);
     eraseDeadTraffic(activeTraffic);
 }
@@ -1008,20 +1016,15 @@ void FGGroundController::updateStartupTraffic(TrafficVectorIterator i,
     }
 
     // Check for all active aircraft whether it's current pos segment is
-    // an opposite of one of the departing aircraft's intentions
-    for (TrafficVectorIterator j = activeTraffic.begin(); j != activeTraffic.end(); j++) {
-        int pos = j->getCurrentPosition();
-        if (pos > 0) {
-            FGTaxiSegment *seg = network->findOppositeSegment(pos-1);
-            if (seg) {
-                int posReverse = seg->getIndex();
-                for (intVecIterator k = i->getIntentions().begin(); k != i->getIntentions().end(); k++) {
-                    if ((*k) == posReverse) {
-                        i->denyPushBack();
-                        network->findSegment(posReverse)->block(i->getId(), now, now);
-                    }
-                }
-            }
+    // an opposite of one of the departing aircraft's intentions.  An active
+    // aircraft at position pos is matched against the opposite of segment
+    // pos-1, so look up who is at (index of the opposite) + 1.
+    for (intVecIterator k = i->getIntentions().begin(); k != i->getIntentions().end(); k++) {
+        FGTaxiSegment* seg = network->findSegment(*k);
+        FGTaxiSegment* opp = seg ? seg->opposite() : nullptr;
+        if (opp && !segmentUsage.aircraftOn(opp->getIndex() + 1).empty()) {
+            i->denyPushBack();
+            seg->block(i->getId(), now, now);
         }
     }
     // if the current aircraft is still allowed to pushback, we can start reserving a route for if by blocking all the entry taxiways.
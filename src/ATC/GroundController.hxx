@@ -28,6 +28,7 @@
 #include <string>
 
 #include <ATC/trafficcontrol.hxx>
+#include <ATC/SegmentUsageIndex.hxx>
 
 class FGAirportDynamics;
 
@@ -47,6 +48,9 @@ private:
     TrafficVector activeTraffic;
     TrafficVectorIterator currTraffic;
 
+    // segments used by activeTraffic, for conflict checks
+    SegmentUsageIndex segmentUsage;
+
     FGTowerController *towerController;
     FGAirport *parent;
     FGAirportDynamics* dynamics;
@@ -0,0 +1,147 @@
+// SegmentUsageIndex.cxx - which AI aircraft are on or will use a taxi segment
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include "SegmentUsageIndex.hxx"
+
+#include <algorithm>
+
+static const SegmentUsageIndex::AircraftList noAircraft;
+
+void SegmentUsageIndex::update(int aircraftId, int position, const std::vector<int>& intentions)
+{
+    auto it = _aircraft.find(aircraftId);
+    if (it == _aircraft.end()) {
+        Usage& usage = _aircraft[aircraftId];
+        usage.position = position;
+        usage.intentions = intentions;
+        add(_on, position, aircraftId);
+        for (int seg : intentions) {
+            add(_intending, seg, aircraftId);
+        }
+        return;
+    }
+
+    Usage& usage = it->second;
+    if (usage.position != position) {
+        drop(_on, usage.position, aircraftId);
+        add(_on, position, aircraftId);
+        usage.position = position;
+    }
+
+    // The usual case: the aircraft moved on, and its intentions are what
+    // was left of the previous ones.
+    const size_t oldCount = usage.intentions.size();
+    if ((intentions.size() <= oldCount) &&
+        std::equal(intentions.begin(), intentions.end(),
+                   usage.intentions.begin() + (oldCount - intentions.size())))
+    {
+        const size_t dropped = oldCount - intentions.size();
+        for (size_t i = 0; i < dropped; ++i) {
+            drop(_intending, usage.intentions[i], aircraftId);
+        }
+
+        usage.intentions.erase(usage.intentions.begin(),
+                               usage.intentions.begin() + dropped);
+        return;
+    }
+
+    for (int seg : usage.intentions) {
+        drop(_intending, seg, aircraftId);
+    }
+
+    usage.intentions = intentions;
+    for (int seg : intentions) {
+        add(_intending, seg, aircraftId);
+    }
+}
+
+void SegmentUsageIndex::remove(int aircraftId)
+{
+    auto it = _aircraft.find(aircraftId);
+    if (it == _aircraft.end()) {
+        return;
+    }
+
+    drop(_on, it->second.position, aircraftId);
+    for (int seg : it->second.intentions) {
+        drop(_intending, seg, aircraftId);
+    }
+
+    _aircraft.erase(it);
+}
+
+void SegmentUsageIndex::clear()
+{
+    _aircraft.clear();
+    _on.clear();
+    _intending.clear();
+}
+
+const SegmentUsageIndex::AircraftList& SegmentUsageIndex::aircraftOn(int segment) const
+{
+    auto it = _on.find(segment);
+    return (it == _on.end()) ? noAircraft : it->second;
+}
+
+const SegmentUsageIndex::AircraftList& SegmentUsageIndex::aircraftIntending(int segment) const
+{
+    auto it = _intending.find(segment);
+    return (it == _intending.end()) ? noAircraft : it->second;
+}
+
+bool SegmentUsageIndex::isOnOrIntends(int aircraftId, int segment) const
+{
+    auto it = _aircraft.find(aircraftId);
+    if (it == _aircraft.end()) {
+        return false;
+    }
+
+    if (it->second.position == segment) {
+        return true;
+    }
+
+    const AircraftList& intending(aircraftIntending(segment));
+    return std::find(intending.begin(), intending.end(), aircraftId) != intending.end();
+}
+
+void SegmentUsageIndex::add(SegmentMap& map, int segment, int aircraftId)
+{
+    map[segment].push_back(aircraftId);
+}
+
+void SegmentUsageIndex::drop(SegmentMap& map, int segment, int aircraftId)
+{
+    auto it = map.find(segment);
+    if (it == map.end()) {
+        return;
+    }
+
+    AircraftList& list(it->second);
+    auto a = std::find(list.begin(), list.end(), aircraftId);
+    if (a != list.end()) {
+        // order does not matter, so avoid shifting the tail
+        *a = list.back();
+        list.pop_back();
+    }
+
+    if (list.empty()) {
+        map.erase(it);
+    }
+}
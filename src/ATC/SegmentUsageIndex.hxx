@@ -0,0 +1,88 @@
+// SegmentUsageIndex.hxx - which AI aircraft are on or will use a taxi segment
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef ATC_SEGMENT_USAGE_INDEX_HXX
+#define ATC_SEGMENT_USAGE_INDEX_HXX
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Index from taxi segment index to the aircraft currently on that segment,
+ * and to the aircraft intending to use it later on their route.
+ *
+ * The ground controller used to answer "who is on / going to use segment
+ * x" by comparing the position and intentions of every traffic record
+ * against every other one.  This index is kept up to date as aircraft
+ * announce their positions, so such questions become lookups.
+ *
+ * Aircraft are identified by their traffic record id.
+ */
+class SegmentUsageIndex
+{
+public:
+    typedef std::vector<int> AircraftList;
+
+    /**
+     * Record the current position and remaining intentions of an aircraft.
+     * Moving along the route (dropping leading intentions) is cheap; any
+     * other change re-indexes the aircraft.
+     */
+    void update(int aircraftId, int position, const std::vector<int>& intentions);
+
+    void remove(int aircraftId);
+
+    void clear();
+
+    /**
+     * Aircraft whose current position is segment.
+     */
+    const AircraftList& aircraftOn(int segment) const;
+
+    /**
+     * Aircraft with segment in their remaining intentions (once per
+     * occurrence).
+     */
+    const AircraftList& aircraftIntending(int segment) const;
+
+    /**
+     * Whether aircraft is on segment or intends to use it; the indexed
+     * equivalent of FGTrafficRecord::checkPositionAndIntentions().
+     */
+    bool isOnOrIntends(int aircraftId, int segment) const;
+
+    size_t size() const
+    { return _aircraft.size(); }
+
+private:
+    struct Usage
+    {
+        int position;
+        std::vector<int> intentions;
+    };
+
+    typedef std::unordered_map<int, AircraftList> SegmentMap;
+
+    static void add(SegmentMap& map, int segment, int aircraftId);
+    static void drop(SegmentMap& map, int segment, int aircraftId);
+
+    std::unordered_map<int, Usage> _aircraft;
+    SegmentMap _on;
+    SegmentMap _intending;
+};
+
+#endif // of ATC_SEGMENT_USAGE_INDEX_HXX
@@ -748,6 +748,7 @@ bool FGAirportDynamics::innerGetActiveRunway(const string & trafficType,
         // Note that I SHOULD keep multiple lists in memory, one for 
         // general aviation, one for commercial and one for military
         // traffic.
+        const stringVec previouslyActive(*currentlyActive);
         currentlyActive->clear();
         nrActiveRunways = currRunwayGroup->getNrActiveRunways();
         //cerr << "Choosing runway for " << trafficType << endl;
@@ -766,6 +767,11 @@ bool FGAirportDynamics::innerGetActiveRunway(const string & trafficType,
             }
         }
         //cerr << endl;
+
+        if (*currentlyActive != previouslyActive) {
+            // cached taxi routes were chosen for the old runways
+            _ap->groundNetwork()->invalidateRouteCache();
+        }
     }
 
     if (action == 1)            // takeoff 
@@ -29,6 +29,7 @@
 #include <cmath>
 #include <algorithm>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <boost/foreach.hpp>
 
@@ -44,6 +45,7 @@
 #include <Airports/runways.hxx>
 
 #include <Scenery/scenery.hxx>
+#include <Main/fg_props.hxx>
 
 using std::string;
 
@@ -157,7 +159,9 @@ bool FGTaxiRoute::next(FGTaxiNodeRef& node, int *rte)
  **************************************************************************/
 
 FGGroundNetwork::FGGroundNetwork(FGAirport* airport) :
-    parent(airport)
+    parent(airport),
+    m_routeEpoch(0),
+    m_routeCacheEpoch(0)
 {
     hasNetwork = false;
     version = 0;
@@ -201,7 +205,21 @@ void FGGroundNetwork::init()
         opp->oppositeDirection = segment;
       }
     }
-  
+
+    buildRoutingGraph();
+
+    SGPropertyNode_ptr cacheNode = fgGetNode("/sim/ai/groundnet/route-cache", true);
+    m_routeCacheMaxEntries = cacheNode->getNode("max-entries", true);
+    if (m_routeCacheMaxEntries->getType() == simgear::props::NONE) {
+        m_routeCacheMaxEntries->setIntValue(256);
+    }
+
+    m_routeCacheLookups = cacheNode->getNode("lookups", true);
+    m_routeCacheHits = cacheNode->getNode("hits", true);
+    m_routeCacheHitRate = cacheNode->getNode("hit-rate", true);
+    m_routeSearches = cacheNode->getNode("searches", true);
+    m_routeSearchTimeMs = cacheNode->getNode("search-time-ms", true);
+
     networkInitialized = true;
 }
 
@@ -323,58 +341,199 @@ static int edgePenalty(FGTaxiNode* tn)
     (tn->getIsOnRunway() ? 1000 : 0);
 }
 
-class ShortestPathData
+void FGGroundNetwork::buildRoutingGraph()
 {
-public:
-  ShortestPathData() :
-    score(HUGE_VAL)
-  {}
-  
-  double score;
-  FGTaxiNodeRef previousNode;
-};
+    const int nodeCount = static_cast<int>(m_nodes.size());
+
+    m_routingSlots.clear();
+    m_routingSlots.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        m_routingSlots[m_nodes[i].ptr()] = i;
+    }
+
+    // counting sort of the segments by start node
+    m_routingOffsets.assign(nodeCount + 1, 0);
+    BOOST_FOREACH(FGTaxiSegment* seg, segments) {
+        m_routingOffsets[m_routingSlots[seg->startNode] + 1]++;
+    }
+
+    for (int i = 0; i < nodeCount; ++i) {
+        m_routingOffsets[i + 1] += m_routingOffsets[i];
+    }
+
+    std::vector<int> cursor(m_routingOffsets.begin(), m_routingOffsets.end() - 1);
+    m_routingEdges.resize(segments.size());
+    BOOST_FOREACH(FGTaxiSegment* seg, segments) {
+        FGTaxiNode* target = const_cast<FGTaxiNode*>(seg->endNode);
+        const int source = m_routingSlots[seg->startNode];
+        RoutingEdge& edge = m_routingEdges[cursor[source]++];
+        edge.source = source;
+        edge.target = m_routingSlots[target];
+        edge.cost = seg->getLength() + edgePenalty(target);
+        edge.segment = seg;
+    }
+
+    m_routingScratch.score.assign(nodeCount, HUGE_VAL);
+    m_routingScratch.previousEdge.assign(nodeCount, -1);
+    m_routingScratch.epoch.assign(nodeCount, 0);
+    m_routingScratch.closed.assign(nodeCount, false);
+    m_routingScratch.open.clear();
+    m_routingScratch.open.reserve(nodeCount);
+    m_routingScratch.currentEpoch = 0;
+
+    // cached routes are keyed on the node slots assigned above
+    ++m_routeEpoch;
+}
 
 FGTaxiRoute FGGroundNetwork::findShortestRoute(FGTaxiNode* start, FGTaxiNode* end, bool fullSearch)
 {
     if (!start || !end) {
         throw sg_exception("Bad arguments to findShortestRoute");
     }
-//implements Dijkstra's algorithm to find shortest distance route from start to end
-//taken from http://en.wikipedia.org/wiki/Dijkstra's_algorithm
-    FGTaxiNodeVector unvisited(m_nodes);
-    std::map<FGTaxiNode*, ShortestPathData> searchData;
 
-    searchData[start].score = 0.0;
+    if (m_routingOffsets.size() != m_nodes.size() + 1) {
+        buildRoutingGraph();
+    }
+
+    auto startSlot = m_routingSlots.find(start),
+        endSlot = m_routingSlots.find(end);
+    if ((startSlot == m_routingSlots.end()) || (endSlot == m_routingSlots.end())) {
+        throw sg_exception("findShortestRoute: node is not part of the ground network");
+    }
+
+    const int startIndex = startSlot->second;
+    const int endIndex = endSlot->second;
 
-    while (!unvisited.empty()) {
-        // find lowest scored unvisited
-        FGTaxiNodeRef best = unvisited.front();
-        BOOST_FOREACH(FGTaxiNodeRef i, unvisited) {
-            if (searchData[i].score < searchData[best].score) {
-                best = i;
-            }
+    if (m_routeCacheEpoch != m_routeEpoch) {
+        m_routeCache.clear();
+        m_routeCacheIndex.clear();
+        m_routeCacheEpoch = m_routeEpoch;
+    }
+
+    const unsigned long long key =
+        (static_cast<unsigned long long>(startIndex) << 33)
+        | (static_cast<unsigned long long>(endIndex) << 1)
+        | (fullSearch ? 1 : 0);
+    const int maxEntries = m_routeCacheMaxEntries ? m_routeCacheMaxEntries->getIntValue() : 0;
+
+    auto cached = m_routeCacheIndex.find(key);
+    if (cached != m_routeCacheIndex.end()) {
+        // move to the front of the LRU list
+        m_routeCache.splice(m_routeCache.begin(), m_routeCache, cached->second);
+        updateRouteCacheStats(true, 0.0);
+        return cached->second->route;
+    }
+
+    SGTimeStamp st;
+    st.stamp();
+    FGTaxiRoute route = searchShortestRoute(startIndex, endIndex, fullSearch);
+    updateRouteCacheStats(false, st.elapsedMSec());
+
+    if (maxEntries > 0) {
+        CachedRoute entry;
+        entry.key = key;
+        entry.route = route;
+        m_routeCache.push_front(entry);
+        m_routeCacheIndex[key] = m_routeCache.begin();
+
+        while (m_routeCache.size() > static_cast<size_t>(maxEntries)) {
+            m_routeCacheIndex.erase(m_routeCache.back().key);
+            m_routeCache.pop_back();
         }
-      
-      // remove 'best' from the unvisited set
-        FGTaxiNodeVectorIterator newend =
-            remove(unvisited.begin(), unvisited.end(), best);
-        unvisited.erase(newend, unvisited.end());
+    }
+
+    return route;
+}
+
+void FGGroundNetwork::updateRouteCacheStats(bool hit, double searchMs)
+{
+    if (!m_routeCacheLookups) {
+        return; // init() not run
+    }
+
+    const long lookups = m_routeCacheLookups->getLongValue() + 1;
+    const long hits = m_routeCacheHits->getLongValue() + (hit ? 1 : 0);
+    m_routeCacheLookups->setLongValue(lookups);
+    m_routeCacheHits->setLongValue(hits);
+    m_routeCacheHitRate->setDoubleValue(static_cast<double>(hits) / lookups);
+
+    if (!hit) {
+        m_routeSearches->setLongValue(m_routeSearches->getLongValue() + 1);
+        m_routeSearchTimeMs->setDoubleValue(m_routeSearchTimeMs->getDoubleValue() + searchMs);
+    }
+}
+
+FGTaxiRoute FGGroundNetwork::searchShortestRoute(int startIndex, int endIndex, bool fullSearch)
+{
+    FGTaxiNode* start = m_nodes[startIndex];
+    FGTaxiNode* end = m_nodes[endIndex];
+    const SGVec3d endCart = end->cart();
 
-        if (best == end) { // found route or best not connected
+    // A* over the dense node indices.  The heuristic is the straight-line
+    // distance to the end node: edge costs are the straight-line segment
+    // lengths plus non-negative penalties, so it never over-estimates and
+    // nodes never need to be re-opened once closed.
+    RoutingScratch& scratch(m_routingScratch);
+    if (++scratch.currentEpoch == 0) {
+        std::fill(scratch.epoch.begin(), scratch.epoch.end(), 0);
+        scratch.currentEpoch = 1;
+    }
+
+    const unsigned int epoch = scratch.currentEpoch;
+    auto touch = [&scratch, epoch](int n) {
+        if (scratch.epoch[n] != epoch) {
+            scratch.epoch[n] = epoch;
+            scratch.score[n] = HUGE_VAL;
+            scratch.previousEdge[n] = -1;
+            scratch.closed[n] = false;
+        }
+    };
+
+    // std::*_heap build a max-heap, so order by greater f-score
+    typedef std::pair<double, int> OpenEntry;
+    std::greater<OpenEntry> heapOrder;
+    std::vector<OpenEntry>& open(scratch.open);
+    open.clear();
+
+    touch(startIndex);
+    scratch.score[startIndex] = 0.0;
+    open.push_back(OpenEntry(dist(start->cart(), endCart), startIndex));
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), heapOrder);
+        const int best = open.back().second;
+        open.pop_back();
+
+        if (scratch.closed[best]) {
+            continue; // stale entry, node was reached more cheaply since
+        }
+
+        scratch.closed[best] = true;
+        if (best == endIndex) {
             break;
         }
-      
-        BOOST_FOREACH(FGTaxiNodeRef target, segmentsFrom(best)) {
-            double edgeLength = dist(best->cart(), target->cart());
-            double alt = searchData[best].score + edgeLength + edgePenalty(target);
-            if (alt < searchData[target].score) {    // Relax (u,v)
-                searchData[target].score = alt;
-                searchData[target].previousNode = best;
+
+        const double bestScore = scratch.score[best];
+        for (int e = m_routingOffsets[best]; e < m_routingOffsets[best + 1]; ++e) {
+            const RoutingEdge& edge(m_routingEdges[e]);
+            const int target = edge.target;
+            touch(target);
+            if (scratch.closed[target]) {
+                continue;
+            }
+
+            const double alt = bestScore + edge.cost;
+            if (alt < scratch.score[target]) {    // Relax (u,v)
+                scratch.score[target] = alt;
+                scratch.previousEdge[target] = e;
+                const double h = dist(m_nodes[target]->cart(), endCart);
+                open.push_back(OpenEntry(alt + h, target));
+                std::push_heap(open.begin(), open.end(), heapOrder);
             }
         } // of outgoing arcs/segments from current best node iteration
-    } // of unvisited nodes remaining
+    } // of open nodes remaining
 
-    if (searchData[end].score == HUGE_VAL) {
+    if ((scratch.epoch[endIndex] != epoch) || (scratch.score[endIndex] == HUGE_VAL)) {
         // no valid route found
         if (fullSearch) {
             SG_LOG(SG_GENERAL, SG_ALERT,
@@ -388,20 +547,18 @@ FGTaxiRoute FGGroundNetwork::findShortestRoute(FGTaxiNode* start, FGTaxiNode* en
     // assemble route from backtrace information
     FGTaxiNodeVector nodes;
     intVec routes;
-    FGTaxiNode *bt = end;
+    int bt = endIndex;
     
-    while (searchData[bt].previousNode != 0) {
-        nodes.push_back(bt);
-        FGTaxiSegment *segment = findSegment(searchData[bt].previousNode, bt);
-        int idx = segment->getIndex();
-        routes.push_back(idx);
-        bt = searchData[bt].previousNode;
-        
+    while (scratch.previousEdge[bt] >= 0) {
+        const RoutingEdge& edge(m_routingEdges[scratch.previousEdge[bt]]);
+        nodes.push_back(m_nodes[bt]);
+        routes.push_back(edge.segment->getIndex());
+        bt = edge.source;
     }
     nodes.push_back(start);
     reverse(nodes.begin(), nodes.end());
     reverse(routes.begin(), routes.end());
-    return FGTaxiRoute(nodes, routes, searchData[end].score, 0);
+    return FGTaxiRoute(nodes, routes, scratch.score[endIndex], 0);
 }
 
 void FGGroundNetwork::unblockAllSegments(time_t now)
@@ -475,6 +632,8 @@ void FGGroundNetwork::addSegment(const FGTaxiNodeRef &from, const FGTaxiNodeRef
     if (it == m_nodes.end()) {
         m_nodes.push_back(to);
     }
+
+    m_routingOffsets.clear(); // rebuilt by the next findShortestRoute()
 }
 
 void FGGroundNetwork::addParking(const FGParkingRef &park)
@@ -485,6 +644,7 @@ void FGGroundNetwork::addParking(const FGParkingRef &park)
     FGTaxiNodeVector::iterator it = std::find(m_nodes.begin(), m_nodes.end(), park);
     if (it == m_nodes.end()) {
         m_nodes.push_back(park);
+        m_routingOffsets.clear();
     }
 }
 
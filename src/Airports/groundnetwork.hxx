@@ -25,8 +25,12 @@
 #define _GROUNDNETWORK_HXX_
 
 #include <simgear/compiler.h>
+#include <simgear/props/props.hxx>
 
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "gnnode.hxx"
 #include "parking.hxx"
@@ -157,6 +161,9 @@ public:
     bool empty () {
         return nodes.empty();
     };
+    double getDistance() const {
+        return distance;
+    };
     bool next(FGTaxiNodeRef& nde, int *rte);
   
     void first() {
@@ -191,6 +198,74 @@ private:
     FGParkingList m_parkings;
     FGTaxiNodeVector m_nodes;
 
+    /**
+     * Compact adjacency used by findShortestRoute(), built once by init().
+     * Nodes are numbered densely in m_nodes order; the outgoing edges of
+     * node n are m_routingEdges[m_routingOffsets[n] .. m_routingOffsets[n+1]).
+     */
+    struct RoutingEdge
+    {
+        int source;
+        int target;
+        double cost; ///< length plus the penalty for entering the target
+        FGTaxiSegment* segment;
+    };
+
+    std::unordered_map<const FGTaxiNode*, int> m_routingSlots;
+    std::vector<int> m_routingOffsets;
+    std::vector<RoutingEdge> m_routingEdges;
+
+    /**
+     * Search scratch space, kept between calls so routing does not
+     * allocate.  Entries are only valid when their epoch matches the
+     * current search.
+     */
+    struct RoutingScratch
+    {
+        std::vector<double> score;
+        std::vector<int> previousEdge;
+        std::vector<unsigned int> epoch;
+        std::vector<bool> closed;
+        std::vector<std::pair<double, int> > open; ///< heap of (f-score, node)
+        unsigned int currentEpoch = 0;
+    };
+
+    RoutingScratch m_routingScratch;
+
+    void buildRoutingGraph();
+    FGTaxiRoute searchShortestRoute(int startIndex, int endIndex, bool fullSearch);
+    void updateRouteCacheStats(bool hit, double searchMs);
+
+    /**
+     * Least recently used cache of search results, keyed by the dense
+     * indices of the end points and the fullSearch flag, so a failure
+     * found quietly is still reported to a caller asking for a full
+     * search.  The search only looks at the layout of the network, not at
+     * which segments are blocked, so the cache survives blocks coming and
+     * going; it is dropped whenever m_routeEpoch moves on, which happens
+     * when the routing graph is rebuilt after segments or parkings were
+     * added, or when the active runways change.
+     */
+    struct CachedRoute
+    {
+        unsigned long long key;
+        FGTaxiRoute route;
+    };
+
+    typedef std::list<CachedRoute> RouteCacheList;
+
+    RouteCacheList m_routeCache; ///< most recently used first
+    std::unordered_map<unsigned long long, RouteCacheList::iterator> m_routeCacheIndex;
+    unsigned int m_routeEpoch;
+    unsigned int m_routeCacheEpoch;
+
+    SGPropertyNode_ptr m_routeCacheMaxEntries;
+    SGPropertyNode_ptr m_routeCacheLookups;
+    SGPropertyNode_ptr m_routeCacheHits;
+    SGPropertyNode_ptr m_routeCacheHitRate;
+    SGPropertyNode_ptr m_routeSearches;
+    SGPropertyNode_ptr m_routeSearchTimeMs;
+
     FGTaxiNodeRef findNodeByIndex(int index) const;
 
     //void printRoutingError(string);
@@ -275,6 +350,14 @@ public:
     void blockSegmentsEndingAt(FGTaxiSegment* seg, int blockId,
                                time_t blockTime, time_t now);
 
+    /**
+     * Forget all cached routes, for changes findShortestRoute() cannot see
+     * by itself (such as the active runways).
+     */
+    void invalidateRouteCache() {
+        ++m_routeEpoch;
+    };
+
     void addVersion(int v) {version = v; };
     void unblockAllSegments(time_t now);
 
@@ -28,6 +28,8 @@
 #include "autopilot.hxx"
 
 #include <simgear/structure/StateMachine.hxx>
+#include <simgear/structure/exception.hxx>
+#include <simgear/timing/timestamp.hxx>
 #include <simgear/sg_inlines.h>
 
 #include "component.hxx"
@@ -154,6 +156,9 @@ Autopilot::Autopilot( SGPropertyNode_ptr rootNode, SGPropertyNode_ptr configNode
   SGPropertyNode_ptr prop_root =
     fgGetNode(prop_root_node ? prop_root_node->getStringValue() : "/", true);
 
+  _profilingNode = _rootNode->getNode("profiling/enabled", true);
+  _totalUsNode = _rootNode->getNode("profiling/total-us", true);
+
   // Just like the JSBSim interface properties for systems, create properties
   // given in the autopilot file and set to given (default) values.
   readInterfaceProperties(prop_root, configNode);
@@ -222,11 +227,120 @@ void Autopilot::add_component( Component * component, double updateInterval )
     SG_LOG( SG_AUTOPILOT, SG_WARN, "Duplicate autopilot component " << component->subsystemId() << ", renamed to " << name );
 
   set_subsystem( name.c_str(), component, updateInterval );
+
+  size_t bucket = 0;
+  while( bucket < _buckets.size() && _buckets[bucket].interval != updateInterval )
+    ++bucket;
+  if( bucket == _buckets.size() )
+  {
+    Bucket b;
+    b.interval = updateInterval;
+    b.elapsed = 0.0;
+    b.due = false;
+    _buckets.push_back(b);
+  }
+  _buckets[bucket].steps.push_back(_program.size());
+
+  Step step;
+  step.component = component;
+  step.name = name;
+  step.bucket = bucket;
+  step.meanUs = 0.0;
+  _program.push_back(step);
 }
 
 void Autopilot::update( double dt ) 
 {
   if( !_serviceable || dt <= SGLimitsd::min() )
     return;
-  SGSubsystemGroup::update( dt );
+
+  const bool profiling = _profilingNode->getBoolValue();
+  SGTimeStamp total;
+  if( profiling )
+    total.stamp();
+
+  run( dt, profiling );
+
+  if( profiling )
+    _totalUsNode->setDoubleValue( (SGTimeStamp::now() - total).toUSecs() );
+}
+
+void Autopilot::run( double dt, bool profiling )
+{
+  // A component with an update interval gets the accumulated time once the
+  // interval has passed, as with SGSubsystemGroup.
+  Bucket* dueBucket = NULL;
+  size_t dueCount = 0;
+  for( auto& bucket : _buckets )
+  {
+    bucket.elapsed += dt;
+    bucket.due = bucket.elapsed >= bucket.interval;
+    if( bucket.due )
+    {
+      dueBucket = &bucket;
+      ++dueCount;
+    }
+  }
+
+  if( dueCount == 1 )
+  {
+    // usually the components without interval: just run their bucket
+    for( size_t i : dueBucket->steps )
+      runStep( _program[i], dueBucket->elapsed, profiling );
+  }
+  else if( dueCount > 1 )
+  {
+    // keep the configuration order across buckets, later components
+    // depend on the outputs of earlier ones
+    for( auto& step : _program )
+    {
+      const Bucket& bucket = _buckets[step.bucket];
+      if( bucket.due )
+        runStep( step, bucket.elapsed, profiling );
+    }
+  }
+
+  for( auto& bucket : _buckets )
+  {
+    if( bucket.due )
+      bucket.elapsed = 0.0;
+  }
+}
+
+void Autopilot::runStep( Step& step, double dt, bool profiling )
+{
+  if( step.component->is_suspended() )
+    return;
+
+  SGTimeStamp start;
+  if( profiling )
+    start.stamp();
+
+  try
+  {
+    step.component->update( dt );
+  }
+  catch( const sg_exception& e )
+  {
+    SG_LOG( SG_AUTOPILOT, SG_ALERT, "caught exception processing "
+            "autopilot component " << step.name << ": " << e.getMessage() );
+  }
+
+  if( profiling )
+    updateProfile( step, (SGTimeStamp::now() - start).toUSecs() );
+}
+void Autopilot::updateProfile( Step& step, double usecs )
+{
+  if( !step.profileNode )
+  {
+    const int index = static_cast<int>( &step - &_program[0] );
+    step.profileNode = _rootNode->getNode("profiling/component", index, true);
+    step.profileNode->setStringValue( "name", step.name );
+    step.meanUs = usecs;
+  }
+
+  // smoothed over roughly the last 100 updates
+  step.meanUs += (usecs - step.meanUs) * 0.01;
+  step.profileNode->setDoubleValue( "time-us", usecs );
+  step.profileNode->setDoubleValue( "mean-us", step.meanUs );
 }
@@ -23,6 +23,9 @@
 #ifndef __AUTOPILOT_HXX
 #define __AUTOPILOT_HXX 1
 
+#include <string>
+#include <vector>
+
 #include <simgear/props/props.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 
@@ -33,6 +36,13 @@ class Component;
 /**
  * @brief A SGSubsystemGroup implementation to serve as a collection
  * of Components
+ *
+ * The components stay members of the group for bind/init/unbind, but
+ * update() runs them from a flat list in configuration order, without
+ * the generic per-member bookkeeping of SGSubsystemGroup.  Components
+ * sharing an update interval are kept in one bucket with a single timer.
+ * Setting &lt;root&gt;/profiling/enabled publishes the time spent in each
+ * component below &lt;root&gt;/profiling.
  */
 class Autopilot : public SGSubsystemGroup
 {
@@ -59,9 +69,35 @@ public:
 protected:
 
 private:
+    struct Step
+    {
+        Component* component; // owned by the group
+        std::string name;
+        size_t bucket;
+        double meanUs;
+        SGPropertyNode_ptr profileNode;
+    };
+
+    /// components with the same update interval
+    struct Bucket
+    {
+        double interval;
+        double elapsed;
+        bool due;
+        std::vector<size_t> steps; ///< in configuration order
+    };
+
+    void run( double dt, bool profiling );
+    void runStep( Step& step, double dt, bool profiling );
+    void updateProfile( Step& step, double usecs );
+
     std::string _name;
     bool _serviceable;
     SGPropertyNode_ptr _rootNode;
+    SGPropertyNode_ptr _profilingNode;
+    SGPropertyNode_ptr _totalUsNode;
+    std::vector<Step> _program;
+    std::vector<Bucket> _buckets;
 };
 
 }
@@ -65,6 +65,13 @@ double PeriodicalValue::normalizeSymmetric( double value ) const
   return value > width_2 ? width_2 - value : value;
 }
 
+//------------------------------------------------------------------------------
+bool PeriodicalValue::is_constant() const
+{
+  return minPeriod && maxPeriod
+      && minPeriod->is_constant() && maxPeriod->is_constant();
+}
+
 //------------------------------------------------------------------------------
 InputValue::InputValue( SGPropertyNode& prop_root,
                         SGPropertyNode& cfg,
@@ -72,7 +79,8 @@ InputValue::InputValue( SGPropertyNode& prop_root,
                         double offset,
                         double scale ):
   _value(0.0),
-  _abs(false)
+  _abs(false),
+  _constant(false)
 {
   parse(prop_root, cfg, value, offset, scale);
 }
@@ -85,6 +93,7 @@ void InputValue::parse( SGPropertyNode& prop_root,
                         double aScale )
 {
   _value = aValue;
+  _constant = false;
   _property = NULL;
   _offset = NULL;
   _scale = NULL;
@@ -123,6 +132,7 @@ void InputValue::parse( SGPropertyNode& prop_root,
   if( (n = cfg.getChild("expression")) != NULL )
   {
     _expression = SGReadDoubleExpression(&prop_root, n->getChild(0));
+    fold();
     return;
   }
 
@@ -159,6 +169,38 @@ void InputValue::parse( SGPropertyNode& prop_root,
     if( endp == textnode )
       _property = prop_root.getNode(textnode, true);
   }
+
+  fold();
+}
+
+//------------------------------------------------------------------------------
+void InputValue::fold()
+{
+  if( _expression && _expression->isConst() )
+  {
+    _value = _expression->getValue(NULL);
+    _expression = NULL;
+  }
+
+  // scale, offset and clip values are usually plain numbers: their nested
+  // InputValues are constant and return right away, but the whole chain can
+  // only be replaced by its result if nothing in it reads a property.
+  if(    _expression || _property
+      || (_scale && !_scale->is_constant())
+      || (_offset && !_offset->is_constant())
+      || (_min && !_min->is_constant())
+      || (_max && !_max->is_constant())
+      || (_periodical && !_periodical->is_constant()) )
+    return;
+
+  _value = get_value();
+  _abs = false;
+  _scale = NULL;
+  _offset = NULL;
+  _min = NULL;
+  _max = NULL;
+  _periodical = NULL;
+  _constant = true;
 }
 
 void InputValue::set_value( double aValue ) 
@@ -175,6 +217,9 @@ void InputValue::set_value( double aValue )
 
 double InputValue::get_value() const
 {
+    if( _constant )
+        return _value;
+
     double value = _value;
 
     if (_expression) {
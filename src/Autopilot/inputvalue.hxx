@@ -48,6 +48,9 @@ public:
                       SGPropertyNode& cfg );
      double normalize( double value ) const;
      double normalizeSymmetric( double value ) const;
+
+     /* true if the period does not depend on any property */
+     bool is_constant() const;
 };
 
 /**
@@ -61,6 +64,7 @@ class InputValue : public SGReferenced {
 private:
      double             _value;    // The value as a constant or initializer for the property
      bool               _abs;      // return absolute value
+     bool               _constant; // _value is the final result of get_value()
      SGPropertyNode_ptr _property; // The name of the property containing the value
      InputValue_ptr _offset;   // A fixed offset, defaults to zero
      InputValue_ptr _scale;    // A constant scaling factor defaults to one
@@ -69,7 +73,10 @@ private:
      PeriodicalValue_ptr  _periodical; //
      SGSharedPtr<const SGCondition> _condition;
      SGSharedPtr<SGExpressiond> _expression;  ///< expression to generate the value
-     
+
+     /* evaluate all parts which do not depend on properties once */
+     void fold();
+
 public:
     InputValue( SGPropertyNode& prop_root,
                 SGPropertyNode& node,
@@ -94,6 +101,9 @@ public:
     /* get the value of this input, apply scale and offset and clipping */
     double get_value() const;
 
+    /* true if get_value() does not depend on any property */
+    bool is_constant() const { return _constant; }
+
     /* set the input value after applying offset and scale */
     void set_value( double value );
 
@@ -131,8 +141,13 @@ class InputValueList : public std::vector<InputValue_ptr> {
     }
 
     double get_value() const {
-      InputValue_ptr input = get_active();
-      return input == NULL ? _def : input->get_value();
+      // called several times per component and frame: avoid the reference
+      // counting of get_active()
+      for (const_iterator it = begin(); it != end(); ++it) {
+        if( (*it)->is_enabled() )
+          return (*it)->get_value();
+      }
+      return _def;
     }
   private:
 
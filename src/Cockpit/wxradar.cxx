@@ -45,6 +45,7 @@
 
 #include <sstream>
 #include <iomanip>
+#include <cstring>
 
 using std::stringstream;
 using std::endl;
@@ -56,6 +57,7 @@ using std::string;
 
 #include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
+#include <AIModel/AIManager.hxx>
 
 #include "panel.hxx" // for FGTextureManager
 #include "od_gauge.hxx"
@@ -609,6 +611,32 @@ wxRadarBg::update_data(const SGPropertyNode *ac, double altitude, double heading
 }
 
 
+/** Radar echo size and normalised cross section of an AI object, by the name
+ * of its /ai/models node.  Returns false for objects which give no echo. */
+static bool
+echoParameters(const char* name, double& echo_radius, double& sigma)
+{
+    if (!strcmp(name, "aircraft") || !strcmp(name, "tanker"))
+        echo_radius = 1, sigma = 1;
+    else if (!strcmp(name, "multiplayer") || !strcmp(name, "wingman") ||
+             !strcmp(name, "static"))
+        echo_radius = 1.5, sigma = 1;
+    else if (!strcmp(name, "ship") || !strcmp(name, "carrier") ||
+             !strcmp(name, "escort") || !strcmp(name, "storm"))
+        echo_radius = 1.5, sigma = 100;
+    else if (!strcmp(name, "thermal"))
+        echo_radius = 2, sigma = 100;
+    else if (!strcmp(name, "rocket"))
+        echo_radius = 0.1, sigma = 0.1;
+    else if (!strcmp(name, "ballistic"))
+        echo_radius = 0.001, sigma = 0.001;
+    else
+        return false;
+
+    return true;
+}
+
+
 void
 wxRadarBg::update_aircraft()
 {
@@ -705,50 +733,44 @@ wxRadarBg::update_aircraft()
 
     int selected_id = fgGetInt("/instrumentation/radar/selected-id", -1);
 
-    const SGPropertyNode *selected_ac = 0;
-    const SGPropertyNode *ai = fgGetNode("/ai/models", true);
+    FGAIManager* aiManager = globals->get_subsystem<FGAIManager>();
+    if (!aiManager)
+        return;
+
+    // only look at traffic the radar can see at all: the largest cross
+    // section (ships, storms...) gives the longest range
+    const FGAITrafficSnapshot& traffic = aiManager->trafficSnapshot();
+    _nearby_traffic.clear();
+    traffic.findInRange(SGGeod::fromDeg(user_lon, user_lat),
+                        maxRadarRange() * SG_NM_TO_METER, _nearby_traffic);
 
-    for (int i = ai->nChildren() - 1; i >= -1; i--) {
-        const SGPropertyNode *model;
+    int selected_ac = -1;
 
-        if (i < 0) { // last iteration: selected model
-            model = selected_ac;
+    for (int k = _nearby_traffic.size() - 1; k >= -1; k--) {
+        int i;
+
+        if (k < 0) { // last iteration: selected model
+            i = selected_ac;
         } else {
-            model = ai->getChild(i);
-            if (!model->nChildren())
-                continue;
-            if ((model->getIntValue("id") == selected_id)&&
+            i = _nearby_traffic[k];
+            if ((traffic.id(i) == selected_id)&&
                 (!draw_tcas)) {
-                selected_ac = model;  // save selected model for last iteration
+                selected_ac = i;  // save selected model for last iteration
                 continue;
             }
         }
-        if (!model)
+        if (i < 0)
             continue;
 
         double echo_radius, sigma;
-        const string name = model->getName();
-
-        //cout << "name "<<name << endl;
-        if (name == "aircraft" || name == "tanker")
-            echo_radius = 1, sigma = 1;
-        else if (name == "multiplayer" || name == "wingman" || name == "static")
-            echo_radius = 1.5, sigma = 1;
-        else if (name == "ship" || name == "carrier" || name == "escort" ||name == "storm")
-            echo_radius = 1.5, sigma = 100;
-        else if (name == "thermal")
-            echo_radius = 2, sigma = 100;
-        else if (name == "rocket")
-            echo_radius = 0.1, sigma = 0.1;
-        else if (name == "ballistic")
-            echo_radius = 0.001, sigma = 0.001;
-        else
+        if (!echoParameters(traffic.typeName(i), echo_radius, sigma))
             continue;
 
-        double lat = model->getDoubleValue("position/latitude-deg");
-        double lon = model->getDoubleValue("position/longitude-deg");
-        double alt = model->getDoubleValue("position/altitude-ft");
-        double heading = model->getDoubleValue("orientation/true-heading-deg");
+        const SGPropertyNode *model = traffic.props(i);
+        double lat = traffic.latitudeDeg(i);
+        double lon = traffic.longitudeDeg(i);
+        double alt = traffic.altitudeFt(i);
+        double heading = traffic.headingDeg(i);
 
         double range, bearing;
         calcRangeBearing(user_lat, user_lon, lat, lon, range, bearing);
@@ -801,9 +823,9 @@ wxRadarBg::update_aircraft()
             addQuad(_vertices, _texCoords, m, texBase);
         }
 
-        if ((draw_data || i < 0)&&  // selected one (i == -1) is always drawn
+        if ((draw_data || k < 0)&&  // selected one (k == -1) is always drawn
             ((!draw_tcas)||(is_tcas_contact)||(draw_echoes)))
-            update_data(model, alt, heading, radius, bearing, i < 0);
+            update_data(model, alt, heading, radius, bearing, k < 0);
     }
 }
 
@@ -1021,6 +1043,19 @@ wxRadarBg::inRadarRange(double sigma, double range_nm)
 }
 
 
+double
+wxRadarBg::maxRadarRange()
+{
+    // range of the largest cross section used by echoParameters()
+    double constant = _radar_ref_rng;
+
+    if (constant <= 0)
+        constant = 35;
+
+    return constant * pow(100.0, 0.25);
+}
+
+
 void
 wxRadarBg::calcRangeBearing(double lat, double lon, double lat2, double lon2,
                             double &range, double &bearing) const
@@ -88,6 +88,8 @@ protected:
     ground_echo_vector_type       ground_echoes;
     ground_echo_vector_iterator   ground_echoes_iterator;
 
+    std::vector<size_t> _nearby_traffic;
+
     // Convenience function for creating a property node with a
     // default value
     template<typename DefaultType>
@@ -170,6 +172,7 @@ private:
 
     bool withinRadarHorizon(double user_alt, double alt, double range);
     bool inRadarRange(double sigma, double range);
+    double maxRadarRange();
 
     float calcRelBearing(float bearing, float heading);
     float calcRelBearingDeg(float bearing, float heading);
@@ -113,13 +113,9 @@ pair<double,double> PT_vs_hpt(
 
 
 FGAtmoCache::FGAtmoCache() :
-    a_tvs_p(0)
+    tables(0)
 {}
 
-FGAtmoCache::~FGAtmoCache() {
-    delete a_tvs_p;
-}
-
 
 /////////////
 // The following two routines are called "fake" because they
@@ -151,38 +147,61 @@ double FGAtmo::a_vs_p(const double press, const double qnh) {
     return T0 * ( pow(qnh/P0,nn) - pow(press/P0,nn) ) / lam0;
 }
 
-// force retabulation
-void FGAtmoCache::tabulate() {
-    using namespace atmodel;
-    delete a_tvs_p;
-    a_tvs_p = new SGInterpTable;
-
-    for (double hgt = -1000; hgt <= 32000;) {
-        double press,temp;
-        std::tie(press, temp) = PT_vs_hpt(hgt);
-        a_tvs_p->addEntry(press / inHg, hgt / foot);
-
-#ifdef DEBUG_EXPORT_P_H
-        char buf[100];
-        char* fmt = " { %9.2f  , %5.0f },";
-        if (press < 10000) fmt = " {  %9.3f , %5.0f },";
-        snprintf(buf, 100, fmt, press, hgt);
-        cout << buf << endl;
-#endif
-        if (hgt < 6000) {
-            hgt += 500;
+// altitude [m] at which PT_vs_hpt gives the pressure press [Pa]
+static double h_vs_p(const double press) {
+    double lo(-2000), hi(40000);
+    for (int ii = 0; ii < 40; ii++) {
+        double mid = 0.5 * (lo + hi);
+        if (PT_vs_hpt(mid).first > press) {
+            lo = mid;
         } else {
-            hgt += 1000;
+            hi = mid;
         }
     }
+    return 0.5 * (lo + hi);
+}
+
+static FGAtmoTables make_tables() {
+    using namespace atmodel;
+    using namespace atmodel::table;
+    FGAtmoTables rslt;
+
+    for (int ii = 0; ii < p_size; ii++) {
+        double press = (p_min_inHg + ii * p_step_inHg) * inHg;
+        rslt.a_vs_p[ii] = h_vs_p(press) / foot;
+    }
+
+    for (int ii = 0; ii < a_size; ii++) {
+        double hgt = (a_min_ft + ii * a_step_ft) * foot;
+        rslt.p_vs_a[ii] = PT_vs_hpt(hgt).first / inHg;
+    }
+    return rslt;
+}
+
+// the tables are built once, by whichever instance comes first
+void FGAtmoCache::tabulate() {
+    static const FGAtmoTables shared = make_tables();
+    tables = &shared;
 }
 
 // make sure cache is valid
 void FGAtmoCache::cache() {
-    if (!a_tvs_p)
+    if (!tables)
         tabulate();
 }
 
+void FGAtmoCache::a_vs_p_ft(const double * p_inHg, double * a_ft,
+            const size_t count) const {
+    for (size_t ii = 0; ii < count; ii++)
+        a_ft[ii] = a_vs_p_ft(p_inHg[ii]);
+}
+
+void FGAtmoCache::p_vs_a_inHg(const double * a_ft, double * p_inHg,
+            const size_t count) const {
+    for (size_t ii = 0; ii < count; ii++)
+        p_inHg[ii] = p_vs_a_inHg(a_ft[ii]);
+}
+
 // Check the basic function,
 // then compare against the interpolator.
 void FGAtmoCache::check_model() {
@@ -215,7 +234,7 @@ void FGAtmoCache::check_model() {
         cout << "Height: " << height
              << " \tpressure: " << press << endl;
         cout << "Check:  "
-             << a_tvs_p->interpolate(press / inHg)*foot << endl;
+             << a_vs_p_ft(press / inHg)*foot << endl;
     }
 }
 
@@ -228,8 +247,8 @@ FGAltimeter::FGAltimeter()
 
 double FGAltimeter::reading_ft(const double p_inHg, const double set_inHg) {
     using namespace atmodel;
-    double press_alt      = a_tvs_p->interpolate(p_inHg);
-    double kollsman_shift = a_tvs_p->interpolate(set_inHg);
+    double press_alt      = a_vs_p_ft(p_inHg);
+    double kollsman_shift = a_vs_p_ft(set_inHg);
     return (press_alt - kollsman_shift);
 }
 
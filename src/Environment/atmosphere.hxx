@@ -28,7 +28,9 @@
 #include <simgear/compiler.h>
 #include <simgear/math/interpolater.hxx>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <utility>
 
 /**
@@ -61,6 +63,16 @@ namespace atmodel {
         SCD(T0, 15. + freezing);	// [K] ISA sea-level temperature
         SCD(lam0, .0065);		// [K/m] ISA troposphere lapse rate
     }
+
+    // grids of the FGAtmoCache tables
+    namespace table {
+        SCD(p_min_inHg, 0.25);		// above 105000 ft
+        SCD(p_step_inHg, 0.01);
+        const int p_size(3351);		// up to 33.75 inHg, below -3000 ft
+        SCD(a_min_ft, -3500.);
+        SCD(a_step_ft, 50.);
+        const int a_size(2171);		// up to 105000 ft
+    }
 }
 #undef SCD
 
@@ -121,16 +133,54 @@ public:
 
 
 
+/**
+ * ISA tables, shared by all FGAtmoCache instances: altitude versus
+ * pressure and its inverse, each on a uniform grid so a lookup is an
+ * index computation and one linear interpolation.
+ */
+struct FGAtmoTables {
+    alignas(64) float a_vs_p[atmodel::table::p_size];	// [ft]
+    alignas(64) float p_vs_a[atmodel::table::a_size];	// [inHg]
+};
+
+
+
 class FGAtmoCache : FGAtmo {
     friend class FGAltimeter;
-    SGInterpTable * a_tvs_p;	// _tvs_ means "tabulated versus"
+    const FGAtmoTables * tables;
+
+    static inline double lookup(const float * tbl, const int size,
+                const double x) {
+        double xx = std::min(std::max(x, 0.), size - 1.);
+        int ii = std::min(int(xx), size - 2);
+        return tbl[ii] + (tbl[ii+1] - tbl[ii]) * (xx - ii);
+    }
 
 public:
     FGAtmoCache();
-    ~FGAtmoCache();
     void tabulate();
     void cache();
     void check_model();  // debug
+
+    // ISA pressure altitude [ft] at a pressure [inHg]
+    inline double a_vs_p_ft(const double p_inHg) const {
+        using namespace atmodel::table;
+        return lookup(tables->a_vs_p, p_size,
+                (p_inHg - p_min_inHg) * (1. / p_step_inHg));
+    }
+
+    // ISA pressure [inHg] at a pressure altitude [ft]
+    inline double p_vs_a_inHg(const double a_ft) const {
+        using namespace atmodel::table;
+        return lookup(tables->p_vs_a, a_size,
+                (a_ft - a_min_ft) * (1. / a_step_ft));
+    }
+
+    // batched lookups, for the static ports and altimeters of a cockpit
+    void a_vs_p_ft(const double * p_inHg, double * a_ft,
+                const size_t count) const;
+    void p_vs_a_inHg(const double * a_ft, double * p_inHg,
+                const size_t count) const;
 };
 
 
@@ -141,10 +191,10 @@ public:
     double reading_ft(const double p_inHg,
             const double set_inHg = atmodel::ISA::P0/atmodel::inHg);
     inline double press_alt_ft(const double p_inHg) {
-        return a_tvs_p->interpolate(p_inHg);
+        return a_vs_p_ft(p_inHg);
     }
     inline double kollsman_ft(const double set_inHg) {
-        return a_tvs_p->interpolate(set_inHg);
+        return a_vs_p_ft(set_inHg);
     }
 
     // debug
@@ -0,0 +1,184 @@
+// atmospherefield.cxx -- wind and air mass for arbitrary points
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <cmath>
+
+#include <simgear/math/SGMath.hxx>
+
+#include "atmospherefield.hxx"
+#include "environment.hxx"
+
+namespace Environment {
+
+// split a grid coordinate into cell index and fraction, clamped to the grid
+static inline size_t gridCell(double x, size_t count, double& fraction)
+{
+    if (count < 2 || x <= 0.0) {
+        fraction = 0.0;
+        return 0;
+    }
+
+    const double last = static_cast<double>(count - 1);
+    if (x >= last) {
+        fraction = 1.0;
+        return count - 2;
+    }
+
+    const double cell = floor(x);
+    fraction = x - cell;
+    return static_cast<size_t>(cell);
+}
+
+AtmosphereField::AtmosphereField()
+{
+}
+
+AtmosphereField::Sample
+AtmosphereField::sample(double altitudeFt, double altitudeAglFt) const
+{
+    ++_queries;
+    if (!_boundary.empty() && (altitudeAglFt < _boundaryTopFt))
+        return sampleBoundary(altitudeFt - altitudeAglFt, altitudeAglFt);
+
+    return sampleAloft(altitudeFt);
+}
+
+void AtmosphereField::sample(const std::vector<Point>& points,
+                             std::vector<Sample>& results) const
+{
+    results.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Point& p = points[i];
+        if (!_boundary.empty() && (p.altitudeAglFt < _boundaryTopFt)) {
+            results[i] = sampleBoundary(p.altitudeFt - p.altitudeAglFt,
+                                        p.altitudeAglFt);
+        } else {
+            results[i] = sampleAloft(p.altitudeFt);
+        }
+    }
+
+    _queries += points.size();
+}
+
+size_t AtmosphereField::takeQueryCount()
+{
+    const size_t count = _queries;
+    _queries = 0;
+    return count;
+}
+
+void AtmosphereField::setAloft(double minFt, double stepFt,
+                               std::vector<Sample>& samples)
+{
+    _aloftMinFt = minFt;
+    _aloftStepFt = stepFt;
+    _aloft.swap(samples);
+}
+
+void AtmosphereField::setBoundary(double minGroundFt, double groundStepFt,
+                                  double topAglFt, size_t aglColumns,
+                                  std::vector<Sample>& samples)
+{
+    if (aglColumns < 2 || samples.size() < aglColumns) {
+        clearBoundary();
+        return;
+    }
+
+    _groundMinFt = minGroundFt;
+    _groundStepFt = groundStepFt;
+    _boundaryTopFt = topAglFt;
+    _aglColumns = aglColumns;
+    _aglStepFt = topAglFt / (aglColumns - 1);
+    _groundRows = samples.size() / aglColumns;
+    _boundary.swap(samples);
+}
+
+void AtmosphereField::clearBoundary()
+{
+    _boundary.clear();
+    _aglColumns = 0;
+    _groundRows = 0;
+    _boundaryTopFt = 0.0;
+}
+
+AtmosphereField::Sample
+AtmosphereField::fromEnvironment(const FGEnvironment& env)
+{
+    Sample s;
+    s.windFromNorthFps = env.get_wind_from_north_fps();
+    s.windFromEastFps = env.get_wind_from_east_fps();
+    s.windFromDownFps = env.get_wind_from_down_fps();
+    s.temperatureDegC = env.get_temperature_degc();
+    s.pressureInhg = env.get_pressure_inhg();
+    s.densitySlugft3 = env.get_density_slugft3();
+    return s;
+}
+
+void AtmosphereField::lerp(const Sample& a, const Sample& b, double f,
+                           Sample& out)
+{
+    out.windFromNorthFps = a.windFromNorthFps + (b.windFromNorthFps - a.windFromNorthFps) * f;
+    out.windFromEastFps = a.windFromEastFps + (b.windFromEastFps - a.windFromEastFps) * f;
+    out.windFromDownFps = a.windFromDownFps + (b.windFromDownFps - a.windFromDownFps) * f;
+    out.temperatureDegC = a.temperatureDegC + (b.temperatureDegC - a.temperatureDegC) * f;
+    out.pressureInhg = a.pressureInhg + (b.pressureInhg - a.pressureInhg) * f;
+    out.densitySlugft3 = a.densitySlugft3 + (b.densitySlugft3 - a.densitySlugft3) * f;
+}
+
+AtmosphereField::Sample
+AtmosphereField::sampleAloft(double altitudeFt) const
+{
+    if (_aloft.empty())
+        return Sample();
+    if (_aloft.size() == 1)
+        return _aloft.front();
+
+    double f;
+    const size_t i = gridCell((altitudeFt - _aloftMinFt) / _aloftStepFt,
+                              _aloft.size(), f);
+    Sample result;
+    lerp(_aloft[i], _aloft[i + 1], f, result);
+    return result;
+}
+
+AtmosphereField::Sample
+AtmosphereField::sampleBoundary(double groundFt, double altitudeAglFt) const
+{
+    double fa, fg;
+    const size_t col = gridCell(altitudeAglFt / _aglStepFt, _aglColumns, fa);
+    const Sample* row0 = &_boundary[0];
+    const Sample* row1 = row0;
+    if (_groundRows > 1) {
+        const size_t row = gridCell((groundFt - _groundMinFt) / _groundStepFt,
+                                    _groundRows, fg);
+        row0 = &_boundary[row * _aglColumns];
+        row1 = row0 + _aglColumns;
+    } else {
+        fg = 0.0;
+    }
+
+    Sample low, high, result;
+    lerp(row0[col], row0[col + 1], fa, low);
+    lerp(row1[col], row1[col + 1], fa, high);
+    lerp(low, high, fg, result);
+    return result;
+}
+
+} // namespace Environment
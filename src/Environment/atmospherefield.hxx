@@ -0,0 +1,129 @@
+// atmospherefield.hxx -- wind and air mass for arbitrary points
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef _ATMOSPHEREFIELD_HXX
+#define _ATMOSPHEREFIELD_HXX
+
+#include <cstddef>
+#include <vector>
+
+class FGEnvironment;
+
+namespace Environment {
+
+/**
+ * The environment described by the boundary and aloft layers of
+ * /environment/config, sampled onto grids so it can be evaluated for many
+ * points at a time.
+ *
+ * The layers do not vary horizontally: the aloft layers depend on the
+ * altitude above sea level only, the boundary layers on the altitude above
+ * ground and, for temperature and pressure, above sea level.  So the field
+ * is a column over sea level altitude for the air above the boundary layer
+ * and transition, plus a grid over ground elevation and altitude above
+ * ground for the air below.  The ground elevation rows are centered on
+ * the terrain below the user; points over higher or lower ground use the
+ * outermost row.
+ *
+ * The field is rebuilt periodically by the layer interpolation controller;
+ * queries interpolate linearly between grid points.
+ */
+class AtmosphereField
+{
+public:
+    struct Sample
+    {
+        double windFromNorthFps = 0.0;
+        double windFromEastFps = 0.0;
+        double windFromDownFps = 0.0;
+        double temperatureDegC = 15.0;
+        double pressureInhg = 29.92;
+        double densitySlugft3 = 0.0023769;
+    };
+
+    struct Point
+    {
+        double altitudeFt;
+        /// altitude above ground, use the altitude if the ground is unknown
+        double altitudeAglFt;
+    };
+
+    AtmosphereField();
+
+    /**
+     * False until the controller built the field for the first time.
+     */
+    bool valid() const
+    { return !_aloft.empty(); }
+
+    Sample sample(double altitudeFt, double altitudeAglFt) const;
+
+    /**
+     * Evaluate all points; results is resized to match.
+     */
+    void sample(const std::vector<Point>& points,
+                std::vector<Sample>& results) const;
+
+    /**
+     * Number of points evaluated since the last call.
+     */
+    size_t takeQueryCount();
+
+    /**
+     * Grid points, total.
+     */
+    size_t size() const
+    { return _aloft.size() + _boundary.size(); }
+
+    // Building the field.  The sample vectors are taken over.
+
+    void setAloft(double minFt, double stepFt, std::vector<Sample>& samples);
+
+    /**
+     * @param samples rows of aglColumns samples, one row per ground
+     *        elevation, the last column at topAglFt
+     */
+    void setBoundary(double minGroundFt, double groundStepFt,
+                     double topAglFt, size_t aglColumns,
+                     std::vector<Sample>& samples);
+    void clearBoundary();
+
+    static Sample fromEnvironment(const FGEnvironment& env);
+
+private:
+    static void lerp(const Sample& a, const Sample& b, double f, Sample& out);
+
+    Sample sampleAloft(double altitudeFt) const;
+    Sample sampleBoundary(double groundFt, double altitudeAglFt) const;
+
+    double _aloftMinFt = 0.0;
+    double _aloftStepFt = 1.0;
+    std::vector<Sample> _aloft;
+
+    double _groundMinFt = 0.0;
+    double _groundStepFt = 1.0;
+    double _boundaryTopFt = 0.0;
+    double _aglStepFt = 1.0;
+    size_t _aglColumns = 0;
+    size_t _groundRows = 0;
+    std::vector<Sample> _boundary;
+
+    mutable size_t _queries = 0;
+};
+
+} // namespace Environment
+
+#endif // _ATMOSPHEREFIELD_HXX
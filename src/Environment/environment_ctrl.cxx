@@ -27,7 +27,9 @@
 #include <algorithm>
 
 #include <simgear/math/SGMath.hxx>
+#include <simgear/timing/timestamp.hxx>
 #include <Main/fg_props.hxx>
+#include "atmospherefield.hxx"
 #include "environment_ctrl.hxx"
 #include "environment.hxx"
 
@@ -104,7 +106,8 @@ private:
 class LayerInterpolateControllerImplementation : public LayerInterpolateController
 {
 public:
-    LayerInterpolateControllerImplementation( SGPropertyNode_ptr rootNode );
+    LayerInterpolateControllerImplementation( SGPropertyNode_ptr rootNode,
+                                              AtmosphereField * field );
     
     // Subsystem API.
     void bind() override;
@@ -118,6 +121,15 @@ public:
     static const char* staticSubsystemClassId() { return "layer-interpolate-controller"; }
 
 private:
+    /**
+     * @brief Interpolate the environment for a given altitude, blending the
+     *        boundary and aloft layers as configured
+     */
+    void interpolate( double altitude_ft, double altitude_agl_ft, FGEnvironment * result );
+
+    void updateField( double delta_time_sec, double ground_ft );
+    void buildField( double ground_ft );
+
     SGPropertyNode_ptr _rootNode;
     bool _enabled;
     double _boundary_transition;
@@ -129,6 +141,14 @@ private:
 
     FGEnvironment _environment;
     simgear::TiedPropertyList _tiedProperties;
+
+    AtmosphereField * _field;
+    double _field_age;
+    double _field_ground_ft;
+    SGPropertyNode_ptr _field_interval_n;
+    SGPropertyNode_ptr _field_update_us_n;
+    SGPropertyNode_ptr _field_queries_n;
+    SGPropertyNode_ptr _field_points_n;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -254,15 +274,35 @@ void LayerTable::interpolate( double altitude_ft, FGEnvironment * result )
 
 //////////////////////////////////////////////////////////////////////////////
 
-LayerInterpolateControllerImplementation::LayerInterpolateControllerImplementation( SGPropertyNode_ptr rootNode ) :
+// grid of the atmosphere field: the aloft column, and below the boundary
+// layer top plus transition, rows for ground elevations around the user
+static const double FIELD_ALOFT_MIN_FT = -2000.0;
+static const double FIELD_ALOFT_STEP_FT = 500.0;
+static const int FIELD_ALOFT_SAMPLES = 125; // up to 60000ft
+static const double FIELD_AGL_STEP_FT = 100.0;
+static const double FIELD_GROUND_STEP_FT = 500.0;
+static const int FIELD_GROUND_ROWS = 9;
+
+LayerInterpolateControllerImplementation::LayerInterpolateControllerImplementation( SGPropertyNode_ptr rootNode,
+                                                                                    AtmosphereField * field ) :
   _rootNode( rootNode ),
   _enabled(true),
   _boundary_transition(0.0),
   _altitude_n( fgGetNode("/position/altitude-ft", true)),
   _altitude_agl_n( fgGetNode("/position/altitude-agl-ft", true)),
   _boundary_table( rootNode->getNode("boundary", true ) ),
-  _aloft_table( rootNode->getNode("aloft", true ) )
+  _aloft_table( rootNode->getNode("aloft", true ) ),
+  _field( field ),
+  _field_age( 0.0 ),
+  _field_ground_ft( 0.0 )
 {
+    SGPropertyNode_ptr fieldNode = fgGetNode("/environment/field", true);
+    _field_interval_n = fieldNode->getNode("update-interval-sec", true);
+    _field_update_us_n = fieldNode->getNode("update-us", true);
+    _field_queries_n = fieldNode->getNode("queries-per-sec", true);
+    _field_points_n = fieldNode->getNode("points", true);
+    if( !_field_interval_n->hasValue() )
+        _field_interval_n->setDoubleValue(1.0);
 }
 
 void LayerInterpolateControllerImplementation::init ()
@@ -306,7 +346,18 @@ void LayerInterpolateControllerImplementation::unbind()
 
 void LayerInterpolateControllerImplementation::update (double delta_time_sec)
 {
-    if( !_enabled || delta_time_sec <= SGLimitsd::min() )
+    if( !_enabled ) {
+        // nothing refreshes the field any more, don't let it go stale
+        if( _field && _field->valid() ) {
+            std::vector<AtmosphereField::Sample> none;
+            _field->setAloft( FIELD_ALOFT_MIN_FT, FIELD_ALOFT_STEP_FT, none );
+            _field->clearBoundary();
+            _field_points_n->setIntValue( 0 );
+        }
+        return;
+    }
+
+    if( delta_time_sec <= SGLimitsd::min() )
         return;
 
     double altitude_ft = _altitude_n->getDoubleValue();
@@ -316,6 +367,16 @@ void LayerInterpolateControllerImplementation::update (double delta_time_sec)
     if( _boundary_transition <= SGLimitsd::min() )
         _boundary_transition = 500;
 
+    interpolate( altitude_ft, altitude_agl_ft, &_environment );
+
+    if( _field )
+        updateField( delta_time_sec, altitude_ft - altitude_agl_ft );
+}
+
+void LayerInterpolateControllerImplementation::interpolate( double altitude_ft,
+                                                            double altitude_agl_ft,
+                                                            FGEnvironment * result )
+{
     int length = _boundary_table.size();
 
     if (length > 0) {
@@ -324,7 +385,7 @@ void LayerInterpolateControllerImplementation::update (double delta_time_sec)
         if (boundary_limit >= altitude_agl_ft) {
             // If current altitude is below top of boundary layer, interpolate
             // only in boundary layer
-            _boundary_table.interpolate(altitude_agl_ft, &_environment);
+            _boundary_table.interpolate(altitude_agl_ft, result);
             return;
         } else if ((boundary_limit + _boundary_transition) >= altitude_agl_ft) {
             // If current altitude is above top of boundary layer and within the 
@@ -333,20 +394,82 @@ void LayerInterpolateControllerImplementation::update (double delta_time_sec)
             _boundary_table.interpolate( altitude_agl_ft, &env1);
             _aloft_table.interpolate(altitude_ft, &env2);
             double fraction = (altitude_agl_ft - boundary_limit) / _boundary_transition;
-            env1.interpolate(env2, fraction, &_environment);
+            env1.interpolate(env2, fraction, result);
             return;
         }
     } 
     // If no boundary layer is defined or altitude is above top boundary-layer plus boundary-transition
     // altitude, use only the aloft table
-    _aloft_table.interpolate( altitude_ft, &_environment);
+    _aloft_table.interpolate( altitude_ft, result);
+}
+
+void LayerInterpolateControllerImplementation::updateField( double delta_time_sec,
+                                                            double ground_ft )
+{
+    _field_age += delta_time_sec;
+
+    // rebuild early when the user moved out of the middle of the ground rows
+    if( _field->valid()
+        && _field_age < _field_interval_n->getDoubleValue()
+        && fabs(ground_ft - _field_ground_ft) < 2 * FIELD_GROUND_STEP_FT )
+        return;
+
+    _field_queries_n->setDoubleValue( _field->takeQueryCount() / _field_age );
+    _field_age = 0.0;
+
+    SGTimeStamp start;
+    start.stamp();
+    buildField( ground_ft );
+    _field_update_us_n->setDoubleValue( (SGTimeStamp::now() - start).toUSecs() );
+    _field_points_n->setIntValue( _field->size() );
+}
+
+void LayerInterpolateControllerImplementation::buildField( double ground_ft )
+{
+    FGEnvironment env;
+    _field_ground_ft = ground_ft;
+
+    std::vector<AtmosphereField::Sample> aloft(FIELD_ALOFT_SAMPLES);
+    for( int i = 0; i < FIELD_ALOFT_SAMPLES; i++ ) {
+        double altitude_ft = FIELD_ALOFT_MIN_FT + i * FIELD_ALOFT_STEP_FT;
+        _aloft_table.interpolate( altitude_ft, &env );
+        env.set_elevation_ft( altitude_ft );
+        aloft[i] = AtmosphereField::fromEnvironment( env );
+    }
+    _field->setAloft( FIELD_ALOFT_MIN_FT, FIELD_ALOFT_STEP_FT, aloft );
+
+    int length = _boundary_table.size();
+    if( length == 0 ) {
+        _field->clearBoundary();
+        return;
+    }
+
+    // above this, interpolate() only looks at the aloft table
+    double top_ft = _boundary_table[length-1]->altitude_ft + _boundary_transition;
+    size_t columns = std::max( 2, (int)ceil(top_ft / FIELD_AGL_STEP_FT) + 1 );
+    double agl_step_ft = top_ft / (columns - 1);
+    double min_ground_ft = floor(ground_ft / FIELD_GROUND_STEP_FT) * FIELD_GROUND_STEP_FT
+        - (FIELD_GROUND_ROWS / 2) * FIELD_GROUND_STEP_FT;
+
+    std::vector<AtmosphereField::Sample> boundary(FIELD_GROUND_ROWS * columns);
+    for( int row = 0; row < FIELD_GROUND_ROWS; row++ ) {
+        double row_ground_ft = min_ground_ft + row * FIELD_GROUND_STEP_FT;
+        for( size_t column = 0; column < columns; column++ ) {
+            double agl_ft = column * agl_step_ft;
+            interpolate( row_ground_ft + agl_ft, agl_ft, &env );
+            env.set_elevation_ft( row_ground_ft + agl_ft );
+            boundary[row * columns + column] = AtmosphereField::fromEnvironment( env );
+        }
+    }
+    _field->setBoundary( min_ground_ft, FIELD_GROUND_STEP_FT, top_ft, columns, boundary );
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-LayerInterpolateController * LayerInterpolateController::createInstance( SGPropertyNode_ptr rootNode )
+LayerInterpolateController * LayerInterpolateController::createInstance( SGPropertyNode_ptr rootNode,
+                                                                        AtmosphereField * field )
 {
-    return new LayerInterpolateControllerImplementation( rootNode );
+    return new LayerInterpolateControllerImplementation( rootNode, field );
 }
 
 //////////////////////////////////////////////////////////////////////////////
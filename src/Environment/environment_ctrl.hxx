@@ -26,10 +26,17 @@
 
 namespace Environment {
 
+class AtmosphereField;
+
 class LayerInterpolateController : public SGSubsystem
 {
 public:
-    static LayerInterpolateController * createInstance( SGPropertyNode_ptr rootNode );
+    /**
+     * @param field if given, rebuilt from the layers every
+     *        /environment/field/update-interval-sec
+     */
+    static LayerInterpolateController * createInstance( SGPropertyNode_ptr rootNode,
+                                                        AtmosphereField * field = NULL );
 };
 
 } // namespace
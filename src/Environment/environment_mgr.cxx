@@ -38,6 +38,7 @@
 
 #include <FDM/flight.hxx>
 
+#include "atmospherefield.hxx"
 #include "environment.hxx"
 #include "environment_mgr.hxx"
 #include "environment_ctrl.hxx"
@@ -83,6 +84,7 @@ void FG3DCloudsListener::valueChanged( SGPropertyNode * node )
 
 FGEnvironmentMgr::FGEnvironmentMgr () :
   _environment(new FGEnvironment()),
+  _atmosphereField(new Environment::AtmosphereField),
   fgClouds(nullptr),
   _cloudLayersDirty(true),
   _3dCloudsEnableListener(nullptr),
@@ -90,7 +92,7 @@ FGEnvironmentMgr::FGEnvironmentMgr () :
 {
   fgClouds = new FGClouds;
   _3dCloudsEnableListener = new FG3DCloudsListener(fgClouds);
-  set_subsystem("controller", Environment::LayerInterpolateController::createInstance( fgGetNode("/environment/config", true ) ));
+  set_subsystem("controller", Environment::LayerInterpolateController::createInstance( fgGetNode("/environment/config", true ), _atmosphereField ));
 
   set_subsystem("precipitation", new FGPrecipitationMgr);
   set_subsystem("realwx", Environment::RealWxController::createInstance( fgGetNode("/environment/realwx", true ) ), 1.0 );
@@ -112,6 +114,7 @@ FGEnvironmentMgr::~FGEnvironmentMgr ()
   delete fgClouds;
   delete _3dCloudsEnableListener;
   delete _environment;
+  delete _atmosphereField;
 }
 
 struct FGEnvironmentMgrMultiplayerListener : SGPropertyChangeListener {
@@ -30,6 +30,7 @@
 
 class FGEnvironment;
 class FGClouds;
+namespace Environment { class AtmosphereField; }
 class FGPrecipitationMgr;
 class SGSky;
 struct FGEnvironmentMgrMultiplayerListener;
@@ -71,6 +72,12 @@ public:
 
     virtual FGEnvironment getEnvironment(const SGGeod& aPos) const;
 
+    /**
+     * Wind and air mass for many points at once, see AtmosphereField.
+     */
+    const Environment::AtmosphereField& getAtmosphereField() const
+    { return *_atmosphereField; }
+
 private:
     friend FGEnvironmentMgrMultiplayerListener;
     void updateClosestAirport();
@@ -93,6 +100,7 @@ private:
     void set_cloud_layer_maxalpha (int index, double maxalpha);
 
     FGEnvironment * _environment; // always the same, for now
+    Environment::AtmosphereField * _atmosphereField;
     FGClouds *fgClouds;
     bool _cloudLayersDirty;
     simgear::TiedPropertyList _tiedProperties;
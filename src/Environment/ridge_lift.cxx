@@ -34,6 +34,8 @@
 #include <Main/globals.hxx>
 #include <Main/util.hxx>
 #include <Scenery/scenery.hxx>
+#include <Scenery/terrainquery.hxx>
+#include <Scenery/terrainraster.hxx>
 #include <string>
 #include <cmath>
 #include <simgear/sg_inlines.h>
@@ -85,7 +87,6 @@ void FGRidgeLift::init(void)
 	_user_longitude_node = fgGetNode("/position/longitude-deg", true);
 	_user_latitude_node = fgGetNode("/position/latitude-deg", true);
 	_user_altitude_agl_ft_node = fgGetNode("/position/altitude-agl-ft", true);
-	_ground_elev_node = fgGetNode("/position/ground-elev-ft", true );
 }
 
 void FGRidgeLift::bind() {
@@ -107,6 +108,107 @@ void FGRidgeLift::unbind() {
 	_tiedProperties.Untie();
 }
 
+double FGRidgeLift::compute_lift_factor( const double elev_m[5], double slope[4] ) {
+	// slopes
+	double adj_slope[4];
+	slope[0] = (elev_m[0] - elev_m[1]) / dist_probe_m[1];
+	slope[1] = (elev_m[1] - elev_m[2]) / dist_probe_m[2];
+	slope[2] = (elev_m[2] - elev_m[3]) / dist_probe_m[3];
+	slope[3] = (elev_m[4] - elev_m[0]) / -dist_probe_m[4];
+	
+	for (unsigned i = 0; i < 4; i++)
+		adj_slope[i] = sin(atan(5.0 * pow ( (fabs(slope[i])),1.7) ) ) *SG_SIGN<double>(slope[i]);
+	
+	//adjustment
+	adj_slope[0] *= 0.2;
+	adj_slope[1] *= 0.2;
+	if ( adj_slope [2] < 0.0 ) {
+		adj_slope[2] *= 0.5;
+	} else {
+		adj_slope[2] = 0.0 ;
+	}
+	
+	if ( ( adj_slope [0] >= 0.0 ) && ( adj_slope [3] < 0.0 ) ) {
+		adj_slope[3] = 0.0;
+	} else {
+		adj_slope[3] *= 0.2;
+	}
+	return adj_slope[0]+adj_slope[1]+adj_slope[2]+adj_slope[3];
+}
+
+bool FGRidgeLift::get_probes( const SGGeod& pos, bool exact_fallback, double lat_deg[5],
+                              double lon_deg[5], double elev_m[5] ) const {
+	FGScenery* scenery = globals->get_scenery();
+	FGTerrainRaster* raster = scenery ? scenery->get_terrain_raster() : NULL;
+	if (!raster)
+		return false;
+
+	// position is geodetic, need geocentric for advanceRadM
+	SGGeod myGeodPos = SGGeod::fromDegM( pos.getLongitudeDeg(), pos.getLatitudeDeg(), 20000.0 );
+	SGGeoc myGeocPos = SGGeoc::fromGeod( myGeodPos );
+	double ground_wind_from_rad = _surface_wind_from_deg_node->getDoubleValue() * SG_DEGREES_TO_RADIANS;
+
+	// probe0 is the position itself; ask for all probes, so every raster
+	// needed is requested at once
+	bool complete = true;
+	for (unsigned i = 0; i < 5; i++) {
+		SGGeod probeGeod = pos;
+		if (i > 0) {
+			SGGeoc probe = myGeocPos.advanceRadM( ground_wind_from_rad, dist_probe_m[i] );
+			// convert to geodetic position for ground level computation
+			probeGeod = SGGeod::fromGeoc( probe );
+		}
+		lat_deg[i] = probeGeod.getLatitudeDeg();
+		lon_deg[i] = probeGeod.getLongitudeDeg();
+		if (raster->get_elevation_m( probeGeod, elev_m[i] ))
+			continue;
+
+		// while the raster is built, probe the scenery (through the cache)
+		FGTerrainQuery* query = scenery->get_terrain_query();
+		if (!exact_fallback || !query
+		    || !query->get_elevation_m( SGGeod::fromGeodM( probeGeod, 20000.0 ),
+		                                elev_m[i], NULL ))
+			complete = false;
+	}
+	return complete;
+}
+
+double FGRidgeLift::compute_lift_mps( const double elev_m[5], double factor,
+                                      double altitude_agl_m, double wind_speed_kt ) {
+	//boundaries
+	double boundary2_m = 130.0; // in the lift
+	if (factor < 0.0) { // in the sink
+		double highest_probe_temp= std::max ( elev_m[1], elev_m[2] );
+		double highest_probe_downwind_m= std::max ( highest_probe_temp, elev_m[3] );
+		boundary2_m = highest_probe_downwind_m - elev_m[0];
+	}
+
+	double agl_factor;
+	if ( altitude_agl_m < BOUNDARY1_m ) {
+		agl_factor = 0.5+0.5*altitude_agl_m /BOUNDARY1_m ;
+	} else if ( altitude_agl_m < boundary2_m ) {
+		agl_factor = 1.0;
+	} else {
+		agl_factor = exp(-(2 + elev_m[0] / 2000) * 
+                     (altitude_agl_m - boundary2_m) / std::max(elev_m[0],200.0));
+	}
+	
+	double ground_wind_speed_mps = wind_speed_kt * SG_NM_TO_METER / 3600;
+	return factor* ground_wind_speed_mps * agl_factor;
+}
+
+bool FGRidgeLift::get_lift_fps( const SGGeod& pos, double altitude_agl_ft, double& lift_fps ) const {
+	double lat_deg[5], lon_deg[5], elev_m[5], probe_slope[4];
+	if (!get_probes( pos, false, lat_deg, lon_deg, elev_m ))
+		return false;
+
+	double factor = compute_lift_factor( elev_m, probe_slope );
+	lift_fps = compute_lift_mps( elev_m, factor, altitude_agl_ft * SG_FEET_TO_METER,
+	                             _surface_wind_speed_node->getDoubleValue() )
+		* SG_METER_TO_FEET;
+	return true;
+}
+
 void FGRidgeLift::update(double dt) {
 
 	if( dt <= SGLimitsd::min() ) // paused, do nothing but keep current lift
@@ -126,85 +228,32 @@ void FGRidgeLift::update(double dt) {
 		return;
 	}
 
+	// the probes are lookups in the terrain rasters, cheap enough for
+	// every frame; until the rasters are built they are probed directly,
+	// but only once a second
+	SGGeod pos = SGGeod::fromDeg( _user_longitude_node->getDoubleValue(),
+	                              _user_latitude_node->getDoubleValue() );
+	double lat_deg[5], lon_deg[5], elev_m[5];
 	timer -= dt;
-	if (timer <= 0.0 ) {
-
-		// probe0 is current position
-		probe_lat_deg[0] = _user_latitude_node->getDoubleValue();
-		probe_lon_deg[0] = _user_longitude_node->getDoubleValue();
-		probe_elev_m[0]  = _ground_elev_node->getDoubleValue() * SG_FEET_TO_METER;
-
-		// position is geodetic, need geocentric for advanceRadM
-		SGGeod myGeodPos = SGGeod::fromDegM( probe_lon_deg[0], probe_lat_deg[0], 20000.0 );
-		SGGeoc myGeocPos = SGGeoc::fromGeod( myGeodPos );
-		double ground_wind_from_rad = _surface_wind_from_deg_node->getDoubleValue() * SG_DEGREES_TO_RADIANS;
-
-		// compute the remaining probes
-		for (unsigned i = 1; i < sizeof(probe_elev_m)/sizeof(probe_elev_m[0]); i++) {
-			SGGeoc probe = myGeocPos.advanceRadM( ground_wind_from_rad, dist_probe_m[i] );
-			// convert to geodetic position for ground level computation
-			SGGeod probeGeod = SGGeod::fromGeoc( probe );
-			probe_lat_deg[i] = probeGeod.getLatitudeDeg();
-			probe_lon_deg[i] = probeGeod.getLongitudeDeg();
-			if (!globals->get_scenery()->get_elevation_m( probeGeod, probe_elev_m[i], NULL )) {
-				// no ground found? use elevation of previous probe :-(
-				probe_elev_m[i] = probe_elev_m[i-1];
-			}
-		}
-
-		// slopes
-		double adj_slope[sizeof(slope)];
-		slope[0] = (probe_elev_m[0] - probe_elev_m[1]) / dist_probe_m[1];
-		slope[1] = (probe_elev_m[1] - probe_elev_m[2]) / dist_probe_m[2];
-		slope[2] = (probe_elev_m[2] - probe_elev_m[3]) / dist_probe_m[3];
-		slope[3] = (probe_elev_m[4] - probe_elev_m[0]) / -dist_probe_m[4];
-	
-		for (unsigned i = 0; i < sizeof(slope)/sizeof(slope[0]); i++)
-			adj_slope[i] = sin(atan(5.0 * pow ( (fabs(slope[i])),1.7) ) ) *SG_SIGN<double>(slope[i]);
-	
-		//adjustment
-		adj_slope[0] *= 0.2;
-		adj_slope[1] *= 0.2;
-		if ( adj_slope [2] < 0.0 ) {
-			adj_slope[2] *= 0.5;
-		} else {
-			adj_slope[2] = 0.0 ;
-		}
-	
-		if ( ( adj_slope [0] >= 0.0 ) && ( adj_slope [3] < 0.0 ) ) {
-			adj_slope[3] = 0.0;
-		} else {
-			adj_slope[3] *= 0.2;
-		}
-		lift_factor = adj_slope[0]+adj_slope[1]+adj_slope[2]+adj_slope[3];
-	
+	bool complete = get_probes( pos, false, lat_deg, lon_deg, elev_m );
+	if (!complete && timer <= 0.0) {
+		complete = get_probes( pos, true, lat_deg, lon_deg, elev_m );
 		// restart the timer
 		timer = 1.0;
 	}
+	if (complete) {
+		for (unsigned i = 0; i < 5; i++) {
+			probe_lat_deg[i] = lat_deg[i];
+			probe_lon_deg[i] = lon_deg[i];
+			probe_elev_m[i] = elev_m[i];
+		}
+		lift_factor = compute_lift_factor( probe_elev_m, slope );
+	}
 	
 	//user altitude above ground
 	double user_altitude_agl_m = _user_altitude_agl_ft_node->getDoubleValue() * SG_FEET_TO_METER;
-	
-	//boundaries
-	double boundary2_m = 130.0; // in the lift
-	if (lift_factor < 0.0) { // in the sink
-		double highest_probe_temp= std::max ( probe_elev_m[1], probe_elev_m[2] );
-		double highest_probe_downwind_m= std::max ( highest_probe_temp, probe_elev_m[3] );
-		boundary2_m = highest_probe_downwind_m - probe_elev_m[0];
-	}
-
-	double agl_factor;
-	if ( user_altitude_agl_m < BOUNDARY1_m ) {
-		agl_factor = 0.5+0.5*user_altitude_agl_m /BOUNDARY1_m ;
-	} else if ( user_altitude_agl_m < boundary2_m ) {
-		agl_factor = 1.0;
-	} else {
-		agl_factor = exp(-(2 + probe_elev_m[0] / 2000) * 
-                     (user_altitude_agl_m - boundary2_m) / std::max(probe_elev_m[0],200.0));
-	}
-	
-	double ground_wind_speed_mps = _surface_wind_speed_node->getDoubleValue() * SG_NM_TO_METER / 3600;
-	double lift_mps = lift_factor* ground_wind_speed_mps * agl_factor;
+	double lift_mps = compute_lift_mps( probe_elev_m, lift_factor, user_altitude_agl_m,
+	                                    _surface_wind_speed_node->getDoubleValue() );
 	
 	//the updraft, finally, in ft per second
 	strength = fgGetLowPass( strength, lift_mps * SG_METER_TO_FEET, dt );
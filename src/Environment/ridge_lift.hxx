@@ -36,6 +36,7 @@
 #include <string>
 using std::string;
 
+#include <simgear/math/SGMath.hxx>
 #include <simgear/props/tiedpropertylist.hxx>
 
 class FGRidgeLift : public SGSubsystem
@@ -60,7 +61,31 @@ public:
     inline double get_probe_lon_deg( int index ) const { return probe_lon_deg[index]; };
     inline double get_slope( int index ) const { return slope[index]; };
 
+    /**
+     * Ridge lift at an arbitrary position, e.g. for AI gliders, without the
+     * smoothing applied to the lift of the user aircraft.  The terrain is
+     * taken from the terrain rasters of the scenery.
+     *
+     * @return false if the rasters around pos are not built yet
+     */
+    bool get_lift_fps( const SGGeod& pos, double altitude_agl_ft, double& lift_fps ) const;
+
+    /**
+     * The lift factor for the given probe elevations; also fills in the
+     * slopes between them.
+     */
+    static double compute_lift_factor( const double elev_m[5], double slope[4] );
+
+    /**
+     * The ridge lift at the given height above probe 0.
+     */
+    static double compute_lift_mps( const double elev_m[5], double factor,
+                                    double altitude_agl_m, double wind_speed_kt );
+
 private:
+    bool get_probes( const SGGeod& pos, bool exact_fallback, double lat_deg[5],
+                     double lon_deg[5], double elev_m[5] ) const;
+
     static const double dist_probe_m[5];
 
     double strength;
@@ -83,7 +108,6 @@ private:
     SGPropertyNode_ptr _user_altitude_agl_ft_node;
     SGPropertyNode_ptr _user_longitude_node;
     SGPropertyNode_ptr _user_latitude_node;
-    SGPropertyNode_ptr _ground_elev_node;
 
     simgear::TiedPropertyList _tiedProperties;
 };
@@ -27,7 +27,10 @@
 #include <Main/fg_props.hxx>
 #include <simgear/math/sg_random.h>
 #include <Scenery/scenery.hxx>
+#include <Scenery/terrainquery.hxx>
+#include <chrono>
 #include <deque>
+#include <future>
 
 #include "terrainsampler.hxx"
 
@@ -105,6 +108,7 @@ private:
     SGPropertyNode_ptr _positionLongitudeNode;
 
     deque<double> _elevations;
+    std::future<FGTerrainQuery::ResultList> _pendingSamples;
     simgear::TiedPropertyList _tiedProperties;
 };
 
@@ -179,6 +183,7 @@ void AreaSampler::init()
 {
    _signalNode->setBoolValue(false);
    _elevations.clear();
+   _pendingSamples = std::future<FGTerrainQuery::ResultList>();
    _altOffset = 0.0;
    _altMedian = 0.0;
    _altMin = 0.0;
@@ -227,28 +232,38 @@ void AreaSampler::update( double dt )
     if( _signalNode->getBoolValue() )
         return; // nothing to do.
 
-    FGScenery * scenery = globals->get_scenery();
+    FGTerrainQuery* query = globals->get_scenery()->get_terrain_query();
+    if( !query )
+        return;
+
+    if( _pendingSamples.valid() ) {
+        if( _pendingSamples.wait_for( std::chrono::seconds(0) ) != std::future_status::ready )
+            return; // still being sampled
+
+        for( const auto& sample : _pendingSamples.get() ) {
+            if( sample.valid )
+                _elevations.push_front(sample.elevationM * SG_METER_TO_FEET);
+        }
+    }
+
+    if( _elevations.size() >= (deque<unsigned>::size_type)_max_samples ) {
+        // sampling complete
+        analyse();
+        _outputPosition = _inputPosition;
+        _signalNode->setBoolValue( true );
+        return;
+    }
 
-    SGTimeStamp start = SGTimeStamp::now();
-    while( (SGTimeStamp::now() - start).toSecs() < dt * _max_computation_time_norm ) {
-        // sample until we used up all our configured time
+    // queue the missing samples, the terrain query service spreads them
+    // over as many frames as it needs
+    vector<SGGeod> probes( _max_samples - _elevations.size() );
+    for( auto& probe : probes ) {
         double distance = sg_random();
         distance = _radius * (1-distance*distance);
         double course = sg_random() * 2.0 * SG_PI;
-        SGGeod probe = SGGeod::fromGeoc(center.advanceRadM( course, distance ));
-        double elevation_m = 0.0;
-
-        if (scenery->get_elevation_m( probe, elevation_m, NULL ))
-            _elevations.push_front(elevation_m *= SG_METER_TO_FEET);
-
-        if( _elevations.size() >= (deque<unsigned>::size_type)_max_samples ) {
-            // sampling complete?
-            analyse();
-            _outputPosition = _inputPosition;
-            _signalNode->setBoolValue( true );
-            break;
-        }
+        probe = SGGeod::fromGeoc(center.advanceRadM( course, distance ));
     }
+    _pendingSamples = query->query( std::move(probes) );
 }
 
 void AreaSampler::analyse()
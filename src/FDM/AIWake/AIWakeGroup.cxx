@@ -21,6 +21,7 @@
 //
 // $Id$
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <simgear/structure/SGSharedPtr.hxx>
@@ -37,6 +38,13 @@ AIWakeGroup::AIWakeGroup(void)
 {
     SGPropertyNode* _props = globals->get_props();
     _density_slugft = _props->getNode("environment/density-slugft3", true);
+
+    // Wakes farther than this number of AI wing spans from the points where
+    // the induced velocity is requested are ignored. Zero disables the test.
+    _cull_distance_spans = _props->getNode("fdm/ai-wake/cull-distance-spans",
+                                           true);
+    if (!_cull_distance_spans->hasValue())
+        _cull_distance_spans->setDoubleValue(10.0);
 }
 
 void AIWakeGroup::AddAI(FGAIAircraft* ai)
@@ -68,16 +76,33 @@ void AIWakeGroup::AddAI(FGAIAircraft* ai)
     double gamma = atan2(vVel, hVel);
     double vel = sqrt(hVel*hVel + vVel*vVel);
     double weight = perfData->weight();
-    _aiWakeData[id].mesh->computeAoA(vel, _density_slugft->getDoubleValue(),
-                                     weight*cos(gamma));
+    // the air at the AI aircraft, not at the user's
+    const auto* atmosphere = ai->getAtmosphere();
+    double rho = atmosphere ? atmosphere->densitySlugft3
+                            : _density_slugft->getDoubleValue();
+    _aiWakeData[id].mesh->computeAoA(vel, rho, weight*cos(gamma));
+}
+
+bool AIWakeGroup::isOutOfReach(const AIWakeData& data, const SGVec3d& center,
+                               double radius) const
+{
+    double spans = _cull_distance_spans->getDoubleValue();
+    if (spans <= 0.0) return false;
+
+    // Distance from the center to the wake, approximated by the half line
+    // trailing from the AI aircraft along its -x axis.
+    SGVec3d at = data.Te2b.transform(center - data.position);
+    double d = at[0] > 0.0 ? norm(at) : sqrt(at[1]*at[1] + at[2]*at[2]);
+
+    return d > spans*data.mesh->getSpan() + radius;
 }
 
 SGVec3d AIWakeGroup::getInducedVelocityAt(const SGVec3d& pt) const
 {
     SGVec3d vi(0.,0.,0.);
-    for (auto item : _aiWakeData) {
-        AIWakeData& data = item.second;
-        if (!data.visited) continue;
+    for (const auto& item : _aiWakeData) {
+        const AIWakeData& data = item.second;
+        if (!data.visited || isOutOfReach(data, pt, 0.0)) continue;
 
         SGVec3d at = data.Te2b.transform(pt - data.position);
         vi += data.Te2b.backTransform(data.mesh->getInducedVelocityAt(at));
@@ -85,6 +110,41 @@ SGVec3d AIWakeGroup::getInducedVelocityAt(const SGVec3d& pt) const
     return vi;
 }
 
+void AIWakeGroup::getInducedVelocitiesAt(const std::vector<SGVec3d>& pts,
+                                         std::vector<SGVec3d>& vi) const
+{
+    size_t count = pts.size();
+    vi.assign(count, SGVec3d::zeros());
+    if (count == 0) return;
+
+    // Bounding sphere of the points for the culling test.
+    SGVec3d center = SGVec3d::zeros();
+    for (const auto& p : pts) center += p;
+    center *= 1.0 / count;
+    double radius = 0.0;
+    for (const auto& p : pts) radius = std::max(radius, dist(p, center));
+
+    _x.resize(count); _y.resize(count); _z.resize(count);
+    _vx.resize(count); _vy.resize(count); _vz.resize(count);
+
+    for (const auto& item : _aiWakeData) {
+        const AIWakeData& data = item.second;
+        if (!data.visited || isOutOfReach(data, center, radius)) continue;
+
+        for (size_t j=0; j<count; ++j) {
+            SGVec3d at = data.Te2b.transform(pts[j] - data.position);
+            _x[j] = at[0]; _y[j] = at[1]; _z[j] = at[2];
+            _vx[j] = _vy[j] = _vz[j] = 0.0;
+        }
+
+        data.mesh->addInducedVelocities(count, _x.data(), _y.data(), _z.data(),
+                                        _vx.data(), _vy.data(), _vz.data());
+
+        for (size_t j=0; j<count; ++j)
+            vi[j] += data.Te2b.backTransform(SGVec3d(_vx[j], _vy[j], _vz[j]));
+    }
+}
+
 void AIWakeGroup::gc(void)
 {
     for (auto it=_aiWakeData.begin(); it != _aiWakeData.end(); ++it) {
@@ -45,11 +45,22 @@ class AIWakeGroup {
 
     std::map<int, AIWakeData> _aiWakeData;
     SGPropertyNode_ptr _density_slugft;
+    SGPropertyNode_ptr _cull_distance_spans;
+
+    // Scratch arrays for getInducedVelocitiesAt()
+    mutable std::vector<double> _x, _y, _z, _vx, _vy, _vz;
+
+    bool isOutOfReach(const AIWakeData& data, const SGVec3d& center,
+                      double radius) const;
 
 public:
     AIWakeGroup(void);
     void AddAI(FGAIAircraft* ai);
     SGVec3d getInducedVelocityAt(const SGVec3d& pt) const;
+    // Velocity induced at each of the points pts, in a single pass over the
+    // AI wakes. Wakes too far from all the points are skipped.
+    void getInducedVelocitiesAt(const std::vector<SGVec3d>& pts,
+                                std::vector<SGVec3d>& vi) const;
     // Garbage collection
     void gc(void);
 };
@@ -34,6 +34,8 @@ public:
     const SGVec3d& getCollocationPoint(void) const { return collocationPt; }
     SGVec3d getBoundVortex(void) const { return p2 - p1; }
     SGVec3d getBoundVortexMidPoint(void) const { return 0.5*(p1+p2); }
+    const SGVec3d& getBoundVortexStart(void) const { return p1; }
+    const SGVec3d& getBoundVortexEnd(void) const { return p2; }
     SGVec3d getInducedVelocity(const SGVec3d& p) const;
 private:
     SGVec3d vortexInducedVel(const SGVec3d& p, const SGVec3d& n1,
@@ -21,6 +21,7 @@
 //
 // $Id$
 
+#include <algorithm>
 #include <vector>
 #include <cmath>
 
@@ -33,15 +34,23 @@
 #include <FDM/flight.hxx>
 #include "AIWakeGroup.hxx"
 #include "AIModel/AIAircraft.hxx"
-extern "C" {
-#include "../LaRCsim/ls_matrix.h"
-}
 
 AircraftMesh::AircraftMesh(double _span, double _chord)
     : WakeMesh(_span, _chord)
 {
     collPt.resize(nelm, SGVec3d::zeros());
     midPt.resize(nelm, SGVec3d::zeros());
+    wakePt.resize(2*nelm, SGVec3d::zeros());
+
+    const std::vector<AeroElement_ptr>& elements = geometry->elements;
+    for (int i=0; i<nelm; ++i) {
+        SGVec3d mp = elements[i]->getBoundVortexMidPoint();
+        mpx.push_back(mp[0]); mpy.push_back(mp[1]); mpz.push_back(mp[2]);
+    }
+
+    selfVx.resize(nelm, 0.0);
+    selfVy.resize(nelm, 0.0);
+    selfVz.resize(nelm, 0.0);
 }
 
 void AircraftMesh::setPosition(const SGVec3d& _pos, const SGQuatd& orient)
@@ -52,42 +61,57 @@ void AircraftMesh::setPosition(const SGVec3d& _pos, const SGQuatd& orient)
                                           geoc.getLatitudeRad());
     Te2b = Te2l * orient;
 
+    const std::vector<AeroElement_ptr>& elements = geometry->elements;
     for (int i=0; i<nelm; ++i) {
         SGVec3d pt = elements[i]->getCollocationPoint();
         collPt[i] = pos + Te2b.backTransform(pt);
         pt = elements[i]->getBoundVortexMidPoint();
         midPt[i] = pos + Te2b.backTransform(pt);
+        wakePt[i] = collPt[i];
+        wakePt[nelm+i] = midPt[i];
     }
 }
 
 SGVec3d AircraftMesh::GetForce(const AIWakeGroup& wg, const SGVec3d& vel,
                                double rho)
 {
+    // The AI wakes do not depend on Gamma: get their velocities at all the
+    // points in a single pass.
+    wg.getInducedVelocitiesAt(wakePt, wakeVel);
+
+    const std::vector<AeroElement_ptr>& elements = geometry->elements;
+    const std::vector<double>& influenceInv = geometry->influenceInv;
+
     std::vector<double> rhs;
     rhs.resize(nelm, 0.0);
 
     for (int i=0; i<nelm; ++i)
-        rhs[i] = dot(elements[i]->getNormal(),
-                     Te2b.transform(wg.getInducedVelocityAt(collPt[i])));
+        rhs[i] = dot(elements[i]->getNormal(), Te2b.transform(wakeVel[i]));
 
-    for (int i=1; i<=nelm; ++i) {
-        Gamma[i][1] = 0.0;
-        for (int k=1; k<=nelm; ++k)
-            Gamma[i][1] += influenceMtx[i][k]*rhs[k-1];
+    for (int i=0; i<nelm; ++i) {
+        Gamma[i] = 0.0;
+        for (int k=0; k<nelm; ++k)
+            Gamma[i] += influenceInv[i*nelm+k]*rhs[k];
     }
 
+    std::fill(selfVx.begin(), selfVx.end(), 0.0);
+    std::fill(selfVy.begin(), selfVy.end(), 0.0);
+    std::fill(selfVz.begin(), selfVz.end(), 0.0);
+    addInducedVelocities(nelm, mpx.data(), mpy.data(), mpz.data(),
+                         selfVx.data(), selfVy.data(), selfVz.data());
+
     SGVec3d f(0.,0.,0.);
     moment = SGVec3d::zeros();
 
     for (int i=0; i<nelm; ++i) {
-        SGVec3d mp = elements[i]->getBoundVortexMidPoint();
-        SGVec3d v = Te2b.transform(wg.getInducedVelocityAt(midPt[i]));
-        v += getInducedVelocityAt(mp);
+        SGVec3d mp(mpx[i], mpy[i], mpz[i]);
+        SGVec3d v = Te2b.transform(wakeVel[nelm+i]);
+        v += SGVec3d(selfVx[i], selfVy[i], selfVz[i]);
 
         // The minus sign before vel to transform the aircraft velocity from the
         // body frame to wind frame.
-        SGVec3d Fi = rho*Gamma[i+1][1]*cross(v-vel,
-                                             elements[i]->getBoundVortex());
+        SGVec3d Fi = rho*Gamma[i]*cross(v-vel,
+                                        elements[i]->getBoundVortex());
         f += Fi;
         moment += cross(mp, Fi);
     }
@@ -41,6 +41,12 @@ private:
     friend class FGTestApi::PrivateAccessor::FDM::Accessor;
 
     std::vector<SGVec3d> collPt, midPt;
+    // Collocation points followed by bound vortex mid points, in the earth
+    // frame, and the AI wake velocities induced there.
+    std::vector<SGVec3d> wakePt, wakeVel;
+    // Bound vortex mid points in the body frame, and the velocities induced
+    // there by the mesh itself.
+    std::vector<double> mpx, mpy, mpz, selfVx, selfVy, selfVz;
     SGQuatd Te2b;
     SGVec3d moment;
 };
@@ -20,6 +20,9 @@
 //
 // $Id$
 
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <vector>
 #include <cmath>
 
@@ -31,8 +34,56 @@ extern "C" {
 #include "../LaRCsim/ls_matrix.h"
 }
 
-WakeMesh::WakeMesh(double _span, double _chord)
-    : nelm(10), span(_span), chord(_chord)
+// Velocity induced at (px, py, pz) by a horseshoe vortex of unit strength
+// bound between a and b, with its legs trailing to infinity along -x. This
+// is the sum computed by AeroElement::getInducedVelocity(), with the tests
+// for singular points turned into selects so that the loops calling it can
+// be vectorized (see src/FDM/CMakeLists.txt for the flags this requires).
+static inline void horseshoeInducedVel(double ax, double ay, double az,
+                                       double bx, double by, double bz,
+                                       double px, double py, double pz,
+                                       double& vx, double& vy, double& vz)
+{
+    const double inv4Pi = 0.25 / M_PI;
+    const double eps = 1E-6;
+
+    // Semi-infinite legs: cross(r, w) / (4*pi*(|r|^2 - dot(r, w)*|r|)) with
+    // w = (-1, 0, 0).
+    double rax = px - ax, ray = py - ay, raz = pz - az;
+    double raSqr = rax*rax + ray*ray + raz*raz;
+    double da = raSqr + rax*sqrt(raSqr);
+    bool okA = fabs(da) >= eps;
+    double ka = inv4Pi / (okA ? da : 1.0);
+    ka = okA ? ka : 0.0;
+
+    double rbx = px - bx, rby = py - by, rbz = pz - bz;
+    double rbSqr = rbx*rbx + rby*rby + rbz*rbz;
+    double db = rbSqr + rbx*sqrt(rbSqr);
+    bool okB = fabs(db) >= eps;
+    double kb = inv4Pi / (okB ? db : 1.0);
+    kb = okB ? kb : 0.0;
+
+    // Bound segment from a to b.
+    double cx = ray*rbz - raz*rby;
+    double cy = raz*rbx - rax*rbz;
+    double cz = rax*rby - ray*rbx;
+    double cSqr = cx*cx + cy*cy + cz*cz;
+    bool okC = (cSqr >= eps) & (raSqr >= eps) & (rbSqr >= eps);
+    double invRa = 1.0 / sqrt(okC ? raSqr : 1.0);
+    double invRb = 1.0 / sqrt(okC ? rbSqr : 1.0);
+    double proj = (bx - ax)*(rax*invRa - rbx*invRb)
+                + (by - ay)*(ray*invRa - rby*invRb)
+                + (bz - az)*(raz*invRa - rbz*invRb);
+    double kc = proj * inv4Pi / (okC ? cSqr : 1.0);
+    kc = okC ? kc : 0.0;
+
+    vx = kc*cx;
+    vy = kc*cy - ka*raz + kb*rbz;
+    vz = kc*cz + ka*ray - kb*rby;
+}
+
+WakeMeshGeometry::WakeMeshGeometry(int _nelm, double span, double chord)
+    : nelm(_nelm)
 {
     double y1 = -0.5*span;
     double ds = span / nelm;
@@ -46,8 +97,7 @@ WakeMesh::WakeMesh(double _span, double _chord)
         y1 = y2;
     }
 
-    influenceMtx = nr_matrix(1, nelm, 1, nelm);
-    Gamma = nr_matrix(1, nelm, 1, 1);
+    double **influenceMtx = nr_matrix(1, nelm, 1, nelm);
 
     for (int i=0; i < nelm; ++i) {
         SGVec3d normal = elements[i]->getNormal();
@@ -60,22 +110,62 @@ WakeMesh::WakeMesh(double _span, double _chord)
 
     // Compute the inverse matrix with the Gauss-Jordan algorithm
     nr_gaussj(influenceMtx, nelm, 0, 0);
+
+    influenceInv.resize(nelm*nelm);
+    influenceInvRowSum.resize(nelm, 0.0);
+
+    for (int i=0; i < nelm; ++i) {
+        for (int j=0; j < nelm; ++j) {
+            influenceInv[i*nelm+j] = influenceMtx[i+1][j+1];
+            influenceInvRowSum[i] += influenceMtx[i+1][j+1];
+        }
+
+        const SGVec3d& p1 = elements[i]->getBoundVortexStart();
+        const SGVec3d& p2 = elements[i]->getBoundVortexEnd();
+        p1x.push_back(p1[0]); p1y.push_back(p1[1]); p1z.push_back(p1[2]);
+        p2x.push_back(p2[0]); p2y.push_back(p2[1]); p2z.push_back(p2[2]);
+    }
+
+    nr_free_matrix(influenceMtx, 1, nelm, 1, nelm);
 }
 
-WakeMesh::~WakeMesh()
+WakeMeshGeometry_ptr WakeMeshGeometry::get(int nelm, double span,
+                                           double chord)
 {
-    nr_free_matrix(influenceMtx, 1, nelm, 1, nelm);
-    nr_free_matrix(Gamma, 1, nelm, 1, 1);
+    typedef std::tuple<int, double, double> Key;
+    static std::map<Key, WakeMeshGeometry_ptr> cache;
+    static std::mutex cacheMutex;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    Key key(nelm, span, chord);
+    auto it = cache.find(key);
+    if (it != cache.end())
+        return it->second;
+
+    // Drop the geometries no mesh is using anymore before adding a new one.
+    for (auto jt = cache.begin(); jt != cache.end(); ) {
+        if (jt->second.getNumRefs() == 1)
+            jt = cache.erase(jt);
+        else
+            ++jt;
+    }
+
+    WakeMeshGeometry_ptr geometry = new WakeMeshGeometry(nelm, span, chord);
+    cache[key] = geometry;
+    return geometry;
+}
+
+WakeMesh::WakeMesh(double _span, double _chord)
+    : nelm(10), span(_span), chord(_chord),
+      geometry(WakeMeshGeometry::get(nelm, span, chord))
+{
+    Gamma.resize(nelm, 0.0);
 }
 
 double WakeMesh::computeAoA(double vel, double rho, double weight)
 {
-    for (int i=1; i<=nelm; ++i) {
-        Gamma[i][1] = 0.0;
-        for (int k=1; k<=nelm; ++k)
-            Gamma[i][1] -= influenceMtx[i][k];
-        Gamma[i][1] *= vel;
-    }
+    for (int i=0; i<nelm; ++i)
+        Gamma[i] = -vel*geometry->influenceInvRowSum[i];
 
     // Compute the lift only. Velocities in the z direction are discarded
     // because they only produce drag. This include the vertical component
@@ -85,22 +175,59 @@ double WakeMesh::computeAoA(double vel, double rho, double weight)
     SGVec3d v(-vel, 0.0, 0.0);
 
     for (int i=0; i<nelm; ++i)
-        f += rho*Gamma[i+1][1]*cross(v, elements[i]->getBoundVortex());
+        f += rho*Gamma[i]*cross(v, geometry->elements[i]->getBoundVortex());
 
     double sinAlpha = -weight/f[2];
 
-    for (int i=1; i<=nelm; ++i)
-        Gamma[i][1] *= sinAlpha;
+    for (int i=0; i<nelm; ++i)
+        Gamma[i] *= sinAlpha;
 
     return asin(sinAlpha);
 }
 
 SGVec3d WakeMesh::getInducedVelocityAt(const SGVec3d& at) const
 {
-    SGVec3d v(0., 0., 0.);
+    const WakeMeshGeometry& g = *geometry;
+    const double px = at[0], py = at[1], pz = at[2];
+    double sx = 0.0, sy = 0.0, sz = 0.0;
+
+    for (int i=0; i<nelm; ++i) {
+        double vx, vy, vz;
+        horseshoeInducedVel(g.p1x[i], g.p1y[i], g.p1z[i],
+                            g.p2x[i], g.p2y[i], g.p2z[i],
+                            px, py, pz, vx, vy, vz);
+        sx += Gamma[i]*vx;
+        sy += Gamma[i]*vy;
+        sz += Gamma[i]*vz;
+    }
 
-    for (int i=0; i<nelm; ++i)
-        v += Gamma[i+1][1] * elements[i]->getInducedVelocity(at);
+    return SGVec3d(sx, sy, sz);
+}
 
-    return v;
+void WakeMesh::addInducedVelocities(size_t count,
+                                    const double* __restrict x,
+                                    const double* __restrict y,
+                                    const double* __restrict z,
+                                    double* __restrict vx,
+                                    double* __restrict vy,
+                                    double* __restrict vz) const
+{
+    const WakeMeshGeometry& geom = *geometry;
+
+    // Elements in the outer loop, so that the inner one runs over contiguous
+    // points.
+    for (int i=0; i<nelm; ++i) {
+        const double ax = geom.p1x[i], ay = geom.p1y[i], az = geom.p1z[i];
+        const double bx = geom.p2x[i], by = geom.p2y[i], bz = geom.p2z[i];
+        const double g = Gamma[i];
+
+        for (size_t j=0; j<count; ++j) {
+            double ux, uy, uz;
+            horseshoeInducedVel(ax, ay, az, bx, by, bz, x[j], y[j], z[j],
+                                ux, uy, uz);
+            vx[j] += g*ux;
+            vy[j] += g*uy;
+            vz[j] += g*uz;
+        }
+    }
 }
@@ -28,20 +28,49 @@
 namespace FGTestApi { namespace PrivateAccessor { namespace FDM { class Accessor; } } }
 
 
+// Elements and inverse influence matrix of a wake mesh. They only depend on
+// the dimensions of the mesh so they are computed once, and shared by all the
+// meshes with the same number of elements, span and chord.
+class WakeMeshGeometry : public SGReferenced {
+public:
+    WakeMeshGeometry(int _nelm, double span, double chord);
+
+    static SGSharedPtr<const WakeMeshGeometry> get(int nelm, double span,
+                                                   double chord);
+
+    int nelm;
+    std::vector<AeroElement_ptr> elements;
+    // Inverse of the influence matrix, stored row by row, and the sum of each
+    // of its rows.
+    std::vector<double> influenceInv, influenceInvRowSum;
+    // Bound vortex ends of each element, one array per coordinate, for the
+    // Biot-Savart kernels.
+    std::vector<double> p1x, p1y, p1z, p2x, p2y, p2z;
+};
+
+typedef SGSharedPtr<const WakeMeshGeometry> WakeMeshGeometry_ptr;
+
 class WakeMesh : public SGReferenced {
 public:
     WakeMesh(double _span, double _chord);
-    virtual ~WakeMesh();
+    virtual ~WakeMesh() {}
     double computeAoA(double vel, double rho, double weight);
     SGVec3d getInducedVelocityAt(const SGVec3d& at) const;
+    // Batched version of getInducedVelocityAt(): adds the velocity induced at
+    // each of the count points (x[i], y[i], z[i]) to (vx[i], vy[i], vz[i]).
+    void addInducedVelocities(size_t count, const double* x, const double* y,
+                              const double* z, double* vx, double* vy,
+                              double* vz) const;
+    double getSpan(void) const { return span; }
 
 protected:
     friend class FGTestApi::PrivateAccessor::FDM::Accessor;
 
     int nelm;
     double span, chord;
-    std::vector<AeroElement_ptr> elements;
-    double **influenceMtx, **Gamma;
+    WakeMeshGeometry_ptr geometry;
+    // Strength of each element, the only state specific to this mesh.
+    std::vector<double> Gamma;
 };
 
 typedef SGSharedPtr<WakeMesh> WakeMesh_ptr;
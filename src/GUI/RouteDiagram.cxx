@@ -79,8 +79,10 @@ void RouteDiagram::setActiveLegIndex(int activeLegIndex)
     m_activeLegIndex = activeLegIndex;
     emit legIndexChanged(m_activeLegIndex);
 
-    const double halfLegDistance = m_path->distanceForIndex(m_activeLegIndex) * 0.5;
-    m_projectionCenter = m_path->positionForDistanceFrom(m_activeLegIndex, halfLegDistance);
+    FlightPlanRef fp = m_flightplan->flightplan();
+    const RoutePath& path = fp->routePath();
+    const double halfLegDistance = path.distanceForIndex(m_activeLegIndex) * 0.5;
+    m_projectionCenter = path.positionForDistanceFrom(m_activeLegIndex, halfLegDistance);
     recomputeBounds(true);
     update();
 }
@@ -93,10 +95,11 @@ void RouteDiagram::paintContents(QPainter *painter)
     FlightPlanRef fp = m_flightplan->flightplan();
     QVector<QLineF> lines;
     QVector<QLineF> activeLines;
+    const RoutePath& path = fp->routePath();
     for (int l=0; l < fp->numLegs(); ++l) {
         QPointF previous;
         bool isFirst = true;
-        for (auto g : m_path->pathForIndex(l)) {
+        for (auto g : path.pathForIndex(l)) {
             QPointF p = project(g);
             if (isFirst) {
                 isFirst = false;
@@ -122,7 +125,7 @@ void RouteDiagram::paintContents(QPainter *painter)
 void RouteDiagram::doComputeBounds()
 {
     FlightPlanRef fp = m_flightplan->flightplan();
-    const SGGeodVec gv(m_path->pathForIndex(m_activeLegIndex));
+    const SGGeodVec gv(fp->routePath().pathForIndex(m_activeLegIndex));
     std::for_each(gv.begin(), gv.end(), [this](const SGGeod& g)
         {this->extendBounds(this->project(g)); }
     );
@@ -131,10 +134,10 @@ void RouteDiagram::doComputeBounds()
 void RouteDiagram::fpChanged()
 {
     FlightPlanRef fp = m_flightplan->flightplan();
-    m_path.reset(new RoutePath(fp));
     if (fp) {
-        const double halfLegDistance = m_path->distanceForIndex(m_activeLegIndex) * 0.5;
-        m_projectionCenter = m_path->positionForDistanceFrom(m_activeLegIndex, halfLegDistance);
+        const RoutePath& path = fp->routePath();
+        const double halfLegDistance = path.distanceForIndex(m_activeLegIndex) * 0.5;
+        m_projectionCenter = path.positionForDistanceFrom(m_activeLegIndex, halfLegDistance);
     }
     recomputeBounds(true);
     update();
@@ -74,7 +74,6 @@ private:
 
     FlightPlanController* m_flightplan = nullptr;
 
-    std::unique_ptr<RoutePath> m_path;
     int m_activeLegIndex = 0;
 };
 
@@ -383,7 +383,7 @@ void WaypointList::draw( int dx, int dy )
   _arrowWidth = legendFont.getStringWidth(">");
   _latLonFormat = static_cast<simgear::strutils::LatLonFormat>(fgGetInt("/sim/lon-lat-format"));
   
-  RoutePath path(_model->flightplan());
+  const RoutePath& path = _model->flightplan()->routePath();
   
   for ( ; row <= finalRow; ++row, y += rowHeight) {
     drawRow(dx, dy, row, y, path);
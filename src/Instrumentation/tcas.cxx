@@ -120,6 +120,7 @@ using std::string;
 
 #include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
+#include <AIModel/AIManager.hxx>
 #include "instrument_mgr.hxx"
 #include "tcas.hxx"
 
@@ -587,10 +588,11 @@ TCAS::ThreatDetector::update(void)
 
 /** Check if plane's transponder is enabled. */
 bool
-TCAS::ThreatDetector::checkTransponder(const SGPropertyNode* pModel, float velocityKt)
+TCAS::ThreatDetector::checkTransponder(const FGAITrafficSnapshot& traffic, size_t i,
+                                       float velocityKt)
 {
-    const string name = pModel->getName();
-    if (name != "multiplayer" && name != "aircraft")
+    const unsigned flags = traffic.flags(i);
+    if (!(flags & (FGAITrafficSnapshot::FlagMultiplayer|FGAITrafficSnapshot::FlagAircraft)))
     {
         // assume non-MP/non-AI planes (e.g. ships) have no transponder
         return false;
@@ -603,8 +605,8 @@ TCAS::ThreatDetector::checkTransponder(const SGPropertyNode* pModel, float veloc
         return false;
     }
 
-    if ((name == "multiplayer")&&
-        (pModel->getBoolValue("controls/invisible")))
+    if ((flags & FGAITrafficSnapshot::FlagMultiplayer)&&
+        (flags & FGAITrafficSnapshot::FlagInvisible))
     {
         // ignored MP plane: pretend transponder is switched off
         return false;
@@ -615,21 +617,19 @@ TCAS::ThreatDetector::checkTransponder(const SGPropertyNode* pModel, float veloc
 
 /** Check if plane is a threat. */
 int
-TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
+TCAS::ThreatDetector::checkThreat(int mode, const FGAITrafficSnapshot& traffic,
+                                  size_t i)
 {
 #ifdef FEATURE_TCAS_DEBUG_THREAT_DETECTOR
     checkCount++;
 #endif
-    if (!pModel->getBoolValue("valid", true))
-        return ThreatInvisible;
-
-    float velocityKt  = pModel->getDoubleValue("velocities/true-airspeed-kt");
+    float velocityKt  = traffic.speedKt(i);
 
-    if (!checkTransponder(pModel, velocityKt))
+    if (!checkTransponder(traffic, i, velocityKt))
         return ThreatInvisible;
 
     int threatLevel = ThreatNone;
-    float altFt = pModel->getDoubleValue("position/altitude-ft");
+    float altFt = traffic.altitudeFt(i);
     currentThreat.relativeAltitudeFt = altFt - self.pressureAltFt;
 
     // save computation time: don't care when relative altitude is excessive
@@ -637,9 +637,9 @@ TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
         return threatLevel;
 
     // position data of current intruder
-    double lat        = pModel->getDoubleValue("position/latitude-deg");
-    double lon        = pModel->getDoubleValue("position/longitude-deg");
-    float heading     = pModel->getDoubleValue("orientation/true-heading-deg");
+    double lat        = traffic.latitudeDeg(i);
+    double lon        = traffic.longitudeDeg(i);
+    float heading     = traffic.headingDeg(i);
 
     double distanceNm, bearing;
     calcRangeBearing(self.lat, self.lon, lat, lon, distanceNm, bearing);
@@ -648,7 +648,7 @@ TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
     if ((distanceNm > tcas->_lateralRange) || (distanceNm < 0))
         return threatLevel;
 
-    currentThreat.verticalFps = pModel->getDoubleValue("velocities/vertical-speed-fps");
+    currentThreat.verticalFps = traffic.verticalFps(i);
 
     /* Detect proximity targets
      * [TCASII]: "Any target that is less than 6 nmi in range and within +/-1200ft
@@ -669,7 +669,7 @@ TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
 
     if (tcas->tracker.active())
     {
-        currentThreat.callsign = pModel->getStringValue("callsign");
+        currentThreat.callsign = traffic.props(i)->getStringValue("callsign");
         currentThreat.isTracked = tcas->tracker.isTracked(currentThreat.callsign);
     }
     else
@@ -696,14 +696,14 @@ TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
             (currentThreat.verticalTau < 0))
         {
             // do not trigger new alerts when Tau is negative, but keep existing alerts
-            int previousThreatLevel = pModel->getIntValue("tcas/threat-level", 0);
+            int previousThreatLevel = traffic.props(i)->getIntValue("tcas/threat-level", 0);
             if (previousThreatLevel == 0)
                 return threatLevel;
         }
     }
 
 #ifdef FEATURE_TCAS_DEBUG_THREAT_DETECTOR
-    cout << "#" << checkCount << ": " << pModel->getStringValue("callsign") << endl;
+    cout << "#" << checkCount << ": " << traffic.props(i)->getStringValue("callsign") << endl;
 #endif
 
 
@@ -1324,26 +1324,66 @@ TCAS::update(double dt)
         else
 #endif
         {
-            SGPropertyNode* pAi = fgGetNode("/ai/models", true);
+            checkTraffic(mode);
+        }
+        advisoryCoordinator.update(mode);
+    }
+    annunciator.update();
+}
+
+/** Check all aircraft.
+ * Only traffic within lateral range gets the full threat check; everything
+ * else is either out of range (ThreatNone) or has no transponder. */
+void
+TCAS::checkTraffic(int mode)
+{
+    FGAIManager* aiManager = globals->get_subsystem<FGAIManager>();
+    map<SGPropertyNode*, SGPropertyNode_ptr> published;
+    if (aiManager)
+    {
+        const FGAITrafficSnapshot& traffic = aiManager->trafficSnapshot();
+        const SGGeod selfPos = SGGeod::fromDeg(threatDetector.getLongitude(),
+                                               threatDetector.getLatitude());
 
-            // check all aircraft
-            for (int i = pAi->nChildren() - 1; i >= -1; i--)
+        nearbyTraffic.clear();
+        traffic.findInRange(selfPos, _lateralRange * SG_NM_TO_METER, nearbyTraffic);
+        isNearby.assign(traffic.size(), 0);
+        for (size_t i : nearbyTraffic)
+            isNearby[i] = 1;
+
+        for (size_t i = 0; i < traffic.size(); i++)
+        {
+            SGPropertyNode* pModel = traffic.props(i);
+            int threatLevel;
+            if (isNearby[i])
             {
-                SGPropertyNode* pModel = pAi->getChild(i);
-                if ((pModel)&&(pModel->nChildren()))
-                {
-                    int threatLevel = threatDetector.checkThreat(mode, pModel);
-                    /* expose aircraft threat-level (to be used by other instruments,
-                     * i.e. TCAS display) */
-                    if (threatLevel==ThreatRA)
-                        pModel->setIntValue("tcas/ra-sense", -threatDetector.getRASense());
-                    pModel->setIntValue("tcas/threat-level", threatLevel);
-                }
+                threatLevel = threatDetector.checkThreat(mode, traffic, i);
+                if (threatLevel==ThreatRA)
+                    pModel->setIntValue("tcas/ra-sense", -threatDetector.getRASense());
             }
+            else if (threatDetector.checkTransponder(traffic, i, traffic.speedKt(i)))
+                threatLevel = ThreatNone;
+            else
+                threatLevel = ThreatInvisible;
+
+            /* expose aircraft threat-level (to be used by other instruments,
+             * i.e. TCAS display) */
+            pModel->setIntValue("tcas/threat-level", threatLevel);
+            published[pModel] = pModel;
         }
-        advisoryCoordinator.update(mode);
     }
-    annunciator.update();
+
+    /* Models which dropped out of the snapshot were removed (their nodes are
+     * kept, marked invalid): they are invisible, as any invalid model is.
+     * A node already re-used for a new model was published above. */
+    map<SGPropertyNode*, SGPropertyNode_ptr>::const_iterator it;
+    for (it = publishedModels.begin(); it != publishedModels.end(); ++it)
+    {
+        if (published.find(it->first) == published.end())
+            it->second->setIntValue("tcas/threat-level", ThreatInvisible);
+    }
+
+    publishedModels.swap(published);
 }
 
 /** Run a single self-test iteration. */
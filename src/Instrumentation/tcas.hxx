@@ -36,6 +36,7 @@ using std::deque;
 using std::map;
 
 class SGSampleGroup;
+class FGAITrafficSnapshot;
 
 #include <Main/globals.hxx>
 
@@ -316,8 +317,10 @@ class TCAS : public SGSubsystem
         void  init                (void);
         void  update              (void);
 
-        bool  checkTransponder    (const SGPropertyNode* pModel, float velocityKt);
-        int   checkThreat         (int mode, const SGPropertyNode* pModel);
+        bool  checkTransponder    (const FGAITrafficSnapshot& traffic, size_t i,
+                                   float velocityKt);
+        int   checkThreat         (int mode, const FGAITrafficSnapshot& traffic,
+                                   size_t i);
         void  checkVerticalThreat (void);
         void  horizontalThreat    (float bearing, float distanceNm, float heading,
                                    float velocityKt);
@@ -329,6 +332,8 @@ class TCAS : public SGSubsystem
         float getRadarAlt         (void)        { return self.radarAltFt;}
 
         float getVelocityKt       (void)        { return self.velocityKt;}
+        double getLatitude        (void)        { return self.lat;}
+        double getLongitude       (void)        { return self.lon;}
         int   getRASense          (void)        { return currentThreat.RASense;}
 
     private:
@@ -375,8 +380,14 @@ private:
     AdvisoryGenerator   advisoryGenerator;
     Annunciator         annunciator;
 
+    /** AI model nodes a threat level was published to in the last update */
+    map<SGPropertyNode*, SGPropertyNode_ptr> publishedModels;
+    vector<size_t>      nearbyTraffic;
+    vector<char>        isNearby;
+
 private:
     void selfTest       (void);
+    void checkTraffic   (int mode);
 
 public:
     TCAS (SGPropertyNode* node);
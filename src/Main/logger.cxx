@@ -12,17 +12,158 @@
 #include <ios>
 #include <string>
 #include <cstdlib>
+#include <algorithm>
+#include <cstdint>
 
 #include <simgear/debug/logstream.hxx>
 #include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/misc/sg_path.hxx>
+#include <simgear/threads/SGThread.hxx>
+#include <simgear/threads/SGGuard.hxx>
 
 #include "fg_props.hxx"
 #include "globals.hxx"
 #include "util.hxx"
 
 using std::string;
-using std::endl;
+
+// Size at which a filled binary row block is handed to the writer thread.
+static const size_t BINARY_BLOCK_SIZE = 64 * 1024;
+
+// Data the writer thread may fall behind by before the main loop waits.
+static const size_t BINARY_MAX_PENDING = 64 * BINARY_BLOCK_SIZE;
+
+const char FGLogger::BINARY_MAGIC[8] = { 'F', 'G', 'L', 'O', 'G', 'B', 'I', 'N' };
+
+template <typename T>
+static void appendBinary(std::vector<char>& block, const T& value)
+{
+    const char* p = reinterpret_cast<const char*>(&value);
+    block.insert(block.end(), p, p + sizeof(T));
+}
+
+static void appendBinaryString(std::vector<char>& block, const string& value)
+{
+    const uint16_t len = static_cast<uint16_t>(std::min<size_t>(value.size(), 0xffff));
+    appendBinary(block, len);
+    block.insert(block.end(), value.begin(), value.begin() + len);
+}
+
+static FGLogger::ColumnType columnTypeFor(SGPropertyNode* entry, SGPropertyNode* node)
+{
+    const string type = entry->getStringValue("type");
+    if (type == "bool")
+        return FGLogger::COLUMN_BOOL;
+    if (type == "int")
+        return FGLogger::COLUMN_INT;
+    if (type == "float")
+        return FGLogger::COLUMN_FLOAT;
+    if (type == "double")
+        return FGLogger::COLUMN_DOUBLE;
+    if (type == "string")
+        return FGLogger::COLUMN_STRING;
+
+    switch (node->getType()) {
+    case simgear::props::BOOL:
+        return FGLogger::COLUMN_BOOL;
+    case simgear::props::INT:
+    case simgear::props::LONG:
+        return FGLogger::COLUMN_INT;
+    case simgear::props::FLOAT:
+        return FGLogger::COLUMN_FLOAT;
+    case simgear::props::DOUBLE:
+        return FGLogger::COLUMN_DOUBLE;
+    default:
+        return FGLogger::COLUMN_STRING;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Implementation of FGLogger::WriterThread
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Background writer for binary logs.  The main loop fills one block while
+ * this thread writes the previous one out.
+ */
+class FGLogger::WriterThread : public SGThread
+{
+public:
+    explicit WriterThread(std::unique_ptr<sg_ofstream> output)
+        : _output(std::move(output)),
+          _stop(false)
+    {
+    }
+
+    /**
+     * Hand a filled block over to the writer.  On return, block is empty
+     * (but keeps a recycled buffer) and can be refilled straight away.
+     */
+    void submit(std::vector<char>& block)
+    {
+        if (block.empty())
+            return;
+
+        SGGuard<SGMutex> g(_lock);
+        // the writer is far behind (slow disk): wait rather than let the
+        // backlog grow without bound
+        while (_pending.size() >= BINARY_MAX_PENDING)
+            _drained.wait(_lock);
+
+        if (_pending.empty()) {
+            _pending.swap(block);
+        } else {
+            _pending.insert(_pending.end(), block.begin(), block.end());
+        }
+        block.clear();
+        _wake.signal();
+    }
+
+    /**
+     * Write out everything still pending, then terminate the thread.
+     */
+    void stop()
+    {
+        {
+            SGGuard<SGMutex> g(_lock);
+            _stop = true;
+            _wake.signal();
+        }
+        join();
+    }
+
+protected:
+    void run() override
+    {
+        std::vector<char> writing;
+        for (;;) {
+            {
+                SGGuard<SGMutex> g(_lock);
+                while (_pending.empty() && !_stop)
+                    _wake.wait(_lock);
+
+                if (_pending.empty())
+                    break; // stop requested and nothing left to write
+
+                writing.swap(_pending);
+                _drained.signal();
+            }
+
+            _output->write(writing.data(), writing.size());
+            writing.clear();
+        }
+
+        _output->flush();
+    }
+
+private:
+    std::unique_ptr<sg_ofstream> _output;
+    std::vector<char> _pending;
+    SGMutex _lock;
+    SGWaitCondition _wake;
+    SGWaitCondition _drained;
+    bool _stop;
+};
 
 ////////////////////////////////////////////////////////////////////////
 // Implementation of FGLogger
@@ -70,6 +211,18 @@ FGLogger::init ()
       exit(EXIT_FAILURE);
     }
 
+    string format = child->getStringValue("format");
+    if (format.empty()) {
+        format = "csv";
+        child->setStringValue("format", format.c_str());
+    }
+
+    const bool binary = (format == "binary");
+    if (!binary && (format != "csv")) {
+        SG_LOG(SG_GENERAL, SG_WARN, "FGLogger: unknown log format '" << format
+               << "' for " << filename << ", using csv");
+    }
+
     string delimiter = child->getStringValue("delimiter");
     if (delimiter.empty()) {
         delimiter = ",";
@@ -80,7 +233,10 @@ FGLogger::init ()
     log.last_time_ms = globals->get_sim_time_sec() * 1000;
     log.delimiter = delimiter.c_str()[0];
     // Security: use the return value of fgValidatePath()
-    log.output.reset(new sg_ofstream(authorizedPath, std::ios_base::out));
+    std::ios_base::openmode mode = std::ios_base::out;
+    if (binary)
+        mode |= std::ios_base::binary;
+    log.output.reset(new sg_ofstream(authorizedPath, mode));
     if ( !(*log.output) ) {
       SG_LOG(SG_GENERAL, SG_ALERT, "Cannot write log to " << filename);
       _logs.pop_back();
@@ -91,7 +247,7 @@ FGLogger::init ()
     // Process the individual entries (Time is automatic).
     //
     std::vector<SGPropertyNode_ptr> entries = child->getChildren("entry");
-    (*log.output) << "Time";
+    std::vector<string> titles;
     for (unsigned int j = 0; j < entries.size(); j++) {
       SGPropertyNode * entry = entries[j];
 
@@ -109,10 +265,31 @@ FGLogger::init ()
       SGPropertyNode * node =
 	fgGetNode(entry->getStringValue("property"), true);
       log.nodes.push_back(node);
-      (*log.output) << log.delimiter
-		    << entry->getStringValue("title", node->getPath().c_str());
+      log.types.push_back(columnTypeFor(entry, node));
+      titles.push_back(entry->getStringValue("title", node->getPath().c_str()));
+    }
+
+    if (binary) {
+      // the schema header goes through the writer like any other block
+      log.block.reserve(BINARY_BLOCK_SIZE);
+      log.block.insert(log.block.end(), BINARY_MAGIC, BINARY_MAGIC + sizeof(BINARY_MAGIC));
+      appendBinary(log.block, static_cast<uint32_t>(BINARY_VERSION));
+      appendBinary(log.block, static_cast<uint8_t>(log.delimiter));
+      appendBinary(log.block, static_cast<uint32_t>(titles.size()));
+      for (unsigned int j = 0; j < titles.size(); j++) {
+        appendBinary(log.block, static_cast<uint8_t>(log.types[j]));
+        appendBinaryString(log.block, titles[j]);
+      }
+
+      log.writer.reset(new WriterThread(std::move(log.output)));
+      log.writer->start();
+      log.writer->submit(log.block);
+    } else {
+      (*log.output) << "Time";
+      for (unsigned int j = 0; j < titles.size(); j++)
+        (*log.output) << log.delimiter << titles[j];
+      (*log.output) << '\n';
     }
-    (*log.output) << endl;
   }
 }
 
@@ -141,12 +318,7 @@ FGLogger::update (double dt)
     for (unsigned int i = 0; i < _logs.size(); i++) {
         while ((sim_time_ms - _logs[i]->last_time_ms) >= _logs[i]->interval_ms) {
             _logs[i]->last_time_ms += _logs[i]->interval_ms;
-            (*_logs[i]->output) << sim_time_sec;
-            for (unsigned int j = 0; j < _logs[i]->nodes.size(); j++) {
-                (*_logs[i]->output) << _logs[i]->delimiter
-                                    << _logs[i]->nodes[j]->getStringValue();
-            }
-            (*_logs[i]->output) << endl;
+            _logs[i]->writeRow(sim_time_sec);
         }
     }
 }
@@ -164,6 +336,51 @@ FGLogger::Log::Log ()
 {
 }
 
+FGLogger::Log::~Log ()
+{
+    if (writer) {
+        writer->submit(block);
+        writer->stop();
+    }
+}
+
+void
+FGLogger::Log::writeRow (double sim_time_sec)
+{
+    if (!writer) {
+        // no std::endl here: flushing every row means disk I/O every frame
+        (*output) << sim_time_sec;
+        for (unsigned int j = 0; j < nodes.size(); j++)
+            (*output) << delimiter << nodes[j]->getStringValue();
+        (*output) << '\n';
+        return;
+    }
+
+    appendBinary(block, sim_time_sec);
+    for (unsigned int j = 0; j < nodes.size(); j++) {
+        switch (types[j]) {
+        case COLUMN_BOOL:
+            appendBinary(block, static_cast<uint8_t>(nodes[j]->getBoolValue()));
+            break;
+        case COLUMN_INT:
+            appendBinary(block, static_cast<int64_t>(nodes[j]->getLongValue()));
+            break;
+        case COLUMN_FLOAT:
+            appendBinary(block, nodes[j]->getFloatValue());
+            break;
+        case COLUMN_DOUBLE:
+            appendBinary(block, nodes[j]->getDoubleValue());
+            break;
+        case COLUMN_STRING:
+            appendBinaryString(block, nodes[j]->getStringValue());
+            break;
+        }
+    }
+
+    if (block.size() >= BINARY_BLOCK_SIZE)
+        writer->submit(block);
+}
+
 
 // Register the subsystem.
 SGSubsystemMgr::Registrant<FGLogger> registrantFGLogger;
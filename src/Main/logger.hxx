@@ -15,7 +15,25 @@
 #include <simgear/props/props.hxx>
 
 /**
- * Log any property values to any number of CSV files.
+ * Log any property values to any number of CSV or binary files.
+ *
+ * Each /logging/log[n] may set <format> to "csv" (the default) or "binary".
+ * Binary logs are columnar and typed; rows are collected in memory and
+ * written out by a background thread, so the main loop only blocks on disk
+ * I/O when the writer falls several megabytes behind.  The fglog2csv utility turns a binary log back into the CSV output.
+ *
+ * Binary layout (host byte order, no padding):
+ *
+ *   char[8]  magic "FGLOGBIN"
+ *   uint32   version (currently 2)
+ *   uint8    delimiter used when converting to CSV
+ *   uint32   number of columns N (not counting the time column)
+ *   N times: uint8 column type (see FGLogger::ColumnType),
+ *            uint16 title length, title bytes
+ *   rows:    double sim time in seconds, then one value per column:
+ *            bool as uint8, int as int64, float as float,
+ *            double as double,
+ *            string as uint16 length followed by the bytes
  */
 class FGLogger : public SGSubsystem
 {
@@ -30,18 +48,42 @@ public:
     // Subsystem identification.
     static const char* staticSubsystemClassId() { return "logger"; }
 
+    /**
+     * Column types stored in the binary log schema.
+     */
+    enum ColumnType {
+        COLUMN_BOOL = 0,
+        COLUMN_INT = 1,
+        COLUMN_DOUBLE = 2,
+        COLUMN_STRING = 3,
+        COLUMN_FLOAT = 4
+    };
+
+    static const char BINARY_MAGIC[8];
+    static const unsigned int BINARY_VERSION = 2;
+
 private:
+    class WriterThread;
+
     /**
      * A single instance of a log file (the logger can contain many).
      */
     struct Log {
       Log ();
+      ~Log ();
+
+      void writeRow (double sim_time_sec);
 
       std::vector<SGPropertyNode_ptr> nodes;
       std::unique_ptr<sg_ofstream> output;
       long interval_ms;
       double last_time_ms;
       char delimiter;
+
+      // binary mode only
+      std::vector<ColumnType> types;
+      std::vector<char> block;
+      std::unique_ptr<WriterThread> writer;
     };
 
     std::vector< std::unique_ptr<Log> > _logs;
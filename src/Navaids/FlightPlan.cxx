@@ -1634,7 +1634,7 @@ void FlightPlan::rebuildLegData()
 {
   _totalDistance = 0.0;
   double totalDistanceIncludingMissed = 0.0;
-  RoutePath path(this);
+  const RoutePath& path = routePath();
   
   for (unsigned int l=0; l<_legs.size(); ++l) {
     _legs[l]->_courseDeg = path.trackForIndex(l);
@@ -1654,8 +1654,18 @@ void FlightPlan::rebuildLegData()
   
 SGGeod FlightPlan::pointAlongRoute(int aIndex, double aOffsetNm) const
 {
-    RoutePath rp(this);
-    return rp.positionForDistanceFrom(aIndex, aOffsetNm * SG_NM_TO_METER);
+    return routePath().positionForDistanceFrom(aIndex, aOffsetNm * SG_NM_TO_METER);
+}
+
+const RoutePath& FlightPlan::routePath() const
+{
+    if (!_routePath) {
+        _routePath.reset(new RoutePath(this));
+    } else {
+        _routePath->update(this);
+    }
+
+    return *_routePath;
 }
     
 void FlightPlan::lockDelegates()
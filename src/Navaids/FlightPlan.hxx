@@ -24,9 +24,13 @@
 #ifndef FG_FLIGHTPLAN_HXX
 #define FG_FLIGHTPLAN_HXX
 
+#include <memory>
+
 #include <Navaids/route.hxx>
 #include <Airports/airport.hxx>
 
+class RoutePath;
+
 namespace flightgear
 {
 
@@ -307,6 +311,15 @@ public:
    */
   SGGeod pointAlongRoute(int aIndex, double aOffsetNm) const;
 
+  /**
+   * The computed path of this plan: turns, leg tracks and distances.
+   * Built when first asked for and kept for everyone drawing or following
+   * the plan; edits to the legs only recompute the waypoints around them.
+   * The reference stays valid as long as the plan, its contents change
+   * when the legs do.
+   */
+  const RoutePath& routePath() const;
+
   /**
    * Create a WayPoint from a string in the following format:
    *  - simple identifier
@@ -426,6 +439,8 @@ private:
   double _totalDistance;
   void rebuildLegData();
 
+  mutable std::unique_ptr<RoutePath> _routePath;
+
   typedef std::vector<Leg*> LegVec;
   LegVec _legs;
 
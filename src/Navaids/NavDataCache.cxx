@@ -24,6 +24,7 @@
 #include "NavDataCache.hxx"
 
 // std
+#include <atomic>
 #include <cstddef>  // for std::size_t
 #include <map>
 #include <cstring>  // for memcoy
@@ -625,6 +626,9 @@ public:
     airwayEdgesFrom = prepare("SELECT airway, b FROM airway_edge WHERE network=?1 AND a=?2");
     airwayEdgesTo = prepare("SELECT airway, a FROM airway_edge WHERE network=?1 AND b=?2");
     airwayEdges = prepare("SELECT a, b FROM airway_edge WHERE airway=?1");
+    airwayNetworkEdges = prepare("SELECT e.airway, e.a, e.b, pa.lon, pa.lat, pb.lon, pb.lat "
+                                 "FROM airway_edge AS e, positioned AS pa, positioned AS pb "
+                                 "WHERE e.network=?1 AND pa.rowid=e.a AND pb.rowid=e.b");
   }
 
   void writeIntProperty(const string& key, int value)
@@ -905,7 +909,7 @@ public:
 // airways
   sqlite3_stmt_ptr findAirway, findAirwayNet, insertAirwayEdge,
     isPosInAirway, airwayEdgesFrom, airwayEdgesTo,
-    insertAirway, airwayEdges;
+    insertAirway, airwayEdges, airwayNetworkEdges;
   sqlite3_stmt_ptr loadAirway;
 
 // since there's many permutations of ident/name queries, we create
@@ -1176,6 +1180,7 @@ bool NavDataCache::NavDataCachePrivate::areDatFilesModified(
 
 // NavDataCache's static member variables
 static NavDataCache* static_instance = NULL;
+static std::atomic<unsigned int> static_generation(0);
 
 const string NavDataCache::datTypeStr[] = {
     string("apt"),
@@ -1265,12 +1270,14 @@ NavDataCache::~NavDataCache()
 {
   assert(static_instance == this);
   static_instance = NULL;
+  ++static_generation;
   d.reset();
 }
 
 NavDataCache* NavDataCache::createInstance()
 {
     static_instance = new NavDataCache;
+    ++static_generation;
     return static_instance;
 }
 
@@ -1279,6 +1286,11 @@ NavDataCache* NavDataCache::instance()
   return static_instance;
 }
 
+unsigned int NavDataCache::generation()
+{
+  return static_generation;
+}
+
 // Update the lists of dat files used for NavCache freshness checking and
 // rebuilding.
 void NavDataCache::updateListsOfDatFiles() {
@@ -1360,6 +1372,7 @@ NavDataCache::RebuildPhase NavDataCache::rebuild()
     RebuildPhase phase = d->rebuilder->currentPhase();
     if (phase == REBUILD_DONE) {
         d->rebuilder.reset(); // all done!
+        ++static_generation;
     }
     return phase;
 }
@@ -1704,6 +1717,9 @@ void NavDataCache::commitTransaction()
     }
 
     sqlite3_reset(q);
+    if (d->transactionAborted) {
+      ++static_generation; // rolled back
+    }
   }
 }
 
@@ -1718,6 +1734,7 @@ void NavDataCache::abortTransaction()
   }
 
   d->transactionAborted = true;
+  ++static_generation;
 }
 
 FGPositionedRef NavDataCache::loadById(PositionedID rowid)
@@ -2289,6 +2306,7 @@ void NavDataCache::insertEdge(int network, int airwayID, PositionedID from, Posi
     sqlite3_bind_int64(d->insertAirwayEdge, 3, from);
     sqlite3_bind_int64(d->insertAirwayEdge, 4, to);
     d->execInsert(d->insertAirwayEdge);
+    ++static_generation;
 }
 
 bool NavDataCache::isInAirwayNetwork(int network, PositionedID pos)
@@ -2333,6 +2351,28 @@ AirwayEdgeVec NavDataCache::airwayEdgesFrom(int network, PositionedID pos)
   return result;
 }
     
+AirwayNetworkEdgeVec NavDataCache::airwayNetworkEdges(int network)
+{
+  sqlite3_bind_int(d->airwayNetworkEdges, 1, network);
+
+  AirwayNetworkEdgeVec result;
+  sqlite3_stmt_ptr stmt = d->airwayNetworkEdges;
+  while (d->stepSelect(stmt)) {
+    AirwayNetworkEdge e;
+    e.airway = sqlite3_column_int(stmt, 0);
+    e.from = sqlite3_column_int64(stmt, 1);
+    e.to = sqlite3_column_int64(stmt, 2);
+    e.fromPos = SGGeod::fromDeg(sqlite3_column_double(stmt, 3),
+                                sqlite3_column_double(stmt, 4));
+    e.toPos = SGGeod::fromDeg(sqlite3_column_double(stmt, 5),
+                              sqlite3_column_double(stmt, 6));
+    result.push_back(e);
+  }
+
+  d->reset(stmt);
+  return result;
+}
+
 AirwayRef NavDataCache::loadAirway(int airwayID)
 {
     sqlite3_bind_int(d->loadAirway, 1, airwayID);
@@ -48,6 +48,15 @@ typedef std::vector<TypedPositioned> TypedPositionedVec;
 typedef std::pair<int, PositionedID> AirwayEdge;
 typedef std::vector<AirwayEdge> AirwayEdgeVec;
 
+// an airway edge with the positions of both ends, for building a graph
+struct AirwayNetworkEdge
+{
+    int airway;
+    PositionedID from, to;
+    SGGeod fromPos, toPos;
+};
+typedef std::vector<AirwayNetworkEdge> AirwayNetworkEdgeVec;
+
 namespace Octree {
   class Node;
   class Branch;
@@ -67,6 +76,15 @@ public:
 // static creator
     static NavDataCache* createInstance();
 
+    /**
+     * Moves on whenever the contents of the cache may have changed
+     * wholesale: a new instance, a finished rebuild, an inserted airway
+     * edge or a rolled back transaction. Unlike the address of the
+     * instance, a value is never seen again within a run, so it is safe
+     * to key derived data on.
+     */
+    static unsigned int generation();
+
     SGPath path() const;
 
     enum DatFileType {
@@ -291,6 +309,12 @@ public:
    * in an airway
    */
   AirwayEdgeVec airwayEdgesFrom(int network, PositionedID pos);
+
+  /**
+   * retrieve every edge of a network in one go, as stored (one direction
+   * per edge)
+   */
+  AirwayNetworkEdgeVec airwayNetworkEdges(int network);
     
     AirwayRef loadAirway(int airwayID);
     
@@ -24,6 +24,7 @@
 #include <tuple>
 #include <algorithm>
 #include <set>
+#include <unordered_map>
 
 #include <simgear/sg_inlines.h>
 #include <simgear/structure/exception.hxx>
@@ -50,46 +51,295 @@ typedef SGSharedPtr<FGPositioned> FGPositionedRef;
 
 //////////////////////////////////////////////////////////////////////////////
 
-class AStarOpenNode : public SGReferenced
+/**
+ * The airway network held as a compressed adjacency array, so the route
+ * search works on dense indices and flat arrays rather than positioned
+ * IDs, database queries and heap-allocated open nodes.
+ */
+class Airway::Network::Graph
 {
 public:
-  AStarOpenNode(FGPositionedRef aNode, double aLegDist, 
-    int aAirway,
-    FGPositionedRef aDest, AStarOpenNode* aPrev) :
-    node(aNode),
-    previous(aPrev),
-    airway(aAirway)
-  { 
-    distanceFromStart = aLegDist;
-    if (previous) {
-      distanceFromStart +=  previous->distanceFromStart;
-    }
-    
-		directDistanceToDestination = SGGeodesy::distanceM(node->geod(), aDest->geod());
-  }
-  
-  virtual ~AStarOpenNode()
+  Graph(NavDataCache* aCache, int aNetwork);
+
+  int indexOf(PositionedID aId) const
   {
+    auto it = nodeIndex.find(aId);
+    return (it == nodeIndex.end()) ? -1 : it->second;
   }
-  
-  FGPositionedRef node;
-  SGSharedPtr<AStarOpenNode> previous;
-  int airway;
-  double distanceFromStart; // aka 'g(x)'
-  double directDistanceToDestination; // aka 'h(x)'
-  
+
   /**
-	 * aka 'f(x)'
-	 */
-	double totalCost() const {
-		return distanceFromStart + directDistanceToDestination;
-	}
+   * A* from aStart to aDest. On success, aPath receives the node indices
+   * of the route, and aAirways the airway each was reached by (0 for the
+   * start).
+   */
+  bool search(int aStart, int aDest, std::vector<int>& aPath,
+              std::vector<int>& aAirways);
+
+  NavDataCache* cache; ///< the cache the graph was built from
+  unsigned int generation; ///< NavDataCache::generation() at build time
+
+  std::vector<PositionedID> nodeIds;
+  std::vector<SGGeod> nodePos;
+  std::unordered_map<PositionedID, int> nodeIndex;
+
+  // edges leaving node n are [edgeStart[n], edgeStart[n + 1])
+  std::vector<int> edgeStart;
+  std::vector<int> edgeTarget;
+  std::vector<int> edgeAirway;
+  std::vector<double> edgeLengthM;
+
+private:
+  int addNode(PositionedID aId, const SGGeod& aPos);
+
+  double totalCost(int n) const
+  { return distanceFromStart[n] + distanceToDest[n]; }
+
+  void heapPush(int n);
+  int heapPop();
+  void siftUp(int pos);
+  void siftDown(int pos);
+
+  // per-search scratch space, reused between searches. A node's entries
+  // are only valid if its serial matches the current search.
+  unsigned int _serial = 0;
+  std::vector<unsigned int> serial;
+  std::vector<double> distanceFromStart; // aka 'g(x)'
+  std::vector<double> distanceToDest;    // aka 'h(x)'
+  std::vector<int> previous;
+  std::vector<int> airway;
+  std::vector<int> heapIndex;            // -1 once closed
+  std::vector<int> heap;                 // open nodes, by total cost
 };
 
-using AStarOpenNodeRef = SGSharedPtr<AStarOpenNode>;
+Airway::Network::Graph::Graph(NavDataCache* aCache, int aNetwork) :
+  cache(aCache),
+  generation(NavDataCache::generation())
+{
+  const AirwayNetworkEdgeVec edges = cache->airwayNetworkEdges(aNetwork);
+
+  // every edge is traversed in both directions, as airwayEdgesFrom()
+  // reports them
+  std::vector<std::pair<int, int> > ends;
+  ends.reserve(edges.size());
+  std::vector<int> degree;
+  for (const auto& e : edges) {
+    const int a = addNode(e.from, e.fromPos);
+    const int b = addNode(e.to, e.toPos);
+    ends.push_back(std::make_pair(a, b));
+    degree.resize(nodeIds.size(), 0);
+    ++degree[a];
+    ++degree[b];
+  }
+
+  const int nodeCount = static_cast<int>(nodeIds.size());
+  edgeStart.assign(nodeCount + 1, 0);
+  for (int n = 0; n < nodeCount; ++n) {
+    edgeStart[n + 1] = edgeStart[n] + degree[n];
+  }
+
+  const int edgeCount = edgeStart[nodeCount];
+  edgeTarget.resize(edgeCount);
+  edgeAirway.resize(edgeCount);
+  edgeLengthM.resize(edgeCount);
+
+  std::vector<int> fill(edgeStart.begin(), edgeStart.end() - 1);
+  for (size_t i = 0; i < edges.size(); ++i) {
+    const int a = ends[i].first, b = ends[i].second;
+    const double lengthM = SGGeodesy::distanceM(nodePos[a], nodePos[b]);
+
+    int slot = fill[a]++;
+    edgeTarget[slot] = b;
+    edgeAirway[slot] = edges[i].airway;
+    edgeLengthM[slot] = lengthM;
+
+    slot = fill[b]++;
+    edgeTarget[slot] = a;
+    edgeAirway[slot] = edges[i].airway;
+    edgeLengthM[slot] = lengthM;
+  }
+
+  serial.assign(nodeCount, 0);
+  distanceFromStart.resize(nodeCount);
+  distanceToDest.resize(nodeCount);
+  previous.resize(nodeCount);
+  airway.resize(nodeCount);
+  heapIndex.resize(nodeCount);
+  heap.reserve(nodeCount);
+
+  SG_LOG(SG_NAVAID, SG_DEBUG, "airway network " << aNetwork << ": "
+         << nodeCount << " nodes, " << edges.size() << " edges");
+}
+
+int Airway::Network::Graph::addNode(PositionedID aId, const SGGeod& aPos)
+{
+  auto r = nodeIndex.insert(std::make_pair(aId, static_cast<int>(nodeIds.size())));
+  if (r.second) {
+    nodeIds.push_back(aId);
+    nodePos.push_back(aPos);
+  }
+
+  return r.first->second;
+}
+
+void Airway::Network::Graph::heapPush(int n)
+{
+  heapIndex[n] = static_cast<int>(heap.size());
+  heap.push_back(n);
+  siftUp(heapIndex[n]);
+}
+
+int Airway::Network::Graph::heapPop()
+{
+  const int top = heap.front();
+  heapIndex[top] = -1;
+
+  const int last = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    heap[0] = last;
+    heapIndex[last] = 0;
+    siftDown(0);
+  }
+
+  return top;
+}
+
+void Airway::Network::Graph::siftUp(int pos)
+{
+  const int n = heap[pos];
+  const double cost = totalCost(n);
+  while (pos > 0) {
+    const int parent = (pos - 1) / 2;
+    if (totalCost(heap[parent]) <= cost) {
+      break;
+    }
+
+    heap[pos] = heap[parent];
+    heapIndex[heap[pos]] = pos;
+    pos = parent;
+  }
+
+  heap[pos] = n;
+  heapIndex[n] = pos;
+}
+
+void Airway::Network::Graph::siftDown(int pos)
+{
+  const int size = static_cast<int>(heap.size());
+  const int n = heap[pos];
+  const double cost = totalCost(n);
+  for (;;) {
+    int child = 2 * pos + 1;
+    if (child >= size) {
+      break;
+    }
+
+    if ((child + 1 < size) && (totalCost(heap[child + 1]) < totalCost(heap[child]))) {
+      ++child;
+    }
+
+    if (cost <= totalCost(heap[child])) {
+      break;
+    }
+
+    heap[pos] = heap[child];
+    heapIndex[heap[pos]] = pos;
+    pos = child;
+  }
+
+  heap[pos] = n;
+  heapIndex[n] = pos;
+}
+
+bool Airway::Network::Graph::search(int aStart, int aDest,
+                                    std::vector<int>& aPath,
+                                    std::vector<int>& aAirways)
+{
+  if (++_serial == 0) {
+    // wrapped around, forget all previous searches
+    std::fill(serial.begin(), serial.end(), 0);
+    _serial = 1;
+  }
+
+  const SGGeod& destPos = nodePos[aDest];
+  heap.clear();
+
+  serial[aStart] = _serial;
+  distanceFromStart[aStart] = 0.0;
+  distanceToDest[aStart] = SGGeodesy::distanceM(nodePos[aStart], destPos);
+  previous[aStart] = -1;
+  airway[aStart] = 0;
+  heapPush(aStart);
+
+// A* open node iteration
+  while (!heap.empty()) {
+    const int x = heapPop();
+
+#ifdef DEBUG_AWY_SEARCH
+    SG_LOG(SG_NAVAID, SG_INFO, "x:" << nodeIds[x] << ", f(x)=" << totalCost(x));
+#endif
+
+  // check if x is the goal; if so we're done, since there cannot be an open
+  // node with lower f(x) value.
+    if (x == aDest) {
+      aPath.clear();
+      aAirways.clear();
+      for (int n = x; n >= 0; n = previous[n]) {
+        aPath.push_back(n);
+        aAirways.push_back(airway[n]);
+      }
+
+      std::reverse(aPath.begin(), aPath.end());
+      std::reverse(aAirways.begin(), aAirways.end());
+      return true;
+    }
+
+  // adjacent (neighbour) iteration
+    for (int e = edgeStart[x]; e < edgeStart[x + 1]; ++e) {
+      const int y = edgeTarget[e];
+      const double g = distanceFromStart[x] + edgeLengthM[e];
+
+      if (serial[y] != _serial) {
+        // not seen yet, open it
+        serial[y] = _serial;
+        distanceFromStart[y] = g;
+        distanceToDest[y] = SGGeodesy::distanceM(nodePos[y], destPos);
+        previous[y] = x;
+        airway[y] = edgeAirway[e];
+        heapPush(y);
+        continue;
+      }
+
+      if (heapIndex[y] < 0) {
+        continue; // closed, ignore
+      }
+
+      if (g > distanceFromStart[y]) {
+        continue; // worse path, ignore
+      }
+
+      // better path to an open node: its cost can only decrease
+      distanceFromStart[y] = g;
+      previous[y] = x;
+      airway[y] = edgeAirway[e];
+      siftUp(heapIndex[y]);
+    } // of neighbour iteration
+  } // of open node iteration
+
+  return false;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////
 
+Airway::Network::Network()
+{
+}
+
+Airway::Network::~Network()
+{
+}
+
 Airway::Network* Airway::lowLevel()
 {
   static Network* static_lowLevel = nullptr;
@@ -410,6 +660,7 @@ void Airway::Network::addEdge(int aWay, const SGGeod& aStartPos,
   }
   
   NavDataCache::instance()->insertEdge(_networkID, aWay, start->guid(), end->guid());
+  _graph.reset();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -560,126 +811,42 @@ Airway::Network::findNodeByIdent(const std::string& ident, const SGGeod& near) c
 
 /////////////////////////////////////////////////////////////////////////////
 
-typedef vector<AStarOpenNodeRef> OpenNodeHeap;
-
-static void buildWaypoints(AStarOpenNodeRef aNode, WayptVec& aRoute)
+Airway::Network::Graph* Airway::Network::graph()
 {
-// count the route length, and hence pre-size aRoute
-  size_t count = 0;
-  AStarOpenNodeRef n = aNode;
-  for (; n != nullptr; ++count, n = n->previous) {;}
-  aRoute.resize(count);
-  
-// run over the route, creating waypoints
-  for (n = aNode; n; n=n->previous) {
-      // get / create airway to be the owner for this waypoint
-      AirwayRef awy = Airway::loadByCacheId(n->airway);
-      auto wp = new NavaidWaypoint(n->node, awy);
-      if (awy) {
-          wp->setFlag(WPT_VIA);
-      }
-      wp->setFlag(WPT_GENERATED);
-      aRoute[--count] = wp;
+  if (!_graph || (_graph->generation != NavDataCache::generation())) {
+    _graph.reset(new Graph(NavDataCache::instance(), _networkID));
   }
-}
 
-/**
- * Inefficent (linear) helper to find an open node in the heap
- */
-static AStarOpenNodeRef
-findInOpen(const OpenNodeHeap& aHeap, FGPositioned* aPos)
-{
-  for (unsigned int i=0; i<aHeap.size(); ++i) {
-    if (aHeap[i]->node == aPos) {
-      return aHeap[i];
-    }
-  }
-  
-  return nullptr;
+  return _graph.get();
 }
 
-class HeapOrder
-{
-public:
-  bool operator()(AStarOpenNode* a, AStarOpenNode* b)
-  {
-    return a->totalCost() > b->totalCost();
-  }
-};
-
 bool Airway::Network::search2(FGPositionedRef aStart, FGPositionedRef aDest,
   WayptVec& aRoute)
 {  
-  typedef set<PositionedID> ClosedNodeSet;
-  
-  OpenNodeHeap openNodes;
-  ClosedNodeSet closedNodes;
-  HeapOrder ordering;
-  
-  openNodes.push_back(new AStarOpenNode(aStart, 0.0, 0, aDest, nullptr));
-  
-// A* open node iteration
-  while (!openNodes.empty()) {
-    std::pop_heap(openNodes.begin(), openNodes.end(), ordering);
-    AStarOpenNodeRef x = openNodes.back();
-    FGPositioned* xp = x->node;    
-    openNodes.pop_back();
-    closedNodes.insert(xp->guid());
-  
-#ifdef DEBUG_AWY_SEARCH
-    SG_LOG(SG_NAVAID, SG_INFO, "x:" << xp->ident() << ", f(x)=" << x->totalCost());
-#endif
-    
-  // check if xp is the goal; if so we're done, since there cannot be an open
-  // node with lower f(x) value.
-    if (xp == aDest) {
-      buildWaypoints(x, aRoute);
-      return true;
-    }
-    
-  // adjacent (neighbour) iteration
-    NavDataCache* cache = NavDataCache::instance();
-    for (auto other : cache->airwayEdgesFrom(_networkID, xp->guid())) {
-      if (closedNodes.count(other.second)) {
-        continue; // closed, ignore
-      }
+  Graph* g = graph();
+  const int start = g->indexOf(aStart->guid());
+  const int dest = g->indexOf(aDest->guid());
 
-      FGPositioned* yp = cache->loadById(other.second);
-      double edgeDistanceM = SGGeodesy::distanceM(xp->geod(), yp->geod());
-      AStarOpenNodeRef y = findInOpen(openNodes, yp);
-      if (y) { // already open
-        double g = x->distanceFromStart + edgeDistanceM;
-        if (g > y->distanceFromStart) {
-          // worse path, ignore
-#ifdef DEBUG_AWY_SEARCH
-          SG_LOG(SG_NAVAID, SG_INFO, "\tabandoning " << yp->ident() <<
-           " path is worse: g(y)" << y->distanceFromStart << ", g'=" << g);
-#endif
-          continue;
-        }
-        
-      // we need to update y. Unfortunately this means rebuilding the heap,
-      // since y's score can change arbitrarily
-#ifdef DEBUG_AWY_SEARCH
-        SG_LOG(SG_NAVAID, SG_INFO, "\tfixing up previous for new path to " << yp->ident() << ", d =" << g);
-#endif
-        y->previous = x;
-        y->distanceFromStart = g;
-        y->airway = other.first;
-        std::make_heap(openNodes.begin(), openNodes.end(), ordering);
-      } else { // not open, insert a new node for y into the heap
-        y = new AStarOpenNode(yp, edgeDistanceM, other.first, aDest, x);
-#ifdef DEBUG_AWY_SEARCH
-        SG_LOG(SG_NAVAID, SG_INFO, "\ty=" << yp->ident() << ", f(y)=" << y->totalCost());
-#endif
-        openNodes.push_back(y);
-        std::push_heap(openNodes.begin(), openNodes.end(), ordering);
+  std::vector<int> path, airways;
+  if ((start < 0) || (dest < 0) || !g->search(start, dest, path, airways)) {
+    SG_LOG(SG_NAVAID, SG_INFO, "A* failed to find route");
+    return false;
+  }
+
+// run over the route, creating waypoints
+  aRoute.resize(path.size());
+  for (size_t i = 0; i < path.size(); ++i) {
+      // get / create airway to be the owner for this waypoint
+      AirwayRef awy = Airway::loadByCacheId(airways[i]);
+      auto wp = new NavaidWaypoint(g->cache->loadById(g->nodeIds[path[i]]), awy);
+      if (awy) {
+          wp->setFlag(WPT_VIA);
       }
-    } // of neighbour iteration
-  } // of open node iteration
-  
-  SG_LOG(SG_NAVAID, SG_INFO, "A* failed to find route");
-  return false;
+      wp->setFlag(WPT_GENERATED);
+      aRoute[i] = wp;
+  }
+
+  return true;
 }
 
 } // of namespace flightgear
@@ -21,6 +21,7 @@
 #define FG_AIRWAYS_HXX
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <Navaids/route.hxx>
@@ -102,6 +103,8 @@ public:
     friend class Airway;
     friend class InAirwayFilter;
     
+    Network();
+    ~Network();
   
     /**
      * Principal routing algorithm. Attempts to find the best route beween
@@ -158,6 +161,15 @@ public:
     mutable NetworkMembershipDict _inNetworkCache;
     
     Level _networkID;
+
+    /**
+     * the network as an adjacency array with dense node indices, built on
+     * the first search, together with the scratch space of the search
+     */
+    class Graph;
+    std::unique_ptr<Graph> _graph;
+
+    Graph* graph();
   };
 
 
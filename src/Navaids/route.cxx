@@ -87,6 +87,7 @@ void Waypt::setFlag(WayptFlag aFlag, bool aV)
 
   _flags = (_flags & ~aFlag);
   if (aV) _flags |= aFlag;
+  changed();
 }
 
 bool Waypt::matches(Waypt* aOther) const
@@ -114,12 +115,14 @@ void Waypt::setAltitude(double aAlt, RouteRestriction aRestrict)
 {
   _altitudeFt = aAlt;
   _altRestrict = aRestrict;
+  changed();
 }
 
 void Waypt::setSpeed(double aSpeed, RouteRestriction aRestrict)
 {
   _speed = aSpeed;
   _speedRestrict = aRestrict;
+  changed();
 }
 
 double Waypt::speedKts() const
@@ -149,6 +149,15 @@ public:
   { return _flags; }
   
   void setFlag(WayptFlag aFlag, bool aV = true);
+
+  /**
+   * Counter bumped by every change to the waypoint, so users which cache
+   * data derived from it (RoutePath) can tell it was edited in place.
+   * Waypoints are shared between cloned flight plans, and may be changed
+   * through any of them.
+   */
+  unsigned int revision() const
+  { return _revision; }
   
   /**
    * Factory method
@@ -211,6 +220,12 @@ protected:
    */
   virtual void writeToProperties(SGPropertyNode_ptr aProp) const;
   
+  /**
+   * Subclasses call this from their own setters.
+   */
+  void changed()
+  { ++_revision; }
+
   typedef Waypt* (FactoryFunction)(RouteBase* aOwner) ;
   static void registerFactory(const std::string aNodeType, FactoryFunction* aFactory);
   
@@ -227,6 +242,7 @@ private:
 
     const RouteBase* _owner = nullptr;
 	unsigned short _flags = 0;
+    unsigned int _revision = 0;
     mutable double _magVarDeg = 0.0; ///< cached mag var at this location
 };
 
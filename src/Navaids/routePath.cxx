@@ -239,11 +239,19 @@ TurnInfo turnCenterAndAngleFromExit(const SGGeod& pt, double outHeadingDeg,
     return r;
 }
 
+static bool sameGeod(const SGGeod& a, const SGGeod& b)
+{
+    return (a.getLongitudeRad() == b.getLongitudeRad()) &&
+        (a.getLatitudeRad() == b.getLatitudeRad()) &&
+        (a.getElevationM() == b.getElevationM());
+}
+
 class WayptData
 {
 public:
   explicit WayptData(WayptRef w) :
     wpt(w),
+    revision(w->revision()),
     hasEntry(false),
     posValid(false),
     legCourseValid(false),
@@ -585,7 +593,27 @@ public:
       return pointOnEntryTurnFromHeading(legCourseTrue + theta);
   }
   
+  bool sameAs(const WayptData& other) const
+  {
+    return (wpt == other.wpt) && (hasEntry == other.hasEntry) &&
+      (posValid == other.posValid) &&
+      (legCourseValid == other.legCourseValid) &&
+      (skipped == other.skipped) && (flyOver == other.flyOver) &&
+      sameGeod(pos, other.pos) && sameGeod(turnEntryPos, other.turnEntryPos) &&
+      sameGeod(turnExitPos, other.turnExitPos) &&
+      sameGeod(turnEntryCenter, other.turnEntryCenter) &&
+      sameGeod(turnExitCenter, other.turnExitCenter) &&
+      (turnEntryAngle == other.turnEntryAngle) &&
+      (turnExitAngle == other.turnExitAngle) &&
+      (turnRadius == other.turnRadius) &&
+      (legCourseTrue == other.legCourseTrue) &&
+      (pathDistanceM == other.pathDistanceM) &&
+      (turnPathDistanceM == other.turnPathDistanceM) &&
+      (overflightCompensationAngle == other.overflightCompensationAngle);
+  }
+
   WayptRef wpt;
+  unsigned int revision; ///< of wpt, when this data was computed from it
   bool hasEntry, posValid, legCourseValid, skipped;
   SGGeod pos, turnEntryPos, turnExitPos, turnEntryCenter, turnExitCenter;
   double turnEntryAngle, turnExitAngle, turnRadius, legCourseTrue;
@@ -606,6 +634,8 @@ class RoutePath::RoutePathPrivate
 {
 public:
     WayptDataVec waypoints;
+    /// state of each waypoint just before its turn was computed
+    WayptDataVec entryStates;
 
     AircraftPerformance perf;
     bool constrainLegCourses;
@@ -832,6 +862,13 @@ public:
 RoutePath::RoutePath(const flightgear::FlightPlan* fp) :
   d(new RoutePathPrivate)
 {
+    loadWaypoints(fp);
+    commonInit();
+}
+
+void RoutePath::loadWaypoints(const flightgear::FlightPlan* fp)
+{
+    d->waypoints.clear();
     for (int l=0; l<fp->numLegs(); ++l) {
         WayptRef wpt = fp->legAtIndex(l)->waypoint();
         if (!wpt) {
@@ -842,7 +879,6 @@ RoutePath::RoutePath(const flightgear::FlightPlan* fp) :
     }
 
     d->constrainLegCourses = fp->followLegTrackToFixes();
-    commonInit();
 }
 
 
@@ -873,10 +909,19 @@ void RoutePath::commonInit()
     d->waypoints[i].initPass1(d->waypoints[i-1], nextPtr);
   }
 
+  d->entryStates.assign(d->waypoints.begin(), d->waypoints.end());
   for (unsigned int i=0; i<d->waypoints.size(); ++i) {
-      if (d->waypoints[i].skipped) {
-          continue;
-      }
+    computeWaypoint(i);
+  }
+}
+
+void RoutePath::computeWaypoint(int i)
+{
+  // remember where we started from, so an update can resume here
+  d->entryStates[i] = d->waypoints[i];
+  if (d->waypoints[i].skipped) {
+    return;
+  }
 
       double alt = 0.0; // FIXME
       double radiusM = d->perf.turnRadiusMForAltitude(alt);
@@ -908,7 +953,166 @@ void RoutePath::commonInit()
     
     // now turn is computed, can resolve distances
     d->waypoints[i].pathDistanceM = computeDistanceForIndex(i);
-  }
+}
+
+bool RoutePath::update(const flightgear::FlightPlan* fp)
+{
+    if (fp->followLegTrackToFixes() != d->constrainLegCourses) {
+        loadWaypoints(fp);
+        commonInit();
+        return true;
+    }
+
+    // the legs which changed are those between the unchanged head and
+    // tail of the plan
+    auto unchanged = [this, fp](int oldIndex, int newIndex) {
+        const WayptData& w(d->waypoints[oldIndex]);
+        return (w.wpt == fp->legAtIndex(newIndex)->waypoint()) &&
+            (w.revision == w.wpt->revision());
+    };
+
+    const int oldCount = static_cast<int>(d->waypoints.size());
+    const int newCount = fp->numLegs();
+    int head = 0;
+    while ((head < oldCount) && (head < newCount) && unchanged(head, head)) {
+        ++head;
+    }
+
+    if ((head == oldCount) && (head == newCount)) {
+        return false;
+    }
+
+    int tail = 0;
+    while ((tail < oldCount - head) && (tail < newCount - head) &&
+           unchanged(oldCount - 1 - tail, newCount - 1 - tail))
+    {
+        ++tail;
+    }
+
+    if (!updateRange(fp, head, oldCount - head - tail, newCount - head - tail)) {
+        loadWaypoints(fp);
+        commonInit();
+    }
+
+    return true;
+}
+
+bool RoutePath::updateRange(const flightgear::FlightPlan* fp, int index,
+                            int removed, int inserted)
+{
+    WayptDataVec& wps(d->waypoints);
+
+    // Hold on to the old data: waypoints after the edit keep their state
+    // unless the change ripples through to them.
+    wps.erase(wps.begin() + index, wps.begin() + index + removed);
+    d->entryStates.erase(d->entryStates.begin() + index,
+                         d->entryStates.begin() + index + removed);
+    for (int k = 0; k < inserted; ++k) {
+        WayptRef wpt = fp->legAtIndex(index + k)->waypoint();
+        if (!wpt) {
+            return false;
+        }
+
+        wps.insert(wps.begin() + index + k, WayptData(wpt));
+        d->entryStates.insert(d->entryStates.begin() + index + k, WayptData(wpt));
+    }
+
+    const int count = static_cast<int>(wps.size());
+    const int firstUnchanged = index + inserted;
+
+    // Dynamic waypoints depend on more than their neighbours (VNAV
+    // altitudes, the exit of the previous turn, the following fix), so
+    // recompute everything if one of them is involved.
+    auto isDynamic = [&wps](int i) {
+        return wps[i].wpt->flag(WPT_DYNAMIC) &&
+            (wps[i].wpt->type() != "discontinuity");
+    };
+
+    // the turn at the waypoint before the edit changes too
+    int restart = index - 1;
+    while ((restart > 0) && wps[restart].skipped) {
+        --restart;
+    }
+
+    for (int i = std::max(restart, 0); (i < index) && (i < count); ++i) {
+        if (isDynamic(i)) {
+            return false;
+        }
+    }
+
+    int prepared = restart;
+    if (restart >= 0) {
+        wps[restart] = d->entryStates[restart];
+    } else {
+        restart = 0;
+    }
+
+    // previous final state of the waypoints from firstUnchanged on, in case
+    // they end up the same as before
+    WayptDataVec saved;
+    auto prepare = [&](int upTo) {
+        while ((prepared < upTo) && (prepared + 1 < count)) {
+            ++prepared;
+            if (isDynamic(prepared)) {
+                return false;
+            }
+
+            if (prepared >= firstUnchanged) {
+                saved.push_back(wps[prepared]);
+            }
+
+            WayptData& w(wps[prepared]);
+            w = WayptData(w.wpt);
+            w.initPass0();
+            if (prepared > 0) {
+                w.initPass1(wps[prepared - 1], nullptr);
+            }
+        }
+        return true;
+    };
+
+    for (int i = restart; i < count; ++i) {
+        if (!prepare(i + 1)) {
+            return false;
+        }
+
+        int next = i + 1;
+        while ((next < count) && wps[next].skipped) {
+            if (!prepare(++next)) {
+                return false;
+            }
+        }
+
+        computeWaypoint(i);
+
+        if ((i < firstUnchanged) || wps[i].skipped || (next >= count)) {
+            continue;
+        }
+
+        // Once a waypoint comes out as before, and the next one is left in
+        // the state it was in before, the rest of the path is unchanged.
+        if (wps[i].sameAs(saved[i - firstUnchanged]) &&
+            wps[next].sameAs(d->entryStates[next]))
+        {
+            for (int k = i + 1; k <= prepared; ++k) {
+                wps[k] = saved[k - firstUnchanged];
+            }
+
+            // climbs are computed from the distance since the last known
+            // altitude, which may include recomputed legs
+            for (int k = next; k < count; ++k) {
+                if ((wps[k].wpt->type() == "hdgToAlt") &&
+                    !isDescentWaypoint(wps[k - 1].wpt) &&
+                    (d->findPreceedingKnownAltitude(k - 1) < i))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    return true;
 }
 
 SGGeodVec RoutePath::pathForIndex(int index) const
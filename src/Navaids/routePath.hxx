@@ -57,10 +57,30 @@ public:
   
   double distanceBetweenIndices(int from, int to) const;
 
+  /**
+   * Bring the path in line with the current legs of fp, the plan it was
+   * built from.  Only the waypoints around inserted, removed or modified
+   * legs are recomputed; waypoints changed in place are found by their
+   * revision.
+   *
+   * @return false if the path was already up to date
+   */
+  bool update(const flightgear::FlightPlan* fp);
+
 private:
   class RoutePathPrivate;
   
+  void loadWaypoints(const flightgear::FlightPlan* fp);
   void commonInit();
+  void computeWaypoint(int index);
+
+  /**
+   * Replace waypoints [index, index + removed) with the legs
+   * [index, index + inserted) of fp.  Returns false if the change can't be
+   * handled incrementally; the path must then be rebuilt.
+   */
+  bool updateRange(const flightgear::FlightPlan* fp, int index,
+                   int removed, int inserted);
   
   double computeDistanceForIndex(int index) const;
 
@@ -262,28 +262,33 @@ Hold::Hold(RouteBase* aOwner) :
 void Hold::setHoldRadial(double aInboundRadial)
 {
   _bearing = aInboundRadial;
+  changed();
 }
 
 void Hold::setHoldDistance(double aDistanceNm)
 {
   _isDistance = true;
   _holdTD = aDistanceNm;
+  changed();
 }
 
 void Hold::setHoldTime(double aTimeSec)
 {
   _isDistance = false;
   _holdTD = aTimeSec;
+  changed();
 }
 
 void Hold::setRightHanded()
 {
   _righthanded = true;
+  changed();
 }
 
 void Hold::setLeftHanded()
 {
   _righthanded = false;
+  changed();
 }
   
 void Hold::initFromProperties(SGPropertyNode_ptr aProp)
@@ -23,7 +23,14 @@
 #include <cmath>
 
 #include <stdlib.h>
+#include <condition_variable>
+#include <cstdint>
 #include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
 #include "radio.hxx"
 #include <simgear/scene/material/mat.hxx>
 #include <Scenery/scenery.hxx>
@@ -32,6 +39,274 @@
 #include "itm.cpp"
 
 
+/** Outcome of the ITM evaluation of a path, along with the path geometry
+*	the signal calculation needs
+**/
+struct FGRadioTransmission::ITMResult {
+	double transmitter_height = 0.0;
+	double receiver_height = 0.0;
+	double distance_m = 0.0;
+	double first_elevation = 0.0;	// itm_elev[2]
+	double last_elevation = 0.0;	// last point of itm_elev
+	double dbloss = 0.0;
+	double clutter_loss = 0.0;
+	string strmode;
+};
+
+/** Inputs of the ITM model for one path, in the order of the profile:
+*	for transmission types 3 and 4 the profile runs from the receiver
+**/
+struct FGRadioTransmission::ITMPath {
+	std::vector<double> itm_elev;	// [points - 1], [spacing], [elevation 1], ..., [elevation n]
+	std::vector<const string*> materials;
+	double first_height = 0.0;		// antenna height above ground at the start of the profile
+	double second_height = 0.0;
+	double frq_mhz = 0.0;
+	int pol = 1;
+	bool use_clutter = false;
+	ITMResult result;
+};
+
+
+/** Terrain elevation and material, sampled on a grid with the spacing of the
+*	ITM profiles and kept across evaluations: consecutive profiles towards the
+*	same transmitter mostly cross the same cells, each of them otherwise costing
+*	an intersection with the scenery. Only used from the main thread.
+**/
+class FGRadioTransmission::TerrainCache {
+public:
+	static TerrainCache& instance() {
+		static TerrainCache cache;
+		return cache;
+	}
+	
+	/** Elevation and material name of the cell containing pos
+	*	@return: false if the scenery is not loaded there yet
+	**/
+	bool get_elevation_m(const SGGeod& pos, double spacing, double &elevation_m,
+			const string* &material);
+	
+	const string* no_material() const { return _no_material; }
+	
+private:
+	TerrainCache() : _spacing(0.0) { _no_material = material_name("None"); }
+	
+	const string* material_name(const string& name) {
+		return &*_names.insert(name).first;
+	}
+	
+	struct Cell {
+		double elevation_m;
+		const string* material;
+	};
+	
+	/// cells are dropped all at once past this count
+	static const size_t max_cells = 250000;
+	
+	double _spacing;
+	std::unordered_map<std::int64_t, Cell> _cells;
+	std::set<string> _names;	// never shrinks, cells point into it
+	const string* _no_material;
+};
+
+bool FGRadioTransmission::TerrainCache::get_elevation_m(const SGGeod& pos, double spacing,
+		double &elevation_m, const string* &material) {
+	
+	if ((spacing != _spacing) || (_cells.size() > max_cells)) {
+		_cells.clear();
+		_spacing = spacing;
+	}
+	
+	// rows of constant latitude, split in cells about spacing meters wide
+	double cell_deg = spacing / (SG_NM_TO_METER * 60.0);
+	int row = (int)floor(pos.getLatitudeDeg() / cell_deg);
+	double row_lat = (row + 0.5) * cell_deg;
+	double lon_cell_deg = cell_deg / SGMiscd::max(cos(row_lat * SGD_DEGREES_TO_RADIANS), 0.01);
+	int col = (int)floor(pos.getLongitudeDeg() / lon_cell_deg);
+	std::int64_t key = ((std::int64_t)row << 32) | (std::uint32_t)col;
+	
+	auto it = _cells.find(key);
+	if (it != _cells.end()) {
+		elevation_m = it->second.elevation_m;
+		material = it->second.material;
+		return true;
+	}
+	
+	SGGeod center = SGGeod::fromDegM((col + 0.5) * lon_cell_deg, row_lat, SG_MAX_ELEVATION_M);
+	const simgear::BVHMaterial *bvh_material = 0;
+	if (!globals->get_scenery()->get_elevation_m(center, elevation_m, &bvh_material)) {
+		// not cached, the tile may just not be loaded yet
+		return false;
+	}
+	
+	const SGMaterial *mat = dynamic_cast<const SGMaterial*>(bvh_material);
+	material = mat ? material_name(mat->get_names()[0]) : _no_material;
+	
+	Cell cell = { elevation_m, material };
+	_cells[key] = cell;
+	return true;
+}
+
+
+/** Latest ITM result for each transmitter heard recently, and the worker
+*	thread bringing them up to date as the receiver moves.
+**/
+class FGRadioTransmission::PropagationCache {
+public:
+	struct Entry {
+		// what identifies the transmitter and the evaluation parameters
+		SGVec3d tx_cart;
+		double frq_mhz;
+		int transmission_type;
+		int pol;
+		double tx_antenna_height;
+		double rx_antenna_height;
+		bool use_clutter;
+		
+		SGVec3d rx_cart;	// receiver position of the last evaluation
+		ITMResult result;
+		bool pending;		// queued for evaluation on the worker thread
+		unsigned last_used;
+	};
+	typedef std::shared_ptr<Entry> Entry_ptr;
+	
+	static PropagationCache& instance() {
+		static PropagationCache cache;
+		return cache;
+	}
+	
+	~PropagationCache();
+	
+	/** Find the entry for a transmitter within max_distance of tx_cart
+	*	@return: null if there is none
+	**/
+	Entry_ptr find(const Entry &key, double max_distance);
+	
+	void add(const Entry_ptr &entry);
+	
+	/** Copy the latest result of an entry
+	*	@return: true if the receiver moved by more than max_distance since,
+	*	 and no evaluation is pending: the caller should schedule one
+	**/
+	bool get_result(const Entry_ptr &entry, const SGVec3d &rx_cart, double max_distance,
+			ITMResult &result);
+	
+	/// Evaluate path on the worker thread, and store its result in entry
+	void schedule(const Entry_ptr &entry, const SGVec3d &rx_cart,
+			const std::shared_ptr<ITMPath> &path);
+	
+private:
+	PropagationCache() : _stop(false), _counter(0) {}
+	
+	void run();
+	
+	/// least recently used entries are dropped past this count
+	static const size_t max_entries = 64;
+	
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	bool _stop;
+	unsigned _counter;
+	std::vector<Entry_ptr> _entries;
+	std::deque<std::pair<Entry_ptr, std::shared_ptr<ITMPath> > > _queue;
+	std::thread _worker;
+};
+
+FGRadioTransmission::PropagationCache::~PropagationCache() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_wake.notify_all();
+	if (_worker.joinable()) {
+		_worker.join();
+	}
+}
+
+FGRadioTransmission::PropagationCache::Entry_ptr
+FGRadioTransmission::PropagationCache::find(const Entry &key, double max_distance) {
+	
+	std::lock_guard<std::mutex> lock(_mutex);
+	double max_distance_sqr = max_distance * max_distance;
+	for (const Entry_ptr &entry : _entries) {
+		if ((entry->frq_mhz == key.frq_mhz) &&
+				(entry->transmission_type == key.transmission_type) &&
+				(entry->pol == key.pol) &&
+				(entry->tx_antenna_height == key.tx_antenna_height) &&
+				(entry->rx_antenna_height == key.rx_antenna_height) &&
+				(entry->use_clutter == key.use_clutter) &&
+				(distSqr(entry->tx_cart, key.tx_cart) <= max_distance_sqr)) {
+			entry->last_used = ++_counter;
+			return entry;
+		}
+	}
+	
+	return Entry_ptr();
+}
+
+void FGRadioTransmission::PropagationCache::add(const Entry_ptr &entry) {
+	
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_entries.size() >= max_entries) {
+		auto oldest = _entries.begin();
+		for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+			if ((*it)->last_used < (*oldest)->last_used) {
+				oldest = it;
+			}
+		}
+		_entries.erase(oldest);
+	}
+	
+	entry->last_used = ++_counter;
+	_entries.push_back(entry);
+}
+
+bool FGRadioTransmission::PropagationCache::get_result(const Entry_ptr &entry,
+		const SGVec3d &rx_cart, double max_distance, ITMResult &result) {
+	
+	std::lock_guard<std::mutex> lock(_mutex);
+	result = entry->result;
+	return !entry->pending &&
+		(distSqr(entry->rx_cart, rx_cart) > max_distance * max_distance);
+}
+
+void FGRadioTransmission::PropagationCache::schedule(const Entry_ptr &entry,
+		const SGVec3d &rx_cart, const std::shared_ptr<ITMPath> &path) {
+	
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		entry->pending = true;
+		entry->rx_cart = rx_cart;
+		_queue.push_back(std::make_pair(entry, path));
+		if (!_worker.joinable()) {
+			_worker = std::thread(&PropagationCache::run, this);
+		}
+	}
+	_wake.notify_one();
+}
+
+void FGRadioTransmission::PropagationCache::run() {
+	
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_wake.wait(lock, [this] { return _stop || !_queue.empty(); });
+		if (_stop) {
+			return;
+		}
+		
+		auto job = _queue.front();
+		_queue.pop_front();
+		
+		lock.unlock();
+		evaluate_path(*job.second);
+		lock.lock();
+		
+		job.first->result = job.second->result;
+		job.first->pending = false;
+	}
+}
+
+
 FGRadioTransmission::FGRadioTransmission() {
 	
 	
@@ -210,25 +485,10 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 	
 	if((freq < 40.0) || (freq > 20000.0))	// frequency out of recommended range 
 		return -1;
-	/** ITM default parameters 
-		TODO: take them from tile materials (especially for sea)?
-	**/
-	double eps_dielect=15.0;
-	double sgm_conductivity = 0.005;
-	double eno = 301.0;
-	double frq_mhz = freq;
 	
-	int radio_climate = 5;		// continental temperate
-	int pol= _polarization;	
-	double conf = 0.90;	// 90% of situations and time, take into account speed
-	double rel = 0.90;	
+	double frq_mhz = freq;
 	double dbloss;
-	char strmode[150];
-	int p_mode = 0; // propgation mode selector: 0 LOS, 1 diffraction dominant, 2 troposcatter
-	double horizons[2];
-	int errnum;
 	
-	double clutter_loss = 0.0; 	// loss due to vegetation and urban
 	double tx_pow = _transmitter_power;
 	double ant_gain = _rx_antenna_gain + _tx_antenna_gain;
 	double signal = 0.0;
@@ -238,8 +498,6 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 	double signal_strength = tx_pow - _rx_line_losses - _tx_line_losses + ant_gain;	
 	double tx_erp = dbm_to_watt(tx_pow + _tx_antenna_gain - _tx_line_losses);
 	
-
-	FGScenery * scenery = globals->get_scenery();
 	
 	double own_lat = fgGetDouble("/position/latitude-deg");
 	double own_lon = fgGetDouble("/position/longitude-deg");
@@ -248,30 +506,16 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 	double own_alt= own_alt_ft * SG_FEET_TO_METER;
 	
 	
-	
-	
 	SGGeod own_pos = SGGeod::fromDegM( own_lon, own_lat, own_alt );
-	SGGeod max_own_pos = SGGeod::fromDegM( own_lon, own_lat, SG_MAX_ELEVATION_M );
-	SGGeoc center = SGGeoc::fromGeod( max_own_pos );
 	SGGeoc own_pos_c = SGGeoc::fromGeod( own_pos );
 	
-	
-	double sender_alt_ft,sender_alt;
-	double transmitter_height=0.0;
-	double receiver_height=0.0;
 	SGGeod sender_pos = pos;
-	
-	sender_alt_ft = sender_pos.getElevationFt();
-	sender_alt = sender_alt_ft * SG_FEET_TO_METER;
-	SGGeod max_sender_pos = SGGeod::fromGeodM( pos, SG_MAX_ELEVATION_M );
 	SGGeoc sender_pos_c = SGGeoc::fromGeod( sender_pos );
 	
 	
-	double point_distance= _terrain_sampling_distance; 
 	double course = SGGeodesy::courseRad(own_pos_c, sender_pos_c);
 	double reverse_course = SGGeodesy::courseRad(sender_pos_c, own_pos_c);
 	double distance_m = SGGeodesy::distanceM(own_pos, sender_pos);
-	double probe_distance = 0.0;
 	/** If distance larger than this value (300 km), assume reception imposssible to spare CPU cycles */
 	if (distance_m > 300000)
 		return -1.0;
@@ -285,126 +529,54 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 		return signal;
 	}
 	
+	/** The terrain profile and the ITM model only change noticeably once the
+	*	receiver or the transmitter moved, so the last result for the transmitter
+	*	is reused until then, and brought up to date on the worker thread
+	**/
+	double reevaluation_distance = _root_node->getDoubleValue("reevaluation-distance", 500.0);
+	SGVec3d own_cart = SGVec3d::fromGeod(own_pos);
+	
+	PropagationCache &cache = PropagationCache::instance();
+	PropagationCache::Entry key;
+	key.tx_cart = SGVec3d::fromGeod(sender_pos);
+	key.frq_mhz = frq_mhz;
+	key.transmission_type = transmission_type;
+	key.pol = _polarization;
+	key.tx_antenna_height = _tx_antenna_height;
+	key.rx_antenna_height = _rx_antenna_height;
+	key.use_clutter = _root_node->getBoolValue( "use-clutter-attenuation", false );
+	
+	ITMResult result;
+	PropagationCache::Entry_ptr entry = cache.find(key, reevaluation_distance);
+	if (!entry) {
+		// first time this transmitter is heard: the result is needed now
+		ITMPath path;
+		sample_path(own_pos, sender_pos, frq_mhz, course, distance_m, transmission_type, path);
+		evaluate_path(path);
+		result = path.result;
 		
-	int max_points = (int)floor(distance_m / point_distance);
-	//double delta_last = fmod(distance_m, point_distance);
-	
-	deque<double> elevations;
-	deque<string*> materials;
-	
-
-	double elevation_under_pilot = 0.0;
-	if (scenery->get_elevation_m( max_own_pos, elevation_under_pilot, NULL )) {
-		receiver_height = own_alt - elevation_under_pilot; 
+		entry = std::make_shared<PropagationCache::Entry>(key);
+		entry->rx_cart = own_cart;
+		entry->result = result;
+		entry->pending = false;
+		cache.add(entry);
 	}
-
-	double elevation_under_sender = 0.0;
-	if (scenery->get_elevation_m( max_sender_pos, elevation_under_sender, NULL )) {
-		transmitter_height = sender_alt - elevation_under_sender;
+	else if (cache.get_result(entry, own_cart, reevaluation_distance, result)) {
+		std::shared_ptr<ITMPath> path = std::make_shared<ITMPath>();
+		sample_path(own_pos, sender_pos, frq_mhz, course, distance_m, transmission_type, *path);
+		cache.schedule(entry, own_cart, path);
 	}
-	else {
-		transmitter_height = sender_alt;
-	}
-	
 	
-	transmitter_height += _tx_antenna_height;
-	receiver_height += _rx_antenna_height;
+	dbloss = result.dbloss;
+	double clutter_loss = result.clutter_loss;
+	double transmitter_height = result.transmitter_height;
+	double receiver_height = result.receiver_height;
 	
 	//cerr << "ITM:: RX-height: " << receiver_height << " meters, TX-height: " << transmitter_height << " meters, Distance: " << distance_m << " meters" << endl;
 	_root_node->setDoubleValue("station[0]/rx-height", receiver_height);
 	_root_node->setDoubleValue("station[0]/tx-height", transmitter_height);
 	_root_node->setDoubleValue("station[0]/distance", distance_m / 1000);
 	
-	unsigned int e_size = (deque<unsigned>::size_type)max_points;
-	
-	while (elevations.size() <= e_size) {
-		probe_distance += point_distance;
-		SGGeod probe = SGGeod::fromGeoc(center.advanceRadM( course, probe_distance ));
-		const simgear::BVHMaterial *material = 0;
-		double elevation_m = 0.0;
-	
-		if (scenery->get_elevation_m( probe, elevation_m, &material )) {
-                        const SGMaterial *mat;
-                        mat = dynamic_cast<const SGMaterial*>(material);
-			if((transmission_type == 3) || (transmission_type == 4)) {
-				elevations.push_back(elevation_m);
-				if(mat) {
-					const std::vector<string> mat_names = mat->get_names();
-					string* name = new string(mat_names[0]);
-					materials.push_back(name);
-				}
-				else {
-					string* no_material = new string("None"); 
-					materials.push_back(no_material);
-				}
-			}
-			else {
-				 elevations.push_front(elevation_m);
-				 if(mat) {
-				 	 const std::vector<string> mat_names = mat->get_names();
-				 	 string* name = new string(mat_names[0]);
-				 	 materials.push_front(name);
-				}
-				else {
-					string* no_material = new string("None"); 
-					materials.push_front(no_material);
-				}
-			}
-		}
-		else {
-			if((transmission_type == 3) || (transmission_type == 4)) {
-				elevations.push_back(0.0);
-				string* no_material = new string("None"); 
-				materials.push_back(no_material);
-			}
-			else {
-				string* no_material = new string("None"); 
-				elevations.push_front(0.0);
-				materials.push_front(no_material);
-			}
-		}
-	}
-	if((transmission_type == 3) || (transmission_type == 4)) {
-		elevations.push_front(elevation_under_pilot);
-		//if (delta_last > (point_distance / 2) )			// only add last point if it's farther than half point_distance
-			elevations.push_back(elevation_under_sender);
-	}
-	else {
-		elevations.push_back(elevation_under_pilot);
-		//if (delta_last > (point_distance / 2) )
-			elevations.push_front(elevation_under_sender);
-	}
-	
-	
-	double num_points= (double)elevations.size();
-
-
-	elevations.push_front(point_distance);
-	elevations.push_front(num_points -1);
-
-	int size = elevations.size();
-    std::vector<double> itm_elev(size);
-
-	for(int i=0;i<size;i++) {
-		itm_elev[i]=elevations[i];
-	}
-	
-	if((transmission_type == 3) || (transmission_type == 4)) {
-		// the sender and receiver roles are switched
-		ITM::point_to_point(itm_elev.data(), receiver_height, transmitter_height,
-			eps_dielect, sgm_conductivity, eno, frq_mhz, radio_climate,
-			pol, conf, rel, dbloss, strmode, p_mode, horizons, errnum);
-		if( _root_node->getBoolValue( "use-clutter-attenuation", false ) )
-			calculate_clutter_loss(frq_mhz, itm_elev.data(), materials, receiver_height, transmitter_height, p_mode, horizons, clutter_loss);
-	}
-	else {
-		ITM::point_to_point(itm_elev.data(), transmitter_height, receiver_height,
-			eps_dielect, sgm_conductivity, eno, frq_mhz, radio_climate,
-			pol, conf, rel, dbloss, strmode, p_mode, horizons, errnum);
-		if( _root_node->getBoolValue( "use-clutter-attenuation", false ) )
-			calculate_clutter_loss(frq_mhz, itm_elev.data(), materials, transmitter_height, receiver_height, p_mode, horizons, clutter_loss);
-	}
-	
 	double pol_loss = 0.0;
 	// TODO: remove this check after we check a bit the axis calculations in this function
 	if (_polarization == 1) {
@@ -415,7 +587,7 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 	//cerr << "ITM:: Link budget: " << link_budget << ", Attenuation: " << dbloss << " dBm, " << strmode << ", Error: " << errnum << endl;
 	_root_node->setDoubleValue("station[0]/link-budget", link_budget);
 	_root_node->setDoubleValue("station[0]/terrain-attenuation", dbloss);
-	_root_node->setStringValue("station[0]/prop-mode", strmode);
+	_root_node->setStringValue("station[0]/prop-mode", result.strmode);
 	_root_node->setDoubleValue("station[0]/clutter-attenuation", clutter_loss);
 	_root_node->setDoubleValue("station[0]/polarization-attenuation", pol_loss);
 	//if (errnum == 4)	// if parameters are outside sane values for lrprop, bail out fast
@@ -427,7 +599,7 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 	double sender_heading = 270.0; // due West
 	double tx_antenna_bearing = sender_heading - reverse_course * SGD_RADIANS_TO_DEGREES;
 	double rx_antenna_bearing = own_heading - course * SGD_RADIANS_TO_DEGREES;
-	double rx_elev_angle = atan((itm_elev[2] + transmitter_height - itm_elev[(int)itm_elev[0] + 2] + receiver_height) / distance_m) * SGD_RADIANS_TO_DEGREES;
+	double rx_elev_angle = atan((result.first_elevation + transmitter_height - result.last_elevation + receiver_height) / distance_m) * SGD_RADIANS_TO_DEGREES;
 	double tx_elev_angle = 0.0 - rx_elev_angle;
 	if (_root_node->getBoolValue("use-tx-antenna-pattern", false)) {
 		FGRadioAntenna* TX_antenna;
@@ -456,19 +628,163 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 
 	//_root_node->setDoubleValue("station[0]/tx-pattern-gain", tx_pattern_gain);
 	//_root_node->setDoubleValue("station[0]/rx-pattern-gain", rx_pattern_gain);
+	
+	return signal;
 
-	for (unsigned i =0; i < materials.size(); i++) {
-		delete materials[i];
+}
+
+
+void FGRadioTransmission::sample_path(const SGGeod &own_pos, const SGGeod &sender_pos,
+	double freq, double course, double distance_m, int transmission_type, ITMPath &path) {
+	
+	FGScenery * scenery = globals->get_scenery();
+	TerrainCache &terrain = TerrainCache::instance();
+	
+	double own_alt = own_pos.getElevationM();
+	SGGeod max_own_pos = SGGeod::fromGeodM( own_pos, SG_MAX_ELEVATION_M );
+	SGGeoc center = SGGeoc::fromGeod( max_own_pos );
+	
+	double sender_alt = sender_pos.getElevationM();
+	SGGeod max_sender_pos = SGGeod::fromGeodM( sender_pos, SG_MAX_ELEVATION_M );
+	
+	double transmitter_height=0.0;
+	double receiver_height=0.0;
+	double point_distance= _terrain_sampling_distance; 
+	double probe_distance = 0.0;
+	bool reversed = (transmission_type == 3) || (transmission_type == 4);
+	
+	int max_points = (int)floor(distance_m / point_distance);
+	//double delta_last = fmod(distance_m, point_distance);
+	
+	deque<double> elevations;
+	deque<const string*> materials;
+	
+
+	// the end points are not taken from the grid, the antenna heights depend on them
+	double elevation_under_pilot = 0.0;
+	if (scenery->get_elevation_m( max_own_pos, elevation_under_pilot, NULL )) {
+		receiver_height = own_alt - elevation_under_pilot; 
+	}
+
+	double elevation_under_sender = 0.0;
+	if (scenery->get_elevation_m( max_sender_pos, elevation_under_sender, NULL )) {
+		transmitter_height = sender_alt - elevation_under_sender;
+	}
+	else {
+		transmitter_height = sender_alt;
 	}
 	
-	return signal;
+	
+	transmitter_height += _tx_antenna_height;
+	receiver_height += _rx_antenna_height;
+	
+	unsigned int e_size = (deque<unsigned>::size_type)max_points;
+	
+	while (elevations.size() <= e_size) {
+		probe_distance += point_distance;
+		SGGeod probe = SGGeod::fromGeoc(center.advanceRadM( course, probe_distance ));
+		const string *material = 0;
+		double elevation_m = 0.0;
+		
+		if (!terrain.get_elevation_m( probe, point_distance, elevation_m, material )) {
+			elevation_m = 0.0;
+			material = terrain.no_material();
+		}
+		
+		if (reversed) {
+			elevations.push_back(elevation_m);
+			materials.push_back(material);
+		}
+		else {
+			elevations.push_front(elevation_m);
+			materials.push_front(material);
+		}
+	}
+	if (reversed) {
+		elevations.push_front(elevation_under_pilot);
+		//if (delta_last > (point_distance / 2) )			// only add last point if it's farther than half point_distance
+			elevations.push_back(elevation_under_sender);
+	}
+	else {
+		elevations.push_back(elevation_under_pilot);
+		//if (delta_last > (point_distance / 2) )
+			elevations.push_front(elevation_under_sender);
+	}
+	
+	
+	double num_points= (double)elevations.size();
 
+
+	elevations.push_front(point_distance);
+	elevations.push_front(num_points -1);
+
+	path.itm_elev.assign(elevations.begin(), elevations.end());
+	path.materials.assign(materials.begin(), materials.end());
+	
+	if (reversed) {
+		// the sender and receiver roles are switched
+		path.first_height = receiver_height;
+		path.second_height = transmitter_height;
+	}
+	else {
+		path.first_height = transmitter_height;
+		path.second_height = receiver_height;
+	}
+	path.frq_mhz = freq;
+	path.pol = _polarization;
+	path.use_clutter = _root_node->getBoolValue( "use-clutter-attenuation", false );
+	
+	path.result.transmitter_height = transmitter_height;
+	path.result.receiver_height = receiver_height;
+	path.result.distance_m = distance_m;
+	path.result.first_elevation = path.itm_elev[2];
+	path.result.last_elevation = path.itm_elev[(int)path.itm_elev[0] + 2];
+}
+
+
+void FGRadioTransmission::evaluate_path(ITMPath &path) {
+	
+	/** ITM default parameters 
+		TODO: take them from tile materials (especially for sea)?
+	**/
+	double eps_dielect=15.0;
+	double sgm_conductivity = 0.005;
+	double eno = 301.0;
+	
+	int radio_climate = 5;		// continental temperate
+	double conf = 0.90;	// 90% of situations and time, take into account speed
+	double rel = 0.90;	
+	double dbloss = 0.0;
+	char strmode[150];
+	int p_mode = 0; // propgation mode selector: 0 LOS, 1 diffraction dominant, 2 troposcatter
+	double horizons[2];
+	int errnum;
+	double clutter_loss = 0.0; 	// loss due to vegetation and urban
+	
+	{
+		// the ITM code keeps state in static variables
+		static std::mutex itm_mutex;
+		std::lock_guard<std::mutex> lock(itm_mutex);
+		ITM::point_to_point(path.itm_elev.data(), path.first_height, path.second_height,
+			eps_dielect, sgm_conductivity, eno, path.frq_mhz, radio_climate,
+			path.pol, conf, rel, dbloss, strmode, p_mode, horizons, errnum);
+	}
+	
+	if (path.use_clutter) {
+		calculate_clutter_loss(path.frq_mhz, path.itm_elev.data(), path.materials,
+			path.first_height, path.second_height, p_mode, horizons, clutter_loss);
+	}
+	
+	path.result.dbloss = dbloss;
+	path.result.clutter_loss = clutter_loss;
+	path.result.strmode = strmode;
 }
 
 
-void FGRadioTransmission::calculate_clutter_loss(double freq, double itm_elev[], deque<string*> &materials,
+void FGRadioTransmission::calculate_clutter_loss(double freq, const double itm_elev[],
+	const std::vector<const string*> &materials,
 	double transmitter_height, double receiver_height, int p_mode,
-	double horizons[], double &clutter_loss) {
+	const double horizons[], double &clutter_loss) {
 	
 	double distance_m = itm_elev[0] * itm_elev[1]; // only consider elevation points
 	unsigned mat_size = materials.size();
@@ -804,7 +1120,7 @@ void FGRadioTransmission::calculate_clutter_loss(double freq, double itm_elev[],
 }
 
 
-void FGRadioTransmission::get_material_properties(string* mat_name, double &height, double &density) {
+void FGRadioTransmission::get_material_properties(const string* mat_name, double &height, double &density) {
 	
 	if(!mat_name)
 		return;
@@ -24,6 +24,8 @@
 #include <simgear/compiler.h>
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <deque>
+#include <string>
+#include <vector>
 #include <Main/fg_props.hxx>
 
 #include <simgear/math/sg_geodesy.hxx>
@@ -53,9 +55,32 @@ private:
 	int _propagation_model; /// 0 none, 1 round Earth, 2 ITM
 	double polarization_loss();
 	
+	/// ITM evaluation of a transmitter - receiver path, see radio.cxx
+	struct ITMResult;
+	struct ITMPath;
+	class TerrainCache;
+	class PropagationCache;
+	
+/*** Sample the terrain profile between the receiver and the transmitter
+*	 from the cached elevation grid, for evaluate_path()
+*	@param: receiver and transmitter positions, frequency, course and distance between them, transmission type, path to fill
+*	@return: none
+***/
+	void sample_path(const SGGeod &own_pos, const SGGeod &sender_pos, double freq,
+			double course, double distance_m, int transmission_type, ITMPath &path);
+	
+/*** Run the ITM model and the clutter loss calculation on a sampled path.
+*	 Only touches the path, so the propagation worker thread can run it
+*	@param: sampled path, receiving the results
+*	@return: none
+***/
+	static void evaluate_path(ITMPath &path);
+	
 	
 /***  Implement radio attenuation		
 *	  based on the Longley-Rice propagation model
+*	  Results are cached per transmitter, and evaluated again on a worker thread
+*	  once the receiver has moved more than /sim/radio/reevaluation-distance meters
 *	ground_to_air: 0 for air to ground 1 for ground to air, 2 for air to air, 3 for pilot to ground, 4 for pilot to air
 *	@param: transmitter position, frequency, flag to indicate if the transmission is from a ground station
 *	@return: signal level above receiver treshhold sensitivity
@@ -74,15 +99,16 @@ private:
 *	@param: frequency, elevation data, terrain type, horizon distances, calculated loss
 *	@return: none
 ***/
-	void calculate_clutter_loss(double freq, double itm_elev[], std::deque<string*> &materials,
+	static void calculate_clutter_loss(double freq, const double itm_elev[],
+			const std::vector<const string*> &materials,
 			double transmitter_height, double receiver_height, int p_mode,
-			double horizons[], double &clutter_loss);
+			const double horizons[], double &clutter_loss);
 	
 /*** 	Temporary material properties database
 *		@param: terrain type, median clutter height, radiowave attenuation factor
 *		@return: none
 ***/
-	void get_material_properties(string* mat_name, double &height, double &density);
+	static void get_material_properties(const string* mat_name, double &height, double &density);
 	
 	
 public:
@@ -59,6 +59,8 @@
 
 #include "scenery.hxx"
 #include "terrain_stg.hxx"
+#include "terrainquery.hxx"
+#include "terrainraster.hxx"
 
 #ifdef ENABLE_GDAL
 #include "terrain_pgt.hxx"
@@ -408,6 +410,11 @@ void FGScenery::init() {
     }
     _terrain->init( terrain_branch.get() );
 
+    _terrainQuery.reset(new FGTerrainQuery(this));
+    _terrainQuery->init();
+    _terrainRaster.reset(new FGTerrainRaster(_terrainQuery.get()));
+    _terrainRaster->init();
+
     _listener = new ScenerySwitchListener(this);
     _textureCacheListener = new TextureCacheListener();
     // Toggle the setup flag.
@@ -417,10 +424,16 @@ void FGScenery::init() {
 void FGScenery::reinit()
 {
     _terrain->reinit();
+    if (_terrainQuery)
+        _terrainQuery->clearCache();
+    if (_terrainRaster)
+        _terrainRaster->clear();
 }
 
 void FGScenery::shutdown()
 {
+    _terrainRaster.reset();
+    _terrainQuery.reset();
     _terrain->shutdown();
     
     scene_graph = NULL;
@@ -438,6 +451,10 @@ void FGScenery::shutdown()
 void FGScenery::update(double dt)
 {    
     _terrain->update(dt);
+    if (_terrainQuery)
+        _terrainQuery->update(dt);
+    if (_terrainRaster)
+        _terrainRaster->update(dt);
 }
 
 void FGScenery::bind() {
@@ -486,6 +503,8 @@ bool FGScenery::schedule_scenery(const SGGeod& position, double range_m, double
 void FGScenery::materialLibChanged()
 {
     _terrain->materialLibChanged();
+    if (_terrainQuery)
+        _terrainQuery->clearCache();
 }
 
 static osg::ref_ptr<SceneryPager> pager;
@@ -29,6 +29,8 @@
 # error This library requires C++
 #endif
 
+#include <memory>
+
 #include <osg/ref_ptr>
 #include <osg/Switch>
 
@@ -45,6 +47,8 @@ class BVHMaterial;
 }
 
 class FGTerrain;
+class FGTerrainQuery;
+class FGTerrainRaster;
 
 // Define a structure containing global scenery parameters
 class FGScenery : public SGSubsystem
@@ -141,6 +145,14 @@ public:
 
     flightgear::SceneryPager* getPager() { return _pager.get(); }
 
+    /// Cached and batched elevation queries, for callers which can live
+    /// with a few metres of quantisation or a result in a later frame.
+    FGTerrainQuery* get_terrain_query() const { return _terrainQuery.get(); }
+
+    /// Elevation rasters per tile, built through the terrain query service
+    /// on first use.
+    FGTerrainRaster* get_terrain_raster() const { return _terrainRaster.get(); }
+
     // tile mgr api
     bool schedule_scenery(const SGGeod& position, double range_m, double duration=0.0);
     void materialLibChanged();
@@ -148,6 +160,9 @@ private:
     // the terrain engine
     FGTerrain* _terrain;
 
+    std::unique_ptr<FGTerrainQuery> _terrainQuery;
+    std::unique_ptr<FGTerrainRaster> _terrainRaster;
+
     // The state of the scene graph.
     bool _inited;
 };
@@ -0,0 +1,263 @@
+// terrainquery.cxx -- batched and cached terrain elevation queries
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <config.h>
+
+#include <cmath>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+#include <Main/fg_props.hxx>
+
+#include "scenery.hxx"
+#include "terrainquery.hxx"
+
+// one degree of latitude
+static const double METERS_PER_DEGREE = 60.0 * SG_NM_TO_METER;
+
+FGTerrainQuery::FGTerrainQuery(FGScenery* scenery) :
+    _scenery(scenery)
+{
+}
+
+FGTerrainQuery::~FGTerrainQuery()
+{
+    shutdown();
+}
+
+void FGTerrainQuery::init()
+{
+    SGPropertyNode* root = fgGetNode("/sim/terrain-query", true);
+    _resolutionNode = root->getChild("cache-resolution-m", 0, true);
+    _maxAgeNode = root->getChild("cache-max-age-sec", 0, true);
+    _maxEntriesNode = root->getChild("cache-max-entries", 0, true);
+    _maxTimeNode = root->getChild("max-time-ms", 0, true);
+    _hitsNode = root->getChild("cache-hits", 0, true);
+    _missesNode = root->getChild("cache-misses", 0, true);
+    _pendingNode = root->getChild("pending-points", 0, true);
+
+    if (!_resolutionNode->hasValue())
+        _resolutionNode->setDoubleValue(5.0);
+    if (!_maxAgeNode->hasValue())
+        _maxAgeNode->setDoubleValue(10.0);
+    if (!_maxEntriesNode->hasValue())
+        _maxEntriesNode->setIntValue(20000);
+    if (!_maxTimeNode->hasValue())
+        _maxTimeNode->setDoubleValue(2.0);
+    _hits = 0;
+    _misses = 0;
+    _hitsNode->setIntValue(0);
+    _missesNode->setIntValue(0);
+    _pendingNode->setIntValue(0);
+
+    _cellDeg = SGMiscd::max(_resolutionNode->getDoubleValue(), 0.1)
+        / METERS_PER_DEGREE;
+    clearCache();
+}
+
+void FGTerrainQuery::shutdown()
+{
+    std::deque<Batch> pending;
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        pending.swap(_pending);
+        for (auto& batch : _background)
+            pending.push_back(std::move(batch));
+        _background.clear();
+    }
+
+    // results of points not evaluated yet are left invalid
+    for (auto& batch : pending) {
+        batch.results.resize(batch.points.size());
+        batch.promise.set_value(std::move(batch.results));
+    }
+
+    clearCache();
+}
+
+void FGTerrainQuery::update(double dt)
+{
+    _time += dt;
+
+    const double cellDeg = SGMiscd::max(_resolutionNode->getDoubleValue(), 0.1)
+        / METERS_PER_DEGREE;
+    if (cellDeg != _cellDeg) {
+        _cellDeg = cellDeg;
+        clearCache();
+    }
+
+    if (_cache.size() > static_cast<size_t>(_maxEntriesNode->getIntValue())) {
+        const double maxAge = _maxAgeNode->getDoubleValue();
+        for (auto it = _cache.begin(); it != _cache.end(); ) {
+            if (_time - it->second.time > maxAge) {
+                it = _cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // still too many: all recent, so start over
+        if (_cache.size() > static_cast<size_t>(_maxEntriesNode->getIntValue())) {
+            _cache.clear();
+        }
+    }
+
+    const double maxSecs = _maxTimeNode->getDoubleValue() * 0.001;
+    const SGTimeStamp start = SGTimeStamp::now();
+    size_t pendingPoints = 0;
+
+    runBatches(_pending, start, maxSecs);
+    runBatches(_background, start, maxSecs);
+
+    std::lock_guard<std::mutex> lock(_pendingMutex);
+    for (const auto& batch : _pending)
+        pendingPoints += batch.points.size() - batch.next;
+    for (const auto& batch : _background)
+        pendingPoints += batch.points.size() - batch.next;
+
+    _pendingNode->setIntValue(static_cast<int>(pendingPoints));
+    _hitsNode->setIntValue(_hits);
+    _missesNode->setIntValue(_misses);
+}
+
+void FGTerrainQuery::runBatches(std::deque<Batch>& queue,
+                                const SGTimeStamp& start, double maxSecs)
+{
+    bool first = true;
+    std::unique_lock<std::mutex> lock(_pendingMutex);
+    while (!queue.empty()) {
+        Batch& batch = queue.front();
+        lock.unlock();
+
+        while (batch.next < batch.points.size()) {
+            if (!first && (SGTimeStamp::now() - start).toSecs() >= maxSecs)
+                break;
+
+            const SGGeod& point = batch.points[batch.next];
+            batch.results[batch.next] = batch.background ? probe(point)
+                                                         : lookup(point);
+            ++batch.next;
+            first = false;
+        }
+
+        lock.lock();
+        if (batch.next < batch.points.size())
+            return; // out of time
+
+        batch.promise.set_value(std::move(batch.results));
+        queue.pop_front();
+    }
+}
+
+bool FGTerrainQuery::get_elevation_m(const SGGeod& geod, double& alt,
+                                     const simgear::BVHMaterial** material)
+{
+    const Result result = lookup(geod);
+    if (!result.valid)
+        return false;
+
+    alt = result.elevationM;
+    if (material)
+        *material = result.material;
+    return true;
+}
+
+void FGTerrainQuery::get_elevations_m(const std::vector<SGGeod>& points,
+                                      ResultList& results)
+{
+    results.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+        results[i] = lookup(points[i]);
+}
+
+std::future<FGTerrainQuery::ResultList>
+FGTerrainQuery::query(std::vector<SGGeod> points, bool background)
+{
+    Batch batch;
+    batch.results.resize(points.size());
+    batch.points = std::move(points);
+    batch.background = background;
+    std::future<ResultList> result = batch.promise.get_future();
+
+    std::lock_guard<std::mutex> lock(_pendingMutex);
+    if (background) {
+        _background.push_back(std::move(batch));
+    } else {
+        _pending.push_back(std::move(batch));
+    }
+    return result;
+}
+
+void FGTerrainQuery::clearCache()
+{
+    _cache.clear();
+}
+
+FGTerrainQuery::CellKey FGTerrainQuery::cellKey(const SGGeod& geod) const
+{
+    const CellKey lat = static_cast<CellKey>(
+        floor((geod.getLatitudeDeg() + 90.0) / _cellDeg));
+    const CellKey lon = static_cast<CellKey>(
+        floor((geod.getLongitudeDeg() + 180.0) / _cellDeg));
+    return (lat << 32) | (lon & 0xffffffff);
+}
+
+FGTerrainQuery::Result FGTerrainQuery::lookup(const SGGeod& geod)
+{
+    Result result;
+    const double startM = geod.getElevationM();
+    const CellKey key = cellKey(geod);
+
+    // A hit found from higher up is also the first surface below any start
+    // altitude between it and the hit; from further up there might be
+    // something else in between (a bridge, an overhang), so probe again.
+    auto it = _cache.find(key);
+    if ((it != _cache.end()) &&
+        (_time - it->second.time <= _maxAgeNode->getDoubleValue()) &&
+        (startM <= it->second.startM) && (startM >= it->second.elevationM)) {
+        ++_hits;
+        result.valid = true;
+        result.elevationM = it->second.elevationM;
+        result.material = it->second.material.get();
+        return result;
+    }
+
+    ++_misses;
+    result = probe(geod);
+    if (!result.valid) {
+        // no scenery (yet): not cached, the tile may be loaded any moment
+        return result;
+    }
+
+    CacheEntry& entry = _cache[key];
+    entry.startM = startM;
+    entry.elevationM = result.elevationM;
+    entry.material = result.material;
+    entry.time = _time;
+    return result;
+}
+
+FGTerrainQuery::Result FGTerrainQuery::probe(const SGGeod& geod)
+{
+    Result result;
+    const simgear::BVHMaterial* material = nullptr;
+    if (_scenery->get_elevation_m(geod, result.elevationM, &material)) {
+        result.valid = true;
+        result.material = material;
+    }
+    return result;
+}
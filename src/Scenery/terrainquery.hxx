@@ -0,0 +1,169 @@
+// terrainquery.hxx -- batched and cached terrain elevation queries
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef _TERRAINQUERY_HXX
+#define _TERRAINQUERY_HXX
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/bvh/BVHMaterial.hxx>
+#include <simgear/math/SGMath.hxx>
+#include <simgear/props/props.hxx>
+#include <simgear/structure/SGSharedPtr.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+class FGScenery;
+
+/**
+ * Terrain elevation queries on behalf of FGScenery.
+ *
+ * Every FGScenery::get_elevation_m() call is a ray intersection through
+ * the terrain scene graph.  Callers which probe the same area over and
+ * over (AI ground handling, ridge lift) or which need many points but not
+ * right now (the terrain sampler) go through this service instead:
+ *
+ * - get_elevation_m() answers from a small cache quantised to
+ *   /sim/terrain-query/cache-resolution-m, and only intersects the scene
+ *   graph on a miss;
+ * - query() takes a batch of points and returns a future.  Pending batches
+ *   are worked off in FGScenery::update(), limited to
+ *   /sim/terrain-query/max-time-ms per frame, so a large batch is spread
+ *   over several frames instead of causing a stutter.  Background
+ *   batches (the terrain rasters) wait behind all others and are not
+ *   cached.
+ *
+ * The scene graph is modified by the database pager on the main thread,
+ * so all intersections run there; query() may be called from any thread.
+ */
+class FGTerrainQuery
+{
+public:
+    struct Result
+    {
+        bool valid = false;
+        double elevationM = 0.0;
+        /// owned by the terrain tile, only valid as long as it is loaded
+        const simgear::BVHMaterial* material = nullptr;
+    };
+    typedef std::vector<Result> ResultList;
+
+    explicit FGTerrainQuery(FGScenery* scenery);
+    virtual ~FGTerrainQuery();
+
+    void init();
+    void shutdown();
+
+    /**
+     * Run pending batches, within the per-frame time budget.  At least one
+     * point is evaluated per call, so every batch eventually completes.
+     */
+    void update(double dt);
+
+    /**
+     * Like FGScenery::get_elevation_m(), but answered from the cache when a
+     * point in the same cell was probed recently from a start altitude no
+     * lower than the hit.
+     */
+    bool get_elevation_m(const SGGeod& geod, double& alt,
+                         const simgear::BVHMaterial** material);
+
+    /**
+     * Evaluate a batch of points now, through the cache.
+     */
+    void get_elevations_m(const std::vector<SGGeod>& points,
+                          ResultList& results);
+
+    /**
+     * Queue a batch of points.  The future becomes ready during a later
+     * FGScenery::update(); batches are completed in submission order.
+     * When the scenery shuts down first, all remaining points are reported
+     * invalid.
+     *
+     * Background batches are for bulk sampling of points which are not
+     * probed again: they bypass the cache, and only get the time left
+     * after all other batches (but at least one point per frame).
+     */
+    std::future<ResultList> query(std::vector<SGGeod> points,
+                                  bool background = false);
+
+    /**
+     * Drop all cached elevations, e.g. after the scenery was reloaded.
+     */
+    void clearCache();
+
+protected:
+    /**
+     * Intersect the scene graph, uncached.
+     */
+    virtual Result probe(const SGGeod& geod);
+
+private:
+    typedef std::int64_t CellKey;
+
+    struct CacheEntry
+    {
+        double startM;    ///< altitude the hit was found from
+        double elevationM;
+        SGSharedPtr<const simgear::BVHMaterial> material;
+        double time;      ///< sim time of the probe
+    };
+
+    struct Batch
+    {
+        std::vector<SGGeod> points;
+        ResultList results;
+        size_t next = 0;
+        bool background = false;
+        std::promise<ResultList> promise;
+    };
+
+    CellKey cellKey(const SGGeod& geod) const;
+    Result lookup(const SGGeod& geod);
+
+    /**
+     * Work off batches of the queue until the time is up, but evaluate at
+     * least one point of it however little time is left.
+     */
+    void runBatches(std::deque<Batch>& queue, const SGTimeStamp& start,
+                    double maxSecs);
+
+    FGScenery* _scenery;
+
+    std::mutex _pendingMutex;
+    std::deque<Batch> _pending;
+    std::deque<Batch> _background;
+
+    std::unordered_map<CellKey, CacheEntry> _cache;
+    double _time = 0.0;
+    double _cellDeg = 0.0;
+    int _hits = 0;
+    int _misses = 0;
+
+    SGPropertyNode_ptr _resolutionNode;
+    SGPropertyNode_ptr _maxAgeNode;
+    SGPropertyNode_ptr _maxEntriesNode;
+    SGPropertyNode_ptr _maxTimeNode;
+    SGPropertyNode_ptr _hitsNode;
+    SGPropertyNode_ptr _missesNode;
+    SGPropertyNode_ptr _pendingNode;
+};
+
+#endif // _TERRAINQUERY_HXX
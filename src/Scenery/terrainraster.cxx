@@ -0,0 +1,173 @@
+// terrainraster.cxx -- tile aligned terrain elevation rasters
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <config.h>
+
+#include <chrono>
+#include <cmath>
+
+#include <simgear/debug/logstream.hxx>
+
+#include <Main/fg_props.hxx>
+
+#include "terrainraster.hxx"
+
+// start altitude of the post probes, above any terrain
+static const double PROBE_ALTITUDE_M = 10000.0;
+
+// delay before asking again for a raster over terrain not loaded yet
+static const double RETRY_DELAY_SEC = 5.0;
+
+FGTerrainRaster::FGTerrainRaster(FGTerrainQuery* query) :
+    _query(query)
+{
+}
+
+FGTerrainRaster::~FGTerrainRaster()
+{
+}
+
+void FGTerrainRaster::init()
+{
+    SGPropertyNode* root = fgGetNode("/sim/terrain-raster", true);
+    _postsNode = root->getChild("posts", 0, true);
+    _maxAgeNode = root->getChild("max-age-sec", 0, true);
+    _rastersNode = root->getChild("rasters", 0, true);
+    _pendingNode = root->getChild("pending-rasters", 0, true);
+
+    // about 110m between posts north to south
+    if (!_postsNode->hasValue())
+        _postsNode->setIntValue(129);
+    if (!_maxAgeNode->hasValue())
+        _maxAgeNode->setDoubleValue(120.0);
+
+    _posts = SGMisc<int>::max(_postsNode->getIntValue(), 2);
+    clear();
+}
+
+void FGTerrainRaster::update(double dt)
+{
+    _time += dt;
+
+    const double maxAge = _maxAgeNode->getDoubleValue();
+    int pending = 0;
+    for (auto it = _rasters.begin(); it != _rasters.end(); ) {
+        Raster& raster = it->second;
+        if (raster.pending.valid() &&
+            raster.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            receive(raster);
+        }
+
+        if (raster.pending.valid()) {
+            ++pending;
+        } else if (_time - raster.lastUsed > maxAge) {
+            it = _rasters.erase(it);
+            continue;
+        }
+        ++it;
+    }
+
+    _rastersNode->setIntValue(static_cast<int>(_rasters.size()));
+    _pendingNode->setIntValue(pending);
+}
+
+bool FGTerrainRaster::get_elevation_m(const SGGeod& geod, double& alt)
+{
+    const SGBucket bucket(geod);
+    if (!bucket.isValid())
+        return false;
+
+    Raster& raster = _rasters[bucket.gen_index()];
+    raster.lastUsed = _time;
+    if (raster.elevationM.empty()) {
+        if (!raster.pending.valid() && (_time >= raster.retryTime)) {
+            raster.bucket = bucket;
+            request(raster);
+        }
+        return false;
+    }
+
+    const double x = SGMiscd::clip((geod.getLongitudeDeg() - raster.minLonDeg)
+                                   / raster.lonStepDeg, 0.0, _posts - 1);
+    const double y = SGMiscd::clip((geod.getLatitudeDeg() - raster.minLatDeg)
+                                   / raster.latStepDeg, 0.0, _posts - 1);
+    const int col = SGMisc<int>::min(static_cast<int>(x), _posts - 2);
+    const int row = SGMisc<int>::min(static_cast<int>(y), _posts - 2);
+    const double fx = x - col;
+    const double fy = y - row;
+
+    const float* south = &raster.elevationM[row * _posts + col];
+    const float* north = south + _posts;
+    const double s = south[0] + (south[1] - south[0]) * fx;
+    const double n = north[0] + (north[1] - north[0]) * fx;
+    alt = s + (n - s) * fy;
+    return true;
+}
+
+void FGTerrainRaster::clear()
+{
+    // pending batches are still worked off by the query service, their
+    // results are dropped with the futures
+    _rasters.clear();
+}
+
+void FGTerrainRaster::request(Raster& raster)
+{
+    if (!_query)
+        return;
+
+    const SGBucket& b = raster.bucket;
+    raster.minLatDeg = b.get_center_lat() - 0.5 * b.get_height();
+    raster.minLonDeg = b.get_center_lon() - 0.5 * b.get_width();
+    raster.latStepDeg = b.get_height() / (_posts - 1);
+    raster.lonStepDeg = b.get_width() / (_posts - 1);
+
+    std::vector<SGGeod> points;
+    points.reserve(_posts * _posts);
+    for (int row = 0; row < _posts; ++row) {
+        for (int col = 0; col < _posts; ++col) {
+            points.push_back(SGGeod::fromDegM(
+                raster.minLonDeg + col * raster.lonStepDeg,
+                raster.minLatDeg + row * raster.latStepDeg,
+                PROBE_ALTITUDE_M));
+        }
+    }
+
+    raster.pending = _query->query(std::move(points), true);
+}
+
+void FGTerrainRaster::receive(Raster& raster)
+{
+    const FGTerrainQuery::ResultList results = raster.pending.get();
+    raster.pending = std::future<FGTerrainQuery::ResultList>();
+
+    std::vector<float> elevations(results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].valid) {
+            // part of the tile is not loaded (yet)
+            raster.retryTime = _time + RETRY_DELAY_SEC;
+            return;
+        }
+        elevations[i] = static_cast<float>(results[i].elevationM);
+    }
+
+    if (elevations.size() != static_cast<size_t>(_posts * _posts))
+        return;
+
+    raster.elevationM.swap(elevations);
+    SG_LOG(SG_TERRAIN, SG_DEBUG, "Terrain raster of tile "
+           << raster.bucket.gen_index_str() << " complete");
+}
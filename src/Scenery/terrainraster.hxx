@@ -0,0 +1,98 @@
+// terrainraster.hxx -- tile aligned terrain elevation rasters
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef _TERRAINRASTER_HXX
+#define _TERRAINRASTER_HXX
+
+#include <future>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/bucket/newbucket.hxx>
+#include <simgear/math/SGMath.hxx>
+#include <simgear/props/props.hxx>
+
+#include "terrainquery.hxx"
+
+/**
+ * Terrain elevation on a regular grid of posts per scenery tile, for
+ * callers which look at the shape of the terrain around many points, like
+ * ridge lift: once the raster of a tile is built, an elevation is a
+ * bilinear interpolation between four posts instead of an intersection
+ * with the scene graph.
+ *
+ * Rasters are built lazily: the first lookup in a tile queues its posts
+ * as a background FGTerrainQuery::query(), so they are probed uncached in
+ * the time left over by interactive queries, and the lookup fails until
+ * the raster is complete.  Posts over terrain which is not loaded yet make
+ * the raster be requested again a little later.  Rasters not used for
+ * /sim/terrain-raster/max-age-sec are dropped.
+ */
+class FGTerrainRaster
+{
+public:
+    explicit FGTerrainRaster(FGTerrainQuery* query);
+    ~FGTerrainRaster();
+
+    void init();
+
+    /**
+     * Pick up finished rasters and drop unused ones.
+     */
+    void update(double dt);
+
+    /**
+     * Terrain elevation at the given position, interpolated from the
+     * raster of its tile.
+     *
+     * @return false if the raster of the tile is not built yet
+     */
+    bool get_elevation_m(const SGGeod& geod, double& alt);
+
+    /**
+     * Drop all rasters, e.g. after the scenery was reloaded.
+     */
+    void clear();
+
+private:
+    struct Raster
+    {
+        SGBucket bucket;
+        double minLatDeg = 0.0;
+        double minLonDeg = 0.0;
+        double latStepDeg = 1.0;
+        double lonStepDeg = 1.0;
+        std::vector<float> elevationM; ///< posts, row by row from south
+        std::future<FGTerrainQuery::ResultList> pending;
+        double lastUsed = 0.0;
+        double retryTime = 0.0;
+    };
+
+    void request(Raster& raster);
+    void receive(Raster& raster);
+
+    FGTerrainQuery* _query;
+    std::unordered_map<long, Raster> _rasters;
+    double _time = 0.0;
+    int _posts = 0;
+
+    SGPropertyNode_ptr _postsNode;
+    SGPropertyNode_ptr _maxAgeNode;
+    SGPropertyNode_ptr _rastersNode;
+    SGPropertyNode_ptr _pendingNode;
+};
+
+#endif // _TERRAINRASTER_HXX
@@ -54,11 +54,26 @@ void TileCache::entry_free( long tile_index ) {
     SG_LOG( SG_TERRAIN, SG_DEBUG, "FREEING CACHE ENTRY = " << tile_index );
     TileEntry *tile = tile_cache[tile_index];
     tile->removeFromSceneGraph();
-    tile_cache.erase( tile_index );
+    clear_entry( tile_index );
     delete tile;
 }
 
 
+void TileCache::index_tile( long tile_index, const TileEntry* e ) {
+    if ( e->is_current_view() ) {
+        current_view_tiles.insert( tile_index );
+    } else {
+        drop_index.insert( make_drop_key( tile_index, e ) );
+    }
+}
+
+
+void TileCache::unindex_tile( long tile_index, const TileEntry* e ) {
+    drop_index.erase( make_drop_key( tile_index, e ) );
+    current_view_tiles.erase( tile_index );
+}
+
+
 // Initialize the tile cache subsystem
 void TileCache::init( void ) {
     SG_LOG( SG_TERRAIN, SG_INFO, "Initializing the tile cache." );
@@ -86,60 +101,37 @@ bool TileCache::exists( const SGBucket& b ) const {
 // Return the index of a tile to be dropped from the cache, return -1 if
 // nothing available to be removed.
 long TileCache::get_drop_tile() {
-    long min_index = -1;
-    double min_time = DBL_MAX;
-    float priority = FLT_MAX;
-
-    tile_map_iterator current = tile_cache.begin();
-    tile_map_iterator end = tile_cache.end();
-
-    for ( ; current != end; ++current ) {
-        long index = current->first;
-        TileEntry *e = current->second;
-        if (( !e->is_current_view() )&&
-            ( e->is_expired(current_time) ))
-        {
-            if (e->is_expired(current_time - 1.0)&&
-                !e->is_loaded())
-            {
-                /* Immediately drop "empty" tiles which are no longer used/requested, and were last requested > 1 second ago...
-                 * Allow a 1 second timeout since an empty tiles may just be loaded...
-                 */
-                SG_LOG( SG_TERRAIN, SG_DEBUG, "    dropping an unused and empty tile");
-                min_index = index;
-                break;
-            }
-            if (( e->get_time_expired() < min_time )||
-                (( e->get_time_expired() == min_time)&&
-                 ( priority > e->get_priority())))
-            {
-                // drop oldest tile with lowest priority
-                min_time = e->get_time_expired();
-                priority = e->get_priority();
-                min_index = index;
-            }
+    std::set<long>::const_iterator it = unloaded_tiles.begin();
+    for ( ; it != unloaded_tiles.end(); ++it ) {
+        TileEntry *e = get_tile( *it );
+        if ( e->is_expired(current_time - 1.0) && !e->is_loaded() ) {
+            /* Immediately drop "empty" tiles which are no longer used/requested, and were last requested > 1 second ago...
+             * Allow a 1 second timeout since an empty tiles may just be loaded...
+             */
+            SG_LOG( SG_TERRAIN, SG_DEBUG, "    dropping an unused and empty tile");
+            return *it;
         }
     }
 
+    // drop oldest tile with lowest priority
+    long min_index = get_first_expired_tile();
+
     SG_LOG( SG_TERRAIN, SG_DEBUG, "    index = " << min_index );
-    SG_LOG( SG_TERRAIN, SG_DEBUG, "    min_time = " << min_time );
 
     return min_index;
 }
 
 long TileCache::get_first_expired_tile() const
 {
-  const_tile_map_iterator current = tile_cache.begin();
-  const_tile_map_iterator end = tile_cache.end();
-  
-  for ( ; current != end; ++current ) {
-    TileEntry *e = current->second;
-    if (!e->is_current_view() && e->is_expired(current_time))
-    {
-      return current->first;
-    }
+  if ( drop_index.empty() ) {
+    return -1;
   }
-  
+
+  const drop_key& first = *drop_index.begin();
+  if ( current_time > std::get<0>(first) ) {
+    return std::get<2>(first);
+  }
+
   return -1; // no expired tile found
 }
 
@@ -147,23 +139,28 @@ long TileCache::get_first_expired_tile() const
 // Clear all flags indicating tiles belonging to the current view
 void TileCache::clear_current_view()
 {
-    tile_map_iterator current = tile_cache.begin();
-    tile_map_iterator end = tile_cache.end();
-
-    for ( ; current != end; ++current ) {
-        TileEntry *e = current->second;
-        if (e->is_current_view())
-        {
-            // update expiry time for tiles belonging to most recent position
-            e->update_time_expired( current_time );
-            e->set_current_view( false );
-        }
+    std::set<long>::const_iterator it = current_view_tiles.begin();
+    for ( ; it != current_view_tiles.end(); ++it ) {
+        TileEntry *e = get_tile( *it );
+        // update expiry time for tiles belonging to most recent position
+        e->update_time_expired( current_time );
+        e->set_current_view( false );
+        drop_index.insert( make_drop_key( *it, e ) );
     }
+
+    current_view_tiles.clear();
 }
 
 // Clear a cache entry, note that the cache only holds pointers
 // and this does not free the object which is pointed to.
 void TileCache::clear_entry( long tile_index ) {
+    const_tile_map_iterator it = tile_cache.find( tile_index );
+    if ( it == tile_cache.end() ) {
+        return;
+    }
+
+    unindex_tile( tile_index, it->second );
+    unloaded_tiles.erase( tile_index );
     tile_cache.erase( tile_index );
 }
 
@@ -196,6 +193,10 @@ bool TileCache::insert_tile( TileEntry *e ) {
     long tile_index = e->get_tile_bucket().gen_index();
     tile_cache[tile_index] = e;
     e->update_time_expired(current_time);
+    index_tile( tile_index, e );
+    if ( !e->is_loaded() ) {
+        unloaded_tiles.insert( tile_index );
+    }
 
     return true;
 }
@@ -206,6 +207,9 @@ void TileCache::request_tile(TileEntry* t,float priority,bool current_view,doubl
     if ((!current_view)&&(request_time<=0.0))
         return;
 
+    long tile_index = t->get_tile_bucket().gen_index();
+    unindex_tile( tile_index, t );
+
     // update priority when higher - or old request has expired
     if ((t->is_expired(current_time))||
          (priority > t->get_priority()))
@@ -222,4 +226,6 @@ void TileCache::request_tile(TileEntry* t,float priority,bool current_view,doubl
     {
         t->update_time_expired( current_time+request_time );
     }
+
+    index_tile( tile_index, t );
 }
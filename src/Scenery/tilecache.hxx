@@ -25,6 +25,8 @@
 #define _TILECACHE_HXX
 
 #include <map>
+#include <set>
+#include <tuple>
 
 #include <simgear/bucket/newbucket.hxx>
 #include "tileentry.hxx"
@@ -49,6 +51,26 @@ private:
 
     double current_time;
 
+    // Tiles outside the current view, in the order they should be dropped:
+    // earliest expiry time first, then lowest priority.  Entries must be
+    // removed before the expiry time or priority of a tile changes.
+    typedef std::tuple<double, float, long> drop_key;
+    std::set<drop_key> drop_index;
+
+    // Tiles in the current view, to be reset by clear_current_view()
+    std::set<long> current_view_tiles;
+
+    // Tiles not known to be loaded yet
+    std::set<long> unloaded_tiles;
+
+    static drop_key make_drop_key( long tile_index, const TileEntry* e ) {
+        return drop_key( e->get_time_expired(), e->get_priority(), tile_index );
+    }
+
+    // Add a tile to, or remove it from, drop_index or current_view_tiles
+    void index_tile( long tile_index, const TileEntry* e );
+    void unindex_tile( long tile_index, const TileEntry* e );
+
     // Free a tile cache entry
     void entry_free( long cache_index );
 
@@ -128,6 +150,13 @@ public:
 
     // update tile's priority and expiry time according to current request
     void request_tile(TileEntry* t,float priority,bool current_view,double requesttime);
+
+    // Tiles inserted since the last call to set_loaded() for them; the
+    // tiles which are not in this set are loaded.
+    const std::set<long>& get_unloaded_tiles() const { return unloaded_tiles; }
+
+    // Record that a tile finished loading
+    void set_loaded( long tile_index ) { unloaded_tiles.erase( tile_index ); }
 };
 
 #endif // _TILECACHE_HXX
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <vector>
 
 #include <boost/lexical_cast.hpp>
 
@@ -122,8 +123,10 @@ FGTileMgr::FGTileMgr():
     _disableNasalHooks(fgGetNode("/sim/temp/disable-scenery-nasal", true)),
     _scenery_loaded(fgGetNode("/sim/sceneryloaded", true)),
     _scenery_override(fgGetNode("/sim/sceneryloaded-override", true)),
+    _tilesScanned(fgGetNode("/sim/tile-cache/tiles-scanned", true)),
     _pager(FGScenery::getPagerSingleton()),
-    _enableCache(true)
+    _enableCache(true),
+    _prepared_visibility(-1.0)
 {
 }
 
@@ -357,45 +360,58 @@ void FGTileMgr::update_queues(bool& isDownloadingScenery)
         = globals->get_renderer()->getViewer()->getFrameStamp();
     double current_time = framestamp->getReferenceTime();
     double vis = _visibilityMeters->getDoubleValue();
-    TileEntry *e;
     int loading=0;
-    int sz=0;
+    int sz = (int)tile_cache.get_size();
+    int scanned = 0;
     
     tile_cache.set_current_time( current_time );
-    tile_cache.reset_traversal();
 
-    while ( ! tile_cache.at_end() )
+    // Prepare the ssg nodes corresponding to each tile: set the ssg
+    // transform and update it's range selector based on current
+    // visibility. Tiles which just finished loading are prepared below,
+    // the others only need it when the visibility changed.
+    if (vis != _prepared_visibility) {
+        TileCache::tile_map_iterator it = tile_cache.begin();
+        for ( ; it != tile_cache.end(); ++it) {
+            it->second->prep_ssg_node(vis);
+        }
+        scanned += sz;
+        _prepared_visibility = vis;
+    }
+
+    std::vector<long> loaded;
+    const std::set<long>& unloaded = tile_cache.get_unloaded_tiles();
+    for (std::set<long>::const_iterator it = unloaded.begin(); it != unloaded.end(); ++it)
     {
-        e = tile_cache.get_current();
-        if ( e )
-        {
-            // Prepare the ssg nodes corresponding to each tile.
-            // Set the ssg transform and update it's range selector
-            // based on current visibilty
+        TileEntry* e = tile_cache.get_tile(*it);
+        scanned++;
+        if (e->is_loaded()) {
             e->prep_ssg_node(vis);
-            
-            if (!e->is_loaded()) {
-                bool nonExpiredOrCurrent = !e->is_expired(current_time) || e->is_current_view();
-                bool downloading = isTileDirSyncing(e->tileFileName);
-                isDownloadingScenery |= downloading;
-                if ( !downloading && nonExpiredOrCurrent) {
-                    // schedule tile for loading with osg pager
-                    _pager->queueRequest(e->tileFileName,
-                                         e->getNode(),
-                                         e->get_priority(),
-                                         framestamp,
-                                         e->getDatabaseRequest(),
-                                         _options.get());
-                    loading++;
-                }
-            } // of tile not loaded case
-        } else {
-            SG_LOG(SG_TERRAIN, SG_ALERT, "Warning: empty tile in cache!");
+            loaded.push_back(*it);
+            continue;
+        }
+
+        bool nonExpiredOrCurrent = !e->is_expired(current_time) || e->is_current_view();
+        bool downloading = isTileDirSyncing(e->tileFileName);
+        isDownloadingScenery |= downloading;
+        if ( !downloading && nonExpiredOrCurrent) {
+            // schedule tile for loading with osg pager
+            _pager->queueRequest(e->tileFileName,
+                                 e->getNode(),
+                                 e->get_priority(),
+                                 framestamp,
+                                 e->getDatabaseRequest(),
+                                 _options.get());
+            loading++;
         }
-        tile_cache.next();
-        sz++;
     }
 
+    for (std::vector<long>::const_iterator it = loaded.begin(); it != loaded.end(); ++it) {
+        tile_cache.set_loaded(*it);
+    }
+
+    _tilesScanned->setIntValue(scanned);
+
     int drop_count = sz - tile_cache.get_max_cache_size();
     bool dropTiles = false;
     if (_enableCache) {
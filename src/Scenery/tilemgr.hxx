@@ -88,11 +88,16 @@ private:
     SGPropertyNode_ptr _visibilityMeters;
     SGPropertyNode_ptr _lodDetailed, _lodRoughDelta, _lodBareDelta, _disableNasalHooks;
     SGPropertyNode_ptr _scenery_loaded, _scenery_override;
+    /// number of cache entries update_queues() visited in the last frame
+    SGPropertyNode_ptr _tilesScanned;
 
     osg::ref_ptr<flightgear::SceneryPager> _pager;
 
     /// is caching of expired tiles enabled or not?
     bool _enableCache;    
+
+    /// visibility the range of the loaded tiles was last set for
+    double _prepared_visibility;
 public:
     FGTileMgr();
     ~FGTileMgr();
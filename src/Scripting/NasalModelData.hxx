@@ -19,6 +19,7 @@
 
 #include <simgear/nasal/nasal.h>
 #include <simgear/scene/model/modellib.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 class FGNasalModelData;
 typedef SGSharedPtr<FGNasalModelData> FGNasalModelDataRef;
@@ -50,6 +51,22 @@ public:
      */
     osg::Node* getNode();
 
+    /**
+     * Path of the model file, used to remember how expensive its hooks are.
+     */
+    const std::string& getPath() const
+    { return _path; }
+
+    /**
+     * Remember when the load or unload hook was queued, to measure how long
+     * it waits before it runs.
+     */
+    void markQueued()
+    { _queued.stamp(); }
+
+    const SGTimeStamp& getQueuedTime() const
+    { return _queued; }
+
     /**
      * Get FGNasalModelData for model with the given module id. Every scenery
      * model containing a nasal load or unload tag gets assigned a module id
@@ -69,6 +86,7 @@ private:
     SGConstPropertyNode_ptr _load, _unload;
     osg::ref_ptr<osg::Node> _branch;
     unsigned int _module_id;
+    SGTimeStamp _queued;
 };
 
 /** Thread-safe proxy for FGNasalModelData.
@@ -742,7 +742,29 @@ static void waypointGhostSetMember(naContext c, void* g, naRef field, naRef valu
 {
   const char* fieldName = naStr_data(field);
   Waypt* wpt = (Waypt*) g;
-  waypointCommonSetMember(c, wpt, fieldName, value);
+  if (!waypointCommonSetMember(c, wpt, fieldName, value))
+    return;
+
+  // Route paths see the change through the waypoint's revision, but the
+  // delegates of the flight plan holding it must be told. Waypoints made by
+  // createWP() have no owner, look for those in the active flight plan.
+  FlightPlanRef fp(dynamic_cast<FlightPlan*>(wpt->owner()));
+  if (!wpt->owner()) {
+    FGRouteMgr* rm = globals->get_subsystem<FGRouteMgr>();
+    if (rm)
+      fp = rm->flightPlan();
+  }
+
+  if (!fp)
+    return;
+
+  for (int i = 0; i < fp->numLegs(); ++i) {
+    FlightPlan::Leg* leg = fp->legAtIndex(i);
+    if (leg->waypoint() == wpt) {
+      leg->markWaypointDirty();
+      break;
+    }
+  }
 }
 
 static void legGhostSetMember(naContext c, void* g, naRef field, naRef value)
@@ -3137,7 +3159,7 @@ static naRef f_leg_path(naContext c, naRef me, int argc, naRef* args)
     naRuntimeError(c, "leg.setAltitude called on non-flightplan-leg object");
   }
 
-  RoutePath path(leg->owner());
+  const RoutePath& path = leg->owner()->routePath();
   SGGeodVec gv(path.pathForIndex(leg->index()));
 
   naRef result = naNewVector(c);
@@ -3162,7 +3184,7 @@ static naRef f_leg_courseAndDistanceFrom(naContext c, naRef me, int argc, naRef*
     SGGeod pos;
     geodFromArgs(args, 0, argc, pos);
 
-    RoutePath path(leg->owner());
+    const RoutePath& path = leg->owner()->routePath();
     SGGeod wpPos = path.positionForIndex(leg->index());
     double courseDeg, az2, distanceM;
     SGGeodesy::inverse(pos, wpPos, courseDeg, az2, distanceM);
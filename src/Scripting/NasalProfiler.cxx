@@ -0,0 +1,296 @@
+// NasalProfiler.cxx -- sampling profiler for Nasal code
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "NasalProfiler.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/threads/SGThread.hxx>
+#include <simgear/threads/SGGuard.hxx>
+
+NasalProfiler* NasalProfiler::_active = nullptr;
+std::atomic<bool> NasalProfiler::_sampleDue(false);
+unsigned int NasalProfiler::_generation = 0;
+
+// folded stacks use ';' between frames and a space before the count
+static std::string sanitizeFrame(std::string s)
+{
+    std::replace(s.begin(), s.end(), ';', ',');
+    return s;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * Raises the sample flag once per interval.
+ */
+class NasalProfiler::TimerThread : public SGThread
+{
+public:
+    explicit TimerThread(unsigned int intervalMs) :
+        _intervalMs(intervalMs),
+        _stop(false)
+    {
+    }
+
+    void stop()
+    {
+        {
+            SGGuard<SGMutex> g(_lock);
+            _stop = true;
+            _wake.signal();
+        }
+        join();
+    }
+
+protected:
+    void run() override
+    {
+        SGGuard<SGMutex> g(_lock);
+        while (!_stop) {
+            _wake.wait(_lock, _intervalMs);
+            _sampleDue.store(true, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    unsigned int _intervalMs;
+    bool _stop;
+    SGMutex _lock;
+    SGWaitCondition _wake;
+};
+
+//------------------------------------------------------------------------------
+
+NasalProfiler::NasalProfiler() :
+    _running(false),
+    _intervalUs(0.0)
+{
+}
+
+NasalProfiler::~NasalProfiler()
+{
+    stop();
+}
+
+void NasalProfiler::start(double intervalMs)
+{
+    if (_running) {
+        return;
+    }
+
+    const unsigned int ms = std::max(1u, static_cast<unsigned int>(std::lround(intervalMs)));
+    _intervalUs = ms * 1000.0;
+    _mainThread = std::this_thread::get_id();
+    _frames.clear();
+    _running = true;
+    _active = this;
+    ++_generation;
+
+    _timer.reset(new TimerThread(ms));
+    _timer->start();
+    SG_LOG(SG_NASAL, SG_INFO, "Nasal profiler started, sampling every " << ms << "ms");
+}
+
+void NasalProfiler::stop()
+{
+    if (!_running) {
+        return;
+    }
+
+    _timer->stop();
+    _timer.reset();
+    _sampleDue.store(false, std::memory_order_relaxed);
+    _active = nullptr;
+    _running = false;
+    // open boundary frames are dropped; their scopes see _active == nullptr
+    // and their time is lost, which is fine for a profile
+    _frames.clear();
+    SG_LOG(SG_NASAL, SG_INFO, "Nasal profiler stopped");
+}
+
+void NasalProfiler::reset()
+{
+    _folded.clear();
+}
+
+bool NasalProfiler::writeFolded(const SGPath& path) const
+{
+    sg_ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out) {
+        SG_LOG(SG_NASAL, SG_ALERT, "Nasal profiler: cannot write " << path);
+        return false;
+    }
+
+    for (const auto& entry : _folded) {
+        const long us = std::lround(entry.second);
+        if (us > 0) {
+            out << entry.first << ' ' << us << '\n';
+        }
+    }
+
+    SG_LOG(SG_NASAL, SG_INFO, "Nasal profiler: wrote " << _folded.size()
+           << " stacks to " << path);
+    return true;
+}
+
+void NasalProfiler::push(const char* kind, const std::string& site)
+{
+    if (!kind) {
+        if (!_frames.empty() && !_frames.back().entered) {
+            // the call made on behalf of a labelled scope
+            _frames.back().entered = true;
+            return;
+        }
+        kind = "call";
+    }
+
+    Frame f;
+    f.label = site.empty() ? std::string(kind)
+                           : sanitizeFrame(std::string(kind) + " " + site);
+    f.childUs = 0.0;
+    f.sampledUs = 0.0;
+    f.entered = false;
+    f.start.stamp();
+    _frames.push_back(f);
+}
+
+void NasalProfiler::pop()
+{
+    const Frame& f = _frames.back();
+    const double elapsedUs = f.start.elapsedUSec();
+
+    // time not covered by nested boundaries or Nasal samples stays with
+    // the boundary frame itself
+    const double selfUs = elapsedUs - f.childUs - f.sampledUs;
+    if (selfUs > 0.0) {
+        _folded[boundaryStack()] += selfUs;
+    }
+
+    _frames.pop_back();
+    if (!_frames.empty()) {
+        _frames.back().childUs += elapsedUs;
+    }
+}
+
+void NasalProfiler::takeSample(naContext c)
+{
+    if (!onMainThread()) {
+        return;
+    }
+
+    _sampleDue.store(false, std::memory_order_relaxed);
+
+    std::string stack = boundaryStack();
+    const int depth = naStackDepth(c);
+    for (int i = depth - 1; i >= 0; --i) {
+        if (!stack.empty()) {
+            stack += ';';
+        }
+
+        naRef file = naGetSourceFile(c, i);
+        stack += naIsString(file) ? sanitizeFrame(naStr_data(file)) : "<native>";
+        stack += ':';
+        stack += std::to_string(naGetLine(c, i));
+    }
+
+    _folded[stack] += _intervalUs;
+    if (!_frames.empty()) {
+        _frames.back().sampledUs += _intervalUs;
+    }
+}
+
+std::string NasalProfiler::boundaryStack() const
+{
+    std::string stack;
+    for (const auto& f : _frames) {
+        if (!stack.empty()) {
+            stack += ';';
+        }
+        stack += f.label;
+    }
+
+    return stack.empty() ? std::string("nasal") : stack;
+}
+
+//------------------------------------------------------------------------------
+
+NasalProfiler::Scope::Scope(const char* kind, const std::string& site) :
+    _pushed(false),
+    _generation(NasalProfiler::_generation)
+{
+    if (_active && _active->onMainThread()) {
+        const size_t depth = _active->_frames.size();
+        _active->push(kind, site);
+        _pushed = (_active->_frames.size() > depth);
+    }
+}
+
+NasalProfiler::Scope::~Scope()
+{
+    // the profiler may have been stopped, or stopped and started again, by
+    // the code we bracket: our frame is gone then
+    if (_pushed && _active && (_generation == NasalProfiler::_generation) &&
+        !_active->_frames.empty()) {
+        _active->pop();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+NasalProfiler::Site::Site() :
+    _file(naNil()),
+    _line(0),
+    _gcKey(-1)
+{
+}
+
+NasalProfiler::Site::~Site()
+{
+    if (_gcKey >= 0) {
+        naGCRelease(_gcKey);
+    }
+}
+
+void NasalProfiler::Site::set(naContext c)
+{
+    if (_gcKey >= 0) {
+        naGCRelease(_gcKey);
+        _gcKey = -1;
+    }
+
+    _file = naGetSourceFile(c, 0);
+    _line = naGetLine(c, 0);
+    if (naIsString(_file)) {
+        _gcKey = naGCSave(_file);
+    }
+}
+
+const std::string& NasalProfiler::Site::label() const
+{
+    if (_label.empty() && naIsString(_file)) {
+        _label = std::string(naStr_data(_file)) + ":" + std::to_string(_line);
+    }
+
+    return _label;
+}
@@ -0,0 +1,154 @@
+// NasalProfiler.hxx -- sampling profiler for Nasal code
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef SCRIPTING_NASAL_PROFILER_HXX
+#define SCRIPTING_NASAL_PROFILER_HXX
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/nasal/nasal.h>
+#include <simgear/timing/timestamp.hxx>
+
+/**
+ * Profiler attributing frame time to Nasal code, in folded-stack format
+ * (one "frame;frame;frame microseconds" line per distinct stack), ready to
+ * be turned into a flame graph.
+ *
+ * Stacks have two parts.  The outer frames are the C++ -> Nasal call
+ * boundaries (timer, listener and command callbacks, module loading...),
+ * each labelled with the site that registered the callback; their time is
+ * measured exactly.  The inner frames are Nasal source locations, sampled
+ * on a timer: a background thread raises a flag every interval, and the
+ * main thread records the running Nasal call stack the next time the
+ * interpreter calls back into C++ (property access, getprop/setprop...).
+ *
+ * Only the main thread is profiled.
+ */
+class NasalProfiler
+{
+public:
+    NasalProfiler();
+    ~NasalProfiler();
+
+    void start(double intervalMs);
+    void stop();
+    void reset();
+
+    bool isRunning() const
+    { return _running; }
+
+    /**
+     * Whether any profiler is recording, i.e. scope labels are needed.
+     */
+    static bool isActive()
+    { return _active != nullptr; }
+
+    /**
+     * Write all stacks recorded so far.
+     */
+    bool writeFolded(const SGPath& path) const;
+
+    /**
+     * Marks a C++ -> Nasal call boundary for as long as it exists.  Costs
+     * a single test when the profiler is not running.
+     *
+     * A null kind marks a plain call (FGNasalSys::callMethod and friends):
+     * it merges into a labelled scope opened just before it, and is shown
+     * as "call" otherwise.
+     */
+    class Scope
+    {
+    public:
+        Scope(const char* kind, const std::string& site = std::string());
+        ~Scope();
+
+    private:
+        bool _pushed;
+        unsigned int _generation;
+    };
+
+    /**
+     * Where a long-lived callback (maketimer, setlistener) was registered.
+     * Only the caller's file and line are kept; the label is built the
+     * first time it is needed while profiling.
+     */
+    class Site
+    {
+    public:
+        Site();
+        ~Site();
+
+        void set(naContext c);
+        const std::string& label() const;
+
+    private:
+        Site(const Site&) = delete;
+        Site& operator=(const Site&) = delete;
+
+        naRef _file;
+        int _line;
+        int _gcKey;
+        mutable std::string _label;
+    };
+
+    /**
+     * Sampling point, called whenever Nasal code calls back into C++.
+     */
+    static void sample(naContext c)
+    {
+        if (_sampleDue.load(std::memory_order_relaxed)) {
+            _active->takeSample(c);
+        }
+    }
+
+private:
+    class TimerThread;
+
+    struct Frame
+    {
+        std::string label;
+        SGTimeStamp start;
+        double childUs;
+        double sampledUs;
+        bool entered; ///< whether the Nasal call itself was made yet
+    };
+
+    void push(const char* kind, const std::string& site);
+    void pop();
+    void takeSample(naContext c);
+    std::string boundaryStack() const;
+    bool onMainThread() const
+    { return std::this_thread::get_id() == _mainThread; }
+
+    static NasalProfiler* _active;
+    static std::atomic<bool> _sampleDue;
+    static unsigned int _generation; ///< bumped on every start()
+
+    bool _running;
+    double _intervalUs;
+    std::thread::id _mainThread;
+    std::unique_ptr<TimerThread> _timer;
+    std::vector<Frame> _frames;
+    std::map<std::string, double> _folded; ///< stack -> microseconds
+};
+
+#endif // of SCRIPTING_NASAL_PROFILER_HXX
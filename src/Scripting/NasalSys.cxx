@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -30,7 +31,6 @@
 #include <simgear/misc/SimpleMarkdown.hxx>
 #include <simgear/structure/commands.hxx>
 #include <simgear/math/sg_geodesy.hxx>
-#include <simgear/structure/event_mgr.hxx>
 #include <simgear/debug/BufferedLogCallback.hxx>
 
 #include <simgear/nasal/cppbind/from_nasal.hxx>
@@ -91,7 +91,7 @@ void FGNasalModuleListener::valueChanged(SGPropertyNode*)
 
 //////////////////////////////////////////////////////////////////////////
 
-class TimerObj : public SGReferenced
+class TimerObj : public SGReferenced, public NasalTimerQueue::Entry
 {
 public:
   TimerObj(Context *c, FGNasalSys* sys, naRef f, naRef self, double interval) :
@@ -103,6 +103,7 @@ public:
     char nm[256];
     if (c) {
         snprintf(nm, 128, "maketimer-[%p]-%s:%d", (void*)this, naStr_data(naGetSourceFile(c, 0)), naGetLine(c, 0));
+        _site.set(c);
     }
     else {
         snprintf(nm, 128, "maketimer-%p", this);
@@ -126,7 +127,7 @@ public:
   void stop()
   {
     if (_isRunning) {
-      globals->get_event_mgr()->removeTask(_name);
+      _sys->timerQueue(_isSimTime).cancel(this);
       _isRunning = false;
     }
   }
@@ -150,13 +151,7 @@ public:
     }
 
     _isRunning = true;
-    if (_singleShot) {
-      globals->get_event_mgr()->addEvent(_name, this, &TimerObj::invoke, _interval, _isSimTime);
-    } else {
-      globals->get_event_mgr()->addTask(_name, this, &TimerObj::invoke,
-                                        _interval, _interval /* delay */,
-                                        _isSimTime);
-    }
+    _sys->timerQueue(_isSimTime).schedule(this, _interval);
   }
 
   // stop and then start -
@@ -167,16 +162,24 @@ public:
     start();
   }
 
-  void invoke()
+  void expired(naContext ctx) override
   {
     if( _singleShot )
       // Callback may restart the timer, so update status before callback is
-      // called (Prevent warnings of deleting not existing tasks from the
-      // event manager).
+      // called.
       _isRunning = false;
 
     naRef *args = nullptr;
-    _sys->callMethod(_func, _self, 0, args, naNil() /* locals */);
+    {
+      NasalProfiler::Scope scope("maketimer",
+          NasalProfiler::isActive() ? _site.label() : std::string());
+      _sys->callMethodWithContext(ctx, _func, _self, 0, args, naNil() /* locals */);
+    }
+
+    // repeat, unless the callback stopped or restarted us
+    if (_isRunning && !isScheduled()) {
+      _sys->timerQueue(_isSimTime).schedule(this, _interval);
+    }
   }
 
   void setSingleShot(bool aSingleShot)
@@ -191,6 +194,7 @@ public:
   { return _name; }
 private:
   std::string _name;
+  NasalProfiler::Site _site;
   FGNasalSys* _sys;
   naRef _func, _self;
   int _gcRoot, _gcSelf;
@@ -328,6 +332,7 @@ naRef FGNasalSys::callWithContext(naContext ctx, naRef code, int argc, naRef* ar
 
 naRef FGNasalSys::callMethod(naRef code, naRef self, int argc, naRef* args, naRef locals)
 {
+    NasalProfiler::Scope scope(nullptr);
     try {
         return naCallMethod(code, self, argc, args, locals);
     } catch (sg_exception& e) {
@@ -338,6 +343,7 @@ naRef FGNasalSys::callMethod(naRef code, naRef self, int argc, naRef* args, naRe
 
 naRef FGNasalSys::callMethodWithContext(naContext ctx, naRef code, naRef self, int argc, naRef* args, naRef locals)
 {
+    NasalProfiler::Scope scope(nullptr);
     try {
         return naCallMethodCtx(ctx, code, self, argc, args, locals);
     } catch (sg_exception& e) {
@@ -447,6 +453,7 @@ static SGPropertyNode* findnode(naContext c, naRef* vec, int len, bool create=fa
 static naRef f_getprop(naContext c, naRef me, int argc, naRef* args)
 {
     using namespace simgear;
+    NasalProfiler::sample(c);
     if (argc < 1) {
         naRuntimeError(c, "getprop() expects at least 1 argument");
     }
@@ -486,6 +493,7 @@ static naRef f_getprop(naContext c, naRef me, int argc, naRef* args)
 // final argument.
 static naRef f_setprop(naContext c, naRef me, int argc, naRef* args)
 {
+    NasalProfiler::sample(c);
     if (argc < 2) {
         naRuntimeError(c, "setprop() expects at least 2 arguments");
     }
@@ -557,6 +565,7 @@ static naRef f_logprint(naContext c, naRef me, int argc, naRef* args)
 // an argument.
 static naRef f_fgcommand(naContext c, naRef me, int argc, naRef* args)
 {
+    NasalProfiler::sample(c);
     naRef cmd = argc > 0 ? args[0] : naNil();
     naRef props = argc > 1 ? args[1] : naNil();
     if(!naIsString(cmd) || (!naIsNil(props) && !naIsGhost(props)))
@@ -616,6 +625,20 @@ static naRef f_removelistener(naContext c, naRef me, int argc, naRef* args)
     return nasalSys->removeListener(c, argc, args);
 }
 
+// deferlistener(int [, bool]) extension function. Falls through to
+// FGNasalSys::deferListener(). See there for docs.
+static naRef f_deferlistener(naContext c, naRef me, int argc, naRef* args)
+{
+    return nasalSys->deferListener(c, argc, args);
+}
+
+// listenerstats(int) extension function. Falls through to
+// FGNasalSys::listenerStats(). See there for docs.
+static naRef f_listenerstats(naContext c, naRef me, int argc, naRef* args)
+{
+    return nasalSys->listenerStats(c, argc, args);
+}
+
 // Returns a ghost handle to the argument to the currently executing
 // command
 static naRef f_cmdarg(naContext c, naRef me, int argc, naRef* args)
@@ -751,6 +774,7 @@ public:
         naRef args[1];
         args[0] = _sys->wrappedPropsNode(const_cast<SGPropertyNode*>(aNode));
 
+        NasalProfiler::Scope scope("command", _name);
         _sys->callMethod(_func, naNil(), 1, args, naNil() /* locals */);
 
         return true;
@@ -910,6 +934,8 @@ static struct { const char* name; naCFunction func; } funcs[] = {
     { "maketimer", f_makeTimer },
     { "_setlistener", f_setlistener },
     { "removelistener", f_removelistener },
+    { "deferlistener", f_deferlistener },
+    { "listenerstats", f_listenerstats },
     { "addcommand", f_addCommand },
     { "removecommand", f_removeCommand },
     { "_cmdarg",  f_cmdarg },
@@ -1001,6 +1027,25 @@ void FGNasalSys::init()
 
     flightgear::addons::initAddonClassesForNasal(_globals, _context);
 
+    globals->get_commands()->addCommand("nasal-profiler", this, &FGNasalSys::profilerCommand);
+
+    _hookBudget = fgGetNode("/sim/nasal-model-hooks/budget-ms", true);
+    if (!_hookBudget->hasValue()) {
+        _hookBudget->setDoubleValue(2.0);
+    }
+    _hookLoadQueue = fgGetNode("/sim/nasal-model-hooks/load-queue", true);
+    _hookUnloadQueue = fgGetNode("/sim/nasal-model-hooks/unload-queue", true);
+    _hookCount = fgGetNode("/sim/nasal-model-hooks/hooks-run", true);
+    _hookTime = fgGetNode("/sim/nasal-model-hooks/time-ms", true);
+    _hookLatency = fgGetNode("/sim/nasal-model-hooks/latency-ms", true);
+
+    _deferredCalls = fgGetNode("/sim/nasal-listeners/deferred-calls", true);
+    _deferredTime = fgGetNode("/sim/nasal-listeners/deferred-time-ms", true);
+    _timerCallbacks = fgGetNode("/sim/nasal-timers/callbacks", true);
+    _timerTime = fgGetNode("/sim/nasal-timers/time-ms", true);
+    _timerPending = fgGetNode("/sim/nasal-timers/pending", true);
+    _realDeltaTime = fgGetNode("/sim/time/delta-realtime-sec", true);
+
     // Now load the various source files in the Nasal directory
     simgear::Dir nasalDir(SGPath(globals->get_fg_root(), "Nasal"));
     loadScriptDirectory(nasalDir);
@@ -1038,6 +1083,10 @@ void FGNasalSys::shutdown()
 
     shutdownNasalPositioned();
 
+    _profiler.stop();
+    globals->get_commands()->removeCommand("nasal-profiler");
+
+    _deferredListeners.clear();
     for (auto l : _listener)
         delete l.second;
     _listener.clear();
@@ -1051,10 +1100,15 @@ void FGNasalSys::shutdown()
         delete ml;
     _moduleListeners.clear();
 
-    for (auto t : _nasalTimers) {
-        delete t;
+    // maketimer() objects belong to Nasal, only unlink them; whatever is
+    // left after that are our own settimer() instances
+    for (auto pt : _persistentTimers) {
+        pt->stop();
     }
-    _nasalTimers.clear();
+
+    auto deleteTimer = [](NasalTimerQueue::Entry* e) { delete e; };
+    _simTimers.clear(deleteTimer);
+    _realTimers.clear(deleteTimer);
     
     naClearSaved();
 
@@ -1099,31 +1153,30 @@ naRef FGNasalSys::wrappedPropsNode(SGPropertyNode* aProps)
     return wrapped;
 }
 
-void FGNasalSys::update(double)
+void FGNasalSys::update(double dt)
 {
     if( NasalClipboard::getInstance() )
         NasalClipboard::getInstance()->update();
+
+    fireDeferredListeners();
+
     if(!_dead_listener.empty()) {
+        // a deferred callback may have dirtied a listener and removed it
+        // again: drop those from the pending list before they are deleted
+        for(auto it = _deferredListeners.begin(); it != _deferredListeners.end(); ) {
+            if((*it)->_dead) it = _deferredListeners.erase(it);
+            else ++it;
+        }
+
         vector<FGNasalListener *>::iterator it, end = _dead_listener.end();
         for(it = _dead_listener.begin(); it != end; ++it) delete *it;
         _dead_listener.clear();
     }
 
-    if (!_loadList.empty())
-    {
-        if( _delay_load )
-          _delay_load = false;
-        else
-          // process Nasal load hook (only one per update loop to avoid excessive lags)
-          _loadList.pop()->load();
-    }
-    else
-    if (!_unloadList.empty())
-    {
-        // process pending Nasal unload hooks after _all_ load hooks were processed
-        // (only unload one per update loop to avoid excessive lags)
-        _unloadList.pop()->unload();
-    }
+    runModelHooks();
+
+    fireTimers(dt);
+
     // Destroy all queued ghosts
     nasal::ghostProcessDestroyList();
 
@@ -1335,6 +1388,7 @@ bool FGNasalSys::createModule(const char* moduleName, const char* fileName,
 
     _cmdArg = (SGPropertyNode*)cmdarg;
 
+    NasalProfiler::Scope scope("module", fileName);
     callWithContext(ctx, code, argc, args, locals);
     hashset(_globals, moduleName, locals);
 
@@ -1417,6 +1471,7 @@ bool FGNasalSys::handleCommand( const char* moduleName,
     // code doesn't need it.
     _cmdArg = (SGPropertyNode*)arg;
 
+    NasalProfiler::Scope scope("binding", fileName);
     callWithContext(ctx, code, 0, 0, locals);
     naFreeContext(ctx);
     return true;
@@ -1461,29 +1516,44 @@ void FGNasalSys::setTimer(naContext c, int argc, naRef* args)
 
     bool simtime = (argc > 2 && naTrue(args[2])) ? false : true;
 
-    // A unique name for the timer based on the file name and line number of the function.
-    std::string name = "settimer-";
-    name.append(naStr_data(naGetSourceFile(c, 0)));
-    name.append(":");
-    name.append(std::to_string(naGetLine(c, 0)));
-
-    // Generate and register a C++ timer handler
+    // Generate and queue a C++ timer handler; the queue holds it until
+    // it fires.
     NasalTimer* t = new NasalTimer(handler, this);
-    _nasalTimers.push_back(t);
-    globals->get_event_mgr()->addEvent(name,
-                                       t, &NasalTimer::timerExpired,
-                                       delta.num, simtime);
+    if (_profiler.isRunning()) {
+        t->site = std::string(naStr_data(naGetSourceFile(c, 0))) + ":" +
+                  std::to_string(naGetLine(c, 0));
+    }
+    timerQueue(simtime).schedule(t, delta.num);
 }
 
-void FGNasalSys::handleTimer(NasalTimer* t)
+void FGNasalSys::handleTimer(NasalTimer* t, naContext ctx)
 {
-    call(t->handler, 0, 0, naNil());
-    auto it =  std::find(_nasalTimers.begin(), _nasalTimers.end(), t);
-    assert(it != _nasalTimers.end());
-    _nasalTimers.erase(it);
+    NasalProfiler::Scope scope("settimer", t->site);
+    callWithContext(ctx, t->handler, 0, 0, naNil());
     delete t;
 }
 
+// Fire all expired settimer()/maketimer() callbacks.  They all run
+// back-to-back in a single context, and the number of callbacks and
+// the time spent in them are published for profiling.
+void FGNasalSys::fireTimers(double dt)
+{
+    _simTimers.advance(dt);
+    _realTimers.advance(_realDeltaTime->getDoubleValue());
+
+    SGTimeStamp st;
+    st.stamp();
+
+    naContext ctx = naNewContext();
+    unsigned int count = _simTimers.fireExpired(ctx);
+    count += _realTimers.fireExpired(ctx);
+    naFreeContext(ctx);
+
+    _timerCallbacks->setIntValue(count);
+    _timerTime->setDoubleValue(count ? st.elapsedUSec() / 1000.0 : 0.0);
+    _timerPending->setIntValue(_simTimers.size() + _realTimers.size());
+}
+
 int FGNasalSys::gcSave(naRef r)
 {
     return naGCSave(r);
@@ -1509,9 +1579,9 @@ NasalTimer::~NasalTimer()
     naGCRelease(gcKey);
 }
 
-void NasalTimer::timerExpired()
+void NasalTimer::expired(naContext ctx)
 {
-    nasal->handleTimer(this);
+    nasal->handleTimer(this, ctx);
     // note handleTimer calls delete on us, don't do anything
     // which requires 'this' to be valid here
 }
@@ -1519,14 +1589,16 @@ void NasalTimer::timerExpired()
 
 int FGNasalSys::_listenerId = 0;
 
-// setlistener(<property>, <func> [, <initial=0> [, <persistent=1>]])
+// setlistener(<property>, <func> [, <initial=0> [, <persistent=1> [, <deferred=0>]]])
 // Attaches a callback function to a property (specified as a global
 // property path string or a SGPropertyNode* ghost). If the third,
 // optional argument (default=0) is set to 1, then the function is also
 // called initially. If the fourth, optional argument is set to 0, then the
 // function is only called when the property node value actually changes.
 // Otherwise it's called independent of the value whenever the node is
-// written to (default). The setlistener() function returns a unique
+// written to (default). If the fifth, optional argument is set to 1, value
+// changes are coalesced and the function is called at most once per frame
+// (see deferlistener()). The setlistener() function returns a unique
 // id number, which is to be used as argument to the removelistener()
 // function.
 naRef FGNasalSys::setListener(naContext c, int argc, naRef* args)
@@ -1552,8 +1624,11 @@ naRef FGNasalSys::setListener(naContext c, int argc, naRef* args)
 
     int init = argc > 2 && naIsNum(args[2]) ? int(args[2].num) : 0; // do not trigger when created
     int type = argc > 3 && naIsNum(args[3]) ? int(args[3].num) : 1; // trigger will always be triggered when the property is written 
+    bool deferred = argc > 4 && naTrue(args[4]);
     FGNasalListener *nl = new FGNasalListener(node, code, this,
             gcSave(code), _listenerId, init, type);
+    nl->setDeferred(deferred);
+    nl->_site.set(c);
 
     node->addChangeListener(nl, init != 0);
 
@@ -1579,18 +1654,204 @@ naRef FGNasalSys::removeListener(naContext c, int argc, naRef* args)
     return naNum(_listener.size());
 }
 
+// deferlistener(int [, bool=1]) extension function. Switches the listener
+// with the given id (as returned by setlistener()) into deferred mode, or
+// back into immediate mode if the second argument is 0. A deferred
+// listener is not called for every write to its property: writes are
+// recorded, and the listener is called once per frame with the final
+// value. Listeners which only fire on actual changes skip the call if the
+// value ended up where it started.
+naRef FGNasalSys::deferListener(naContext c, int argc, naRef* args)
+{
+    naRef id = argc > 0 ? args[0] : naNil();
+    map<int, FGNasalListener *>::iterator it = _listener.find(int(id.num));
+
+    if(!naIsNum(id) || it == _listener.end() || it->second->_dead) {
+        naRuntimeError(c, "deferlistener() with invalid listener id");
+        return naNil();
+    }
+
+    it->second->setDeferred(argc > 1 ? naTrue(args[1]) : true);
+    return naNil();
+}
+
+// listenerstats(int) extension function. Returns a hash with profiling
+// counters of the listener with the given id: the number of change
+// notifications received ("notifications"), the number of calls into
+// Nasal ("calls"), the total time spent in those calls in milliseconds
+// ("time_ms") and whether the listener is deferred ("deferred").
+naRef FGNasalSys::listenerStats(naContext c, int argc, naRef* args)
+{
+    naRef id = argc > 0 ? args[0] : naNil();
+    map<int, FGNasalListener *>::iterator it = _listener.find(int(id.num));
+
+    if(!naIsNum(id) || it == _listener.end()) {
+        naRuntimeError(c, "listenerstats() with invalid listener id");
+        return naNil();
+    }
+
+    const FGNasalListener* l = it->second;
+    nasal::Hash stats(c);
+    stats.set("notifications", static_cast<double>(l->_notifications));
+    stats.set("calls", static_cast<double>(l->_calls));
+    stats.set("time_ms", l->_callTimeMs);
+    stats.set("deferred", l->_deferred);
+    return stats.get_naRef();
+}
+
+void FGNasalSys::queueDeferredListener(FGNasalListener* l)
+{
+    _deferredListeners.push_back(l);
+}
+
+// Call every deferred listener which saw changes since the last update,
+// once each. Listeners dirtied by these calls are kept for the next frame.
+void FGNasalSys::fireDeferredListeners()
+{
+    if (_deferredListeners.empty()) {
+        _deferredCalls->setIntValue(0);
+        _deferredTime->setDoubleValue(0.0);
+        return;
+    }
+
+    SGTimeStamp st;
+    st.stamp();
+
+    std::vector<FGNasalListener*> pending;
+    pending.swap(_deferredListeners);
+    for (auto l : pending) {
+        l->callDeferred();
+    }
+
+    _deferredCalls->setIntValue(pending.size());
+    _deferredTime->setDoubleValue(st.elapsedUSec() / 1000.0);
+}
+
+// nasal-profiler command: controls the Nasal profiler.  Arguments:
+//   action       "start", "stop", "dump" or "reset"
+//   interval-ms  sampling interval for "start" (default 2)
+//   filename     output for "stop" and "dump" (default
+//                $FG_HOME/Export/nasal-profile.folded)
+// "stop" writes the profile collected so far, "dump" writes it without
+// stopping.  The output is in folded-stack format, which flamegraph.pl
+// turns into a flame graph.
+bool FGNasalSys::profilerCommand(const SGPropertyNode* arg, SGPropertyNode*)
+{
+    const string action = arg->getStringValue("action", "start");
+    if (action == "start") {
+        _profiler.start(arg->getDoubleValue("interval-ms", 2.0));
+        return true;
+    }
+
+    if (action == "reset") {
+        _profiler.reset();
+        return true;
+    }
+
+    if ((action != "stop") && (action != "dump")) {
+        SG_LOG(SG_NASAL, SG_WARN, "nasal-profiler: unknown action '" << action << "'");
+        return false;
+    }
+
+    if (action == "stop") {
+        _profiler.stop();
+    }
+
+    SGPath path = globals->get_fg_home() / "Export" / "nasal-profile.folded";
+    if (arg->hasValue("filename")) {
+        path = SGPath::fromUtf8(arg->getStringValue("filename"));
+    }
+
+    const SGPath authorizedPath = fgValidatePath(path, /* write */ true);
+    if (authorizedPath.isNull()) {
+        SG_LOG(SG_NASAL, SG_ALERT, "nasal-profiler: writing to " << path
+               << " is not authorized");
+        return false;
+    }
+
+    return _profiler.writeFolded(authorizedPath);
+}
+
 void FGNasalSys::registerToLoad(FGNasalModelData *data)
 {
   if( _loadList.empty() )
     _delay_load = true;
+  data->markQueued();
   _loadList.push(data);
 }
 
 void FGNasalSys::registerToUnload(FGNasalModelData *data)
 {
+    data->markQueued();
     _unloadList.push(data);
 }
 
+// Run queued model load and unload hooks until the per-frame budget is
+// spent. At least one hook runs per frame, so the queues always drain,
+// but a hook which was expensive last time is not started once other
+// hooks have used up part of the budget. Unload hooks only run after
+// _all_ pending load hooks were processed.
+void FGNasalSys::runModelHooks()
+{
+    const double budgetMs = _hookBudget->getDoubleValue();
+    double spentMs = 0.0;
+    double latencyMs = 0.0;
+    unsigned int count = 0;
+
+    for (;;) {
+        const bool isLoad = !_loadList.empty();
+        if (isLoad && _delay_load) {
+            _delay_load = false;
+            break;
+        }
+
+        if (!isLoad && _unloadList.empty()) {
+            break;
+        }
+
+        // other threads only ever push, so the front stays ours to pop
+        SGSharedPtr<FGNasalModelData> data = isLoad ? _loadList.front()
+                                                    : _unloadList.front();
+        std::map<std::string, double>& costs = isLoad ? _loadHookCost
+                                                      : _unloadHookCost;
+        std::map<std::string, double>::iterator it = costs.find(data->getPath());
+        const double expectedMs = (it != costs.end()) ? it->second : 0.0;
+        if ((count > 0) && (spentMs + expectedMs > budgetMs)) {
+            break;
+        }
+
+        if (isLoad) {
+            _loadList.pop();
+        } else {
+            _unloadList.pop();
+        }
+        latencyMs = std::max(latencyMs, data->getQueuedTime().elapsedMSec() * 1.0);
+
+        SGTimeStamp st;
+        st.stamp();
+        if (isLoad) {
+            data->load();
+        } else {
+            data->unload();
+        }
+
+        const double costMs = st.elapsedUSec() / 1000.0;
+        costs[data->getPath()] = costMs;
+        spentMs += costMs;
+        ++count;
+
+        if (spentMs >= budgetMs) {
+            break;
+        }
+    }
+
+    _hookLoadQueue->setIntValue(_loadList.size());
+    _hookUnloadQueue->setIntValue(_unloadList.size());
+    _hookCount->setIntValue(count);
+    _hookTime->setDoubleValue(spentMs);
+    _hookLatency->setDoubleValue(latencyMs);
+}
+
 void FGNasalSys::addCommand(naRef func, const std::string& name)
 {
     if (_commands.find(name) != _commands.end()) {
@@ -1617,12 +1878,12 @@ void FGNasalSys::removeCommand(const std::string& name)
 
 void FGNasalSys::addPersistentTimer(TimerObj* pto)
 {
-    _persistentTimers.push_back(pto);
+    _persistentTimers.insert(pto);
 }
 
 void FGNasalSys::removePersistentTimer(TimerObj* obj)
 {
-    auto it = std::find(_persistentTimers.begin(), _persistentTimers.end(), obj);
+    auto it = _persistentTimers.find(obj);
     assert(it != _persistentTimers.end());
     _persistentTimers.erase(it);
 }
@@ -1664,18 +1925,49 @@ void FGNasalListener::call(SGPropertyNode* which, naRef mode)
 {
     if(_active || _dead) return;
     _active++;
+    SGTimeStamp st;
+    st.stamp();
     naRef arg[4];
     arg[0] = _nas->propNodeGhost(which);
     arg[1] = _nas->propNodeGhost(_node);
     arg[2] = mode;                  // value changed, child added/removed
     arg[3] = naNum(_node != which); // child event?
-    _nas->call(_code, 4, arg, naNil());
+    {
+        NasalProfiler::Scope scope("listener", NasalProfiler::isActive() ?
+            _site.label() + " " + _node->getPath() : std::string());
+        _nas->call(_code, 4, arg, naNil());
+    }
+    _calls++;
+    _callTimeMs += st.elapsedUSec() / 1000.0;
     _active--;
 }
 
+void FGNasalListener::callDeferred()
+{
+    _dirty = false;
+    SGPropertyNode_ptr which = _dirtyNode;
+    _dirtyNode.clear();
+
+    if(_type > 0 || changed(_node))
+        call(which, naNum(0));
+}
+
 void FGNasalListener::valueChanged(SGPropertyNode* node)
 {
     if(_type < 2 && node != _node) return;   // skip child events
+    _notifications++;
+
+    // the initial call requested by setlistener() is never deferred
+    if(_deferred && !_init) {
+        if(_dead) return;
+        _dirtyNode = node;
+        if(!_dirty) {
+            _dirty = true;
+            _nas->queueDeferredListener(this);
+        }
+        return;
+    }
+
     if(_type > 0 || changed(_node) || _init)
         call(node, naNum(0));
 
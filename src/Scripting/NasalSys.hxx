@@ -18,6 +18,10 @@
 
 #include <map>
 #include <memory>
+#include <set>
+
+#include "NasalProfiler.hxx"
+#include "NasalTimerQueue.hxx"
 
 class FGNasalScript;
 class FGNasalListener;
@@ -74,6 +78,8 @@ public:
     // Implementation of the setlistener extension function
     naRef setListener(naContext c, int argc, naRef* args);
     naRef removeListener(naContext c, int argc, naRef* args);
+    naRef deferListener(naContext c, int argc, naRef* args);
+    naRef listenerStats(naContext c, int argc, naRef* args);
 
     // Returns a ghost wrapper for the current _cmdArg
     naRef cmdArgGhost();
@@ -161,6 +167,9 @@ public:
     simgear::BufferedLogCallback* log() const
     { return _log.get(); }
 
+    NasalProfiler& profiler()
+    { return _profiler; }
+
 private:
     //friend class FGNasalScript;
     friend class FGNasalListener;
@@ -172,10 +181,32 @@ private:
     // callback).
     bool _delay_load;
 
+    // Model load/unload hooks are run against a per-frame time budget.
+    // The last measured cost of the hooks of each model file is kept, so
+    // expensive hooks get a frame of their own.
+    void runModelHooks();
+    std::map<std::string, double> _loadHookCost;
+    std::map<std::string, double> _unloadHookCost;
+
+    SGPropertyNode_ptr _hookBudget;
+    SGPropertyNode_ptr _hookLoadQueue;
+    SGPropertyNode_ptr _hookUnloadQueue;
+    SGPropertyNode_ptr _hookCount;
+    SGPropertyNode_ptr _hookTime;
+    SGPropertyNode_ptr _hookLatency;
+
     // Listener
     std::map<int, FGNasalListener *> _listener;
     std::vector<FGNasalListener *> _dead_listener;
 
+    // deferred listeners with pending changes, called once per update
+    std::vector<FGNasalListener *> _deferredListeners;
+    void queueDeferredListener(FGNasalListener* l);
+    void fireDeferredListeners();
+
+    SGPropertyNode_ptr _deferredCalls;
+    SGPropertyNode_ptr _deferredTime;
+
     std::vector<FGNasalModuleListener*> _moduleListeners;
 
     static int _listenerId;
@@ -203,19 +234,31 @@ private:
 
     naRef _wrappedNodeFunc;
 
-    // track NasalTimer instances (created via settimer() call) -
-    // this allows us to clean these up on shutdown
-    std::vector<NasalTimer*> _nasalTimers;
+    // Pending settimer() and maketimer() callbacks, one queue per clock.
+    // NasalTimer instances (created via settimer() call) are owned by us
+    // while queued, which allows us to clean these up on shutdown.
+    NasalTimerQueue _simTimers;
+    NasalTimerQueue _realTimers;
+
+    NasalTimerQueue& timerQueue(bool simTime)
+    { return simTime ? _simTimers : _realTimers; }
+
+    void fireTimers(double dt);
+
+    SGPropertyNode_ptr _timerCallbacks;
+    SGPropertyNode_ptr _timerTime;
+    SGPropertyNode_ptr _timerPending;
+    SGPropertyNode_ptr _realDeltaTime;
 
     // NasalTimer is a friend to invoke handleTimer and do the actual
     // dispatch of the settimer-d callback
     friend NasalTimer;
 
-    void handleTimer(NasalTimer* t);
+    void handleTimer(NasalTimer* t, naContext ctx);
 
     // track persistent timers. These are owned from the Nasal side, so we
     // only track a non-owning reference here.
-    std::vector<TimerObj*> _persistentTimers;
+    std::set<TimerObj*> _persistentTimers;
 
     friend TimerObj;
 
@@ -223,6 +266,9 @@ private:
     void removePersistentTimer(TimerObj* obj);
 
     static void logNasalStack(naContext context);
+
+    NasalProfiler _profiler;
+    bool profilerCommand(const SGPropertyNode* arg, SGPropertyNode* root);
 };
 
 #if 0
@@ -20,6 +20,9 @@
 #include <simgear/nasal/nasal.h>
 #include <simgear/xml/easyxml.hxx>
 
+#include "NasalProfiler.hxx"
+#include "NasalTimerQueue.hxx"
+
 class FGNasalListener : public SGPropertyChangeListener {
 public:
     FGNasalListener(SGPropertyNode* node, naRef code, FGNasalSys* nasal,
@@ -29,10 +32,23 @@ public:
     virtual void valueChanged(SGPropertyNode* node);
     virtual void childAdded(SGPropertyNode* parent, SGPropertyNode* child);
     virtual void childRemoved(SGPropertyNode* parent, SGPropertyNode* child);
-    
+
+    /**
+     * In deferred mode, value changes are not passed to Nasal as they
+     * happen.  The listener is only marked dirty, and called once from
+     * FGNasalSys::update() with the final value of the frame.  Child
+     * added/removed events are always delivered immediately.
+     */
+    void setDeferred(bool deferred)
+    { _deferred = deferred; }
+
+    bool isDeferred() const
+    { return _deferred; }
+
 private:
     bool changed(SGPropertyNode* node);
     void call(SGPropertyNode* which, naRef mode);
+    void callDeferred();
     
     friend class FGNasalSys;
     SGPropertyNode_ptr _node;
@@ -47,6 +63,16 @@ private:
     long _last_int;
     double _last_float;
     std::string _last_string;
+
+    bool _deferred = false;
+    bool _dirty = false;
+    SGPropertyNode_ptr _dirtyNode;
+
+    // profiling counters, see listenerstats()
+    NasalProfiler::Site _site; ///< where setlistener() was called
+    unsigned long _notifications = 0;
+    unsigned long _calls = 0;
+    double _callTimeMs = 0.0;
 };
 
 
@@ -72,14 +98,15 @@ private:
 // See the implementation of the settimer() extension function for
 // more notes.
 //
-struct NasalTimer
+struct NasalTimer : public NasalTimerQueue::Entry
 {
     NasalTimer(naRef handler, FGNasalSys* sys);
     
-    void timerExpired();
+    void expired(naContext ctx) override;
     ~NasalTimer();
     
     naRef handler;
+    std::string site; ///< where settimer() was called, if profiling
     int gcKey = 0;
     FGNasalSys* nasal = nullptr;
 };
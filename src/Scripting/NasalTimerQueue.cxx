@@ -0,0 +1,165 @@
+// NasalTimerQueue.cxx -- binary heap scheduling settimer/maketimer callbacks
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "NasalTimerQueue.hxx"
+
+#include <cassert>
+
+NasalTimerQueue::Entry::~Entry()
+{
+    if (_queue) {
+        _queue->cancel(this);
+    }
+}
+
+NasalTimerQueue::NasalTimerQueue()
+{
+}
+
+NasalTimerQueue::~NasalTimerQueue()
+{
+    // entries are not owned, but must not point back at us
+    for (auto e : _heap) {
+        e->_queue = nullptr;
+        e->_index = -1;
+    }
+}
+
+void NasalTimerQueue::schedule(Entry* entry, double delay)
+{
+    if (entry->_queue) {
+        entry->_queue->cancel(entry);
+    }
+
+    entry->_queue = this;
+    entry->_due = _now + delay;
+    entry->_seq = _nextSeq++;
+    entry->_firing = false;
+
+    _heap.push_back(entry);
+    place(entry, _heap.size() - 1);
+    siftUp(_heap.size() - 1);
+}
+
+void NasalTimerQueue::cancel(Entry* entry)
+{
+    if (entry->_queue != this) {
+        return;
+    }
+
+    if (entry->_firing) {
+        // already collected into the running batch; just skip it there
+        _batch[entry->_index] = nullptr;
+    } else {
+        removeAt(entry->_index);
+    }
+
+    entry->_queue = nullptr;
+    entry->_index = -1;
+    entry->_firing = false;
+}
+
+unsigned int NasalTimerQueue::fireExpired(naContext ctx)
+{
+    assert(_batch.empty());
+
+    // Collect everything due first, so that callbacks scheduling new
+    // zero-delay timers cannot keep us in here forever.
+    while (!_heap.empty() && (_heap.front()->_due <= _now)) {
+        Entry* e = _heap.front();
+        removeAt(0);
+        e->_firing = true;
+        e->_index = static_cast<int>(_batch.size());
+        _batch.push_back(e);
+    }
+
+    unsigned int count = 0;
+    for (size_t i = 0; i < _batch.size(); ++i) {
+        Entry* e = _batch[i];
+        if (!e) {
+            continue; // cancelled by an earlier callback
+        }
+
+        e->_queue = nullptr;
+        e->_index = -1;
+        e->_firing = false;
+        ++count;
+        e->expired(ctx);
+    }
+
+    _batch.clear();
+    return count;
+}
+
+void NasalTimerQueue::removeAt(size_t index)
+{
+    const size_t last = _heap.size() - 1;
+    if (index != last) {
+        Entry* moved = _heap[last];
+        place(moved, index);
+        _heap.pop_back();
+        // the moved entry may belong either above or below its new slot
+        siftUp(index);
+        siftDown(moved->_index);
+    } else {
+        _heap.pop_back();
+    }
+}
+
+void NasalTimerQueue::siftUp(size_t index)
+{
+    Entry* e = _heap[index];
+    while (index > 0) {
+        const size_t parent = (index - 1) / 2;
+        if (!before(e, _heap[parent])) {
+            break;
+        }
+
+        place(_heap[parent], index);
+        index = parent;
+    }
+
+    place(e, index);
+}
+
+void NasalTimerQueue::siftDown(size_t index)
+{
+    Entry* e = _heap[index];
+    const size_t count = _heap.size();
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= count) {
+            break;
+        }
+
+        if ((child + 1 < count) && before(_heap[child + 1], _heap[child])) {
+            ++child;
+        }
+
+        if (!before(_heap[child], e)) {
+            break;
+        }
+
+        place(_heap[child], index);
+        index = child;
+    }
+
+    place(e, index);
+}
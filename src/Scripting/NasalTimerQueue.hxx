@@ -0,0 +1,143 @@
+// NasalTimerQueue.hxx -- binary heap scheduling settimer/maketimer callbacks
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef SCRIPTING_NASAL_TIMER_QUEUE_HXX
+#define SCRIPTING_NASAL_TIMER_QUEUE_HXX
+
+#include <cstddef>
+#include <vector>
+
+#include <simgear/nasal/nasal.h>
+
+/**
+ * Scheduling queue for Nasal timers, one per clock (simulated or real time).
+ *
+ * Timers used to be individual SGEventMgr events tracked in a std::vector,
+ * which made every expiry a linear search.  Here the pending entries live in
+ * a binary heap ordered by due time; every entry knows its own heap slot, so
+ * schedule() and cancel() are O(log n).  Expired entries are collected in a
+ * batch and fired back-to-back from FGNasalSys::update() in one context.
+ */
+class NasalTimerQueue
+{
+public:
+    /**
+     * Something which can be put on the queue.  Entries are not owned by
+     * the queue.
+     */
+    class Entry
+    {
+    public:
+        virtual ~Entry();
+
+        /**
+         * Called once the due time is reached.  The entry is no longer
+         * scheduled at this point and may re-schedule (or delete) itself.
+         */
+        virtual void expired(naContext ctx) = 0;
+
+        bool isScheduled() const
+        { return _queue != nullptr; }
+
+    private:
+        friend class NasalTimerQueue;
+
+        NasalTimerQueue* _queue = nullptr;
+        double _due = 0.0;
+        unsigned long _seq = 0;
+        // slot in the heap, or in the batch while it is being fired
+        int _index = -1;
+        bool _firing = false;
+    };
+
+    NasalTimerQueue();
+    ~NasalTimerQueue();
+
+    /**
+     * Advance the queue clock.
+     */
+    void advance(double dt)
+    { _now += dt; }
+
+    double now() const
+    { return _now; }
+
+    /**
+     * Schedule entry to expire delay seconds from now.  An entry which is
+     * already scheduled is moved to the new due time.
+     */
+    void schedule(Entry* entry, double delay);
+
+    /**
+     * Remove entry from the queue, including from a batch currently being
+     * fired.  Does nothing if the entry is not scheduled.
+     */
+    void cancel(Entry* entry);
+
+    /**
+     * Fire every entry which is due, in due time order.  Entries scheduled
+     * by the callbacks themselves are kept for the next call, even with a
+     * zero delay.
+     *
+     * @return number of entries fired
+     */
+    unsigned int fireExpired(naContext ctx);
+
+    /**
+     * Drop all entries, calling deleteEntry on each of them.
+     */
+    template <class Deleter>
+    void clear(Deleter deleteEntry)
+    {
+        std::vector<Entry*> entries;
+        entries.swap(_heap);
+        for (auto e : entries) {
+            e->_queue = nullptr;
+            e->_index = -1;
+            deleteEntry(e);
+        }
+    }
+
+    size_t size() const
+    { return _heap.size(); }
+
+    bool empty() const
+    { return _heap.empty(); }
+
+private:
+    bool before(const Entry* a, const Entry* b) const
+    {
+        return (a->_due < b->_due) ||
+               ((a->_due == b->_due) && (a->_seq < b->_seq));
+    }
+
+    void place(Entry* e, size_t index)
+    {
+        _heap[index] = e;
+        e->_index = static_cast<int>(index);
+    }
+
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+    void removeAt(size_t index);
+
+    std::vector<Entry*> _heap;
+    std::vector<Entry*> _batch;
+    double _now = 0.0;
+    unsigned long _nextSeq = 0;
+};
+
+#endif // of SCRIPTING_NASAL_TIMER_QUEUE_HXX
@@ -62,6 +62,7 @@ SGPropertyNode* ghostToPropNode(naRef ref)
 //   Node.getChild = func { _getChild(me.ghost, arg) }
 //
 #define NODENOARG()                                                            \
+    NasalProfiler::sample(c);                                                  \
     if(argc < 2 || !naIsGhost(args[0]) ||                                      \
         naGhost_type(args[0]) != &PropNodeGhostType)                           \
         naRuntimeError(c, "bad argument to props function");                   \
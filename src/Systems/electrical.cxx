@@ -24,8 +24,10 @@
 #  include <config.h>
 #endif
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <map>
 
 #include <simgear/structure/exception.hxx>
 #include <simgear/misc/sg_path.hxx>
@@ -42,7 +44,8 @@ FGElectricalComponent::FGElectricalComponent() :
     kind(-1),
     name(""),
     volts(0.0),
-    load_amps(0.0)
+    load_amps(0.0),
+    available_amps(0.0)
 {
 }
 
@@ -369,6 +372,13 @@ void FGElectricalSystem::init () {
     _volts_out = fgGetNode( "/systems/electrical/volts", true );
     _amps_out = fgGetNode( "/systems/electrical/amps", true );
 
+    _alternator_node = fgGetNode( "/systems/electrical/suppliers/alternator", true );
+    _master_bat_node = fgGetNode( "/controls/engines/engine[0]/master-bat", true );
+    _master_alt_node = fgGetNode( "/controls/engines/engine[0]/master-alt", true );
+    _engine_rpm_node = fgGetNode( "/engines/engine[0]/rpm", true );
+    _beacon_node = fgGetNode( "/controls/switches/flashing-beacon", true );
+    _nav_lights_node = fgGetNode( "/controls/switches/nav-lights", true );
+
     // allow the electrical system to be specified via the
     // aircraft-set.xml file (for backwards compatibility) or through
     // the aircraft-systems.xml file.  If a -set.xml entry is
@@ -396,6 +406,7 @@ void FGElectricalSystem::init () {
             readProperties( config, config_props );
 
             if ( build(config_props) ) {
+                compile();
                 enabled = true;
             } else {
                 throw sg_exception("Logic error in electrical system file.");
@@ -437,102 +448,25 @@ void FGElectricalSystem::update (double dt)
 
     // cout << "Updating electrical system, dt = " << dt << endl;
     _serviceable = _serviceable_node->getBoolValue();
-    
-    unsigned int i;
-
-    // zero out the voltage before we start, but don't clear the
-    // requested load values.
-    for ( i = 0; i < suppliers.size(); ++i ) {
-        suppliers[i]->set_volts( 0.0 );
-    }
-    for ( i = 0; i < buses.size(); ++i ) {
-        buses[i]->set_volts( 0.0 );
-    }
-    for ( i = 0; i < outputs.size(); ++i ) {
-        outputs[i]->set_volts( 0.0 );
-    }
-    for ( i = 0; i < connectors.size(); ++i ) {
-        connectors[i]->set_volts( 0.0 );
-    }
-
-    // for each "external" supplier, propagate the electrical current
-    for ( i = 0; i < suppliers.size(); ++i ) {
-        FGElectricalSupplier *node = (FGElectricalSupplier *)suppliers[i];
-        if ( node->get_model() == FGElectricalSupplier::FG_EXTERNAL ) {
-            float load;
-            // cout << "Starting propagation: " << suppliers[i]->get_name()
-            //      << endl;
-            load = propagate( suppliers[i], dt,
-                              node->get_output_volts(),
-                              node->get_output_amps(),
-                              " " );
-
-            if ( node->apply_load( load, dt ) < 0.0 ) {
-                SG_LOG(SG_SYSTEMS, SG_ALERT,
-                       "Error drawing more current than available!");
-            }
-        }
-    }
-
-    // for each "alternator" supplier, propagate the electrical
-    // current
-    for ( i = 0; i < suppliers.size(); ++i ) {
-        FGElectricalSupplier *node = (FGElectricalSupplier *)suppliers[i];
-        if ( node->get_model() == FGElectricalSupplier::FG_ALTERNATOR) {
-            float load;
-            // cout << "Starting propagation: " << suppliers[i]->get_name()
-            //      << endl;
-            load = propagate( suppliers[i], dt,
-                              node->get_output_volts(),
-                              node->get_output_amps(),
-                              " " );
-
-            if ( node->apply_load( load, dt ) < 0.0 ) {
-                SG_LOG(SG_SYSTEMS, SG_ALERT,
-                       "Error drawing more current than available!");
-            }
-        }
-    }
-
-    // for each "battery" supplier, propagate the electrical
-    // current
-    for ( i = 0; i < suppliers.size(); ++i ) {
-        FGElectricalSupplier *node = (FGElectricalSupplier *)suppliers[i];
-        if ( node->get_model() == FGElectricalSupplier::FG_BATTERY ) {
-            float load;
-            // cout << "Starting propagation: " << suppliers[i]->get_name()
-            //      << endl;
-            load = propagate( suppliers[i], dt,
-                              node->get_output_volts(),
-                              node->get_output_amps(),
-                              " " );
-            // cout << "battery load = " << load << endl;
-
-            if ( node->apply_load( load, dt ) < 0.0 ) {
-                SG_LOG(SG_SYSTEMS, SG_ALERT,
-                       "Error drawing more current than available!");
-            }
-        }
-    }
+    solve( dt );
 
-    float alt_norm
-        = fgGetFloat("/systems/electrical/suppliers/alternator") / 60.0;
+    float alt_norm = _alternator_node->getFloatValue() / 60.0;
 
     // impliment an extremely simplistic voltage model (assumes
     // certain naming conventions in electrical system config)
     // FIXME: we probably want to be able to feed power from all
     // engines if they are running and the master-alt is switched on
     float volts = 0.0;
-    if ( fgGetBool("/controls/engines/engine[0]/master-bat") ) {
+    if ( _master_bat_node->getBoolValue() ) {
         volts = 24.0;
     }
-    if ( fgGetBool("/controls/engines/engine[0]/master-alt") ) {
-        if ( fgGetFloat("/engines/engine[0]/rpm") > 800 ) {
+    if ( _master_alt_node->getBoolValue() ) {
+        if ( _engine_rpm_node->getFloatValue() > 800 ) {
             float alt_contrib = 28.0;
             if ( alt_contrib > volts ) {
                 volts = alt_contrib;
             }
-        } else if ( fgGetFloat("/engines/engine[0]/rpm") > 200 ) {
+        } else if ( _engine_rpm_node->getFloatValue() > 200 ) {
             float alt_contrib = 20.0;
             if ( alt_contrib > volts ) {
                 volts = alt_contrib;
@@ -545,17 +479,17 @@ void FGElectricalSystem::update (double dt)
     // naming conventions in the electrical system config) ... FIXME:
     // make this more generic
     float amps = 0.0;
-    if ( fgGetBool("/controls/engines/engine[0]/master-bat") ) {
-        if ( fgGetBool("/controls/engines/engine[0]/master-alt") &&
-             fgGetFloat("/engines/engine[0]/rpm") > 800 )
+    if ( _master_bat_node->getBoolValue() ) {
+        if ( _master_alt_node->getBoolValue() &&
+             _engine_rpm_node->getFloatValue() > 800 )
         {
             amps += 40.0 * alt_norm;
         }
         amps -= 15.0;            // normal load
-        if ( fgGetBool("/controls/switches/flashing-beacon") ) {
+        if ( _beacon_node->getBoolValue() ) {
             amps -= 7.5;
         }
-        if ( fgGetBool("/controls/switches/nav-lights") ) {
+        if ( _nav_lights_node->getBoolValue() ) {
             amps -= 7.5;
         }
         if ( amps > 7.0 ) {
@@ -602,98 +536,244 @@ bool FGElectricalSystem::build (SGPropertyNode* config_props) {
 }
 
 
+// number the components in the order the suppliers reach them, and
+// flatten their connections into index arrays
+void FGElectricalSystem::compile ()
+{
+    std::vector<FGElectricalComponent *> order;
+    std::map<FGElectricalComponent *, int> index;
+
+    _supplier_order.clear();
+    const FGElectricalSupplier::FGSupplierType supplier_models[] = {
+        FGElectricalSupplier::FG_EXTERNAL,
+        FGElectricalSupplier::FG_ALTERNATOR,
+        FGElectricalSupplier::FG_BATTERY
+    };
+
+    // depth first, in the order solve() first reaches them
+    std::vector<FGElectricalComponent *> pending;
+    auto visit = [&]( FGElectricalComponent *root ) {
+        pending.push_back( root );
+        while ( !pending.empty() ) {
+            FGElectricalComponent *c = pending.back();
+            pending.pop_back();
+            if ( index.count( c ) ) {
+                continue;
+            }
+
+            index[c] = order.size();
+            order.push_back( c );
+            for ( int o = c->get_num_outputs() - 1; o >= 0; --o ) {
+                pending.push_back( c->get_output( o ) );
+            }
+        }
+    };
+
+    for ( auto model : supplier_models ) {
+        for ( auto c : suppliers ) {
+            if ( ((FGElectricalSupplier *)c)->get_model() == model ) {
+                visit( c );
+            }
+        }
+    }
+
+    // anything not connected to a supplier
+    for ( const comp_list *list : { &suppliers, &buses, &outputs, &connectors } ) {
+        for ( auto c : *list ) {
+            visit( c );
+        }
+    }
+
+    for ( auto model : supplier_models ) {
+        for ( auto c : suppliers ) {
+            if ( ((FGElectricalSupplier *)c)->get_model() == model ) {
+                _supplier_order.push_back( index[c] );
+            }
+        }
+    }
+
+    _nodes.clear();
+    _node_outputs.clear();
+    _switch_nodes.clear();
+    _prop_nodes.clear();
+    _load_amps.clear();
+
+    for ( auto c : order ) {
+        Node n;
+        n.component = c;
+        n.kind = c->get_kind();
+        n.supplier = (n.kind == FGElectricalComponent::FG_SUPPLIER) ?
+            (FGElectricalSupplier *)c : nullptr;
+        n.battery = n.supplier &&
+            (n.supplier->get_model() == FGElectricalSupplier::FG_BATTERY);
+
+        n.first_output = _node_outputs.size();
+        for ( int o = 0; o < c->get_num_outputs(); ++o ) {
+            _node_outputs.push_back( index[c->get_output( o )] );
+        }
+        n.end_output = _node_outputs.size();
+
+        n.first_switch = _switch_nodes.size();
+        if ( n.kind == FGElectricalComponent::FG_CONNECTOR ) {
+            for ( const auto& sw : ((FGElectricalConnector *)c)->get_switches() ) {
+                _switch_nodes.push_back( sw.get_node() );
+            }
+        }
+        n.end_switch = _switch_nodes.size();
+
+        n.first_prop = _prop_nodes.size();
+        for ( const auto& prop : c->get_props() ) {
+            _prop_nodes.push_back( prop );
+        }
+        n.end_prop = _prop_nodes.size();
+
+        _nodes.push_back( n );
+        _load_amps.push_back( c->get_load_amps() );
+    }
+
+    _volts.assign( _nodes.size(), 0.0 );
+    _stack.reserve( _nodes.size() );
+}
+
+
+void FGElectricalSystem::solve (double dt)
+{
+    // zero out the voltage before we start, but don't clear the
+    // requested load values.
+    std::fill( _volts.begin(), _volts.end(), 0.0 );
+
+    // propagate the electrical current from the "external" suppliers,
+    // then the alternators, then the batteries
+    for ( int i : _supplier_order ) {
+        FGElectricalSupplier *node = _nodes[i].supplier;
+        float load = propagateCompiled( i, dt,
+                                        node->get_output_volts(),
+                                        node->get_output_amps() );
+
+        if ( node->apply_load( load, dt ) < 0.0 ) {
+            SG_LOG(SG_SYSTEMS, SG_ALERT,
+                   "Error drawing more current than available!");
+        }
+    }
+
+    // the components keep the voltage they ended up with
+    for ( size_t i = 0; i < _nodes.size(); ++i ) {
+        _nodes[i].component->set_volts( _volts[i] );
+    }
+}
+
+
 // propagate the electrical current through the network, returns the
 // total current drawn by the children of this node.
-float FGElectricalSystem::propagate( FGElectricalComponent *node, double dt,
-                                     float input_volts, float input_amps,
-                                     string s ) {
-    s += " ";
+float FGElectricalSystem::propagateCompiled( int node, double dt,
+                                             float input_volts,
+                                             float input_amps )
+{
+    float load = 0.0;
+    if ( !enter( node, dt, input_volts, input_amps, load ) ) {
+        return load;
+    }
+
+    while ( !_stack.empty() ) {
+        Frame& f = _stack.back();
+        if ( f.next_output < _nodes[f.node].end_output ) {
+            // send current equal to load
+            const int child = _node_outputs[f.next_output++];
+            if ( enter( child, dt, f.volts, _load_amps[child], load ) ) {
+                continue; // f is invalid now
+            }
+
+            f.total_load += load;
+            continue;
+        }
+
+        // all children done
+        const Node& n = _nodes[f.node];
+        const float total_load = f.total_load;
+        if ( n.kind != FGElectricalComponent::FG_OUTPUT ) {
+            _load_amps[f.node] = total_load;
+            n.component->set_load_amps( total_load );
+        }
+        n.component->set_available_amps( f.input_amps - total_load );
 
+        const float volts = _volts[f.node];
+        for ( int p = n.first_prop; p < n.end_prop; ++p ) {
+            _prop_nodes[p]->setFloatValue( volts );
+        }
+
+        _stack.pop_back();
+        if ( _stack.empty() ) {
+            return total_load;
+        }
+        _stack.back().total_load += total_load;
+    }
+
+    return 0.0;
+}
+
+
+// the part of propagateCompiled() before the children are visited:
+// returns true if the node takes the voltage and a frame was pushed for
+// it, otherwise its load is returned right away
+bool FGElectricalSystem::enter( int node, double dt,
+                                float input_volts, float input_amps,
+                                float& load )
+{
+    const Node& n = _nodes[node];
     float total_load = 0.0;
 
     // determine the current to carry forward
     float volts = 0.0;
     if ( !_serviceable) {
         volts = 0;
-    } else if ( node->get_kind() == FGElectricalComponent::FG_SUPPLIER ) {
-        // cout << s << "is a supplier (" << node->get_name() << ")" << endl;
-        FGElectricalSupplier *supplier = (FGElectricalSupplier *)node;
-        if ( supplier->get_model() == FGElectricalSupplier::FG_BATTERY ) {
-            // cout << s << " (and is a battery)" << endl;
-            float battery_volts = supplier->get_output_volts();
+    } else if ( n.kind == FGElectricalComponent::FG_SUPPLIER ) {
+        if ( n.battery ) {
+            float battery_volts = n.supplier->get_output_volts();
             if ( battery_volts < (input_volts - 0.1) ) {
                 // special handling of a battery charge condition
-                // cout << s << "  (and is being charged) in v = "
-                //      << input_volts << " current v = " << battery_volts
-                //      << endl;
-                supplier->apply_load( -supplier->get_charge_amps(), dt );
-                return supplier->get_charge_amps();
+                n.supplier->apply_load( -n.supplier->get_charge_amps(), dt );
+                load = n.supplier->get_charge_amps();
+                return false;
             }
         }
         volts = input_volts;
-    } else if ( node->get_kind() == FGElectricalComponent::FG_BUS ) {
-        // cout << s << "is a bus (" << node->get_name() << ")" << endl;
+    } else if ( n.kind == FGElectricalComponent::FG_BUS ) {
         volts = input_volts;
-    } else if ( node->get_kind() == FGElectricalComponent::FG_OUTPUT ) {
-        // cout << s << "is an output (" << node->get_name() << ")" << endl;
+    } else if ( n.kind == FGElectricalComponent::FG_OUTPUT ) {
         volts = input_volts;
         if ( volts > 1.0 ) {
             // draw current if we have voltage
-            total_load = node->get_load_amps();
+            total_load = _load_amps[node];
         }
-    } else if ( node->get_kind() == FGElectricalComponent::FG_CONNECTOR ) {
-        // cout << s << "is a connector (" << node->get_name() << ")" << endl;
-        if ( ((FGElectricalConnector *)node)->get_state() ) {
-            volts = input_volts;
-        } else {
-            volts = 0.0;
+    } else if ( n.kind == FGElectricalComponent::FG_CONNECTOR ) {
+        // all switches need to be closed for current to get through
+        volts = input_volts;
+        for ( int s = n.first_switch; s < n.end_switch; ++s ) {
+            if ( !_switch_nodes[s]->getBoolValue() ) {
+                volts = 0.0;
+                break;
+            }
         }
-        // cout << s << "  input_volts = " << volts << endl;
     } else {
         SG_LOG( SG_SYSTEMS, SG_ALERT, "unknown node type" );
     }
 
-    int i;
-
     // if this node has found a stronger power source, update the
     // value and propagate to all children
-    if ( volts > node->get_volts() ) {
-        node->set_volts( volts );
-        for ( i = 0; i < node->get_num_outputs(); ++i ) {
-            FGElectricalComponent *child = node->get_output(i);
-            // send current equal to load
-            total_load += propagate( child, dt,
-                                     volts, child->get_load_amps(),
-                                     s );
-        }
-
-        // if not an output node, register the downstream current draw
-        // (sum of all children) with this node.  If volts are zero,
-        // current draw should be zero.
-        if ( node->get_kind() != FGElectricalComponent::FG_OUTPUT ) {
-            node->set_load_amps( total_load );
-        }
-
-        node->set_available_amps( input_amps - total_load );
-
-        node->publishVoltageToProps();
-
-        /*
-        cout << s << node->get_name() << " -> (volts) " << node->get_volts()
-             << endl;
-        cout << s << node->get_name() << " -> (load amps) " << total_load
-             << endl;
-        cout << s << node->get_name() << " -> (input amps) " << input_amps
-             << endl;
-        cout << s << node->get_name() << " -> (extra amps) "
-             << node->get_available_amps() << endl;
-        */
-
-        return total_load;
-    } else {
-        // cout << s << "no further propagation" << endl;
-        return 0.0;
-    }
+    if ( volts > _volts[node] ) {
+        _volts[node] = volts;
+        Frame f;
+        f.node = node;
+        f.next_output = n.first_output;
+        f.volts = volts;
+        f.input_amps = input_amps;
+        f.total_load = total_load;
+        _stack.push_back( f );
+        return true;
+    }
+
+    load = 0.0;
+    return false;
 }
 
 
@@ -98,6 +98,7 @@ public:
     }
 
     void add_prop( const std::string &s );
+    inline const simgear::PropertyList& get_props() const { return props; }
     
     void publishVoltageToProps() const;
 
@@ -180,6 +181,7 @@ public:
     ~FGElectricalSwitch() { };
 
     inline bool get_state() const { return switch_node->getBoolValue(); }
+    inline SGPropertyNode* get_node() const { return switch_node; }
     void set_state( bool val ) { switch_node->setBoolValue( val ); }
 };
 
@@ -188,9 +190,12 @@ public:
 // switches/fuses/circuit breakers inline
 class FGElectricalConnector : public FGElectricalComponent
 {
+public:
+    typedef vector< FGElectricalSwitch> switch_list;
+
+private:
     comp_list inputs;
     comp_list outputs;
-    typedef vector< FGElectricalSwitch> switch_list;
     switch_list switches;
 
 public:
@@ -205,6 +210,7 @@ public:
     void set_switches( bool state );
 
     bool get_state();
+    inline const switch_list& get_switches() const { return switches; }
 };
 
 
@@ -229,15 +235,55 @@ public:
     static const char* staticSubsystemClassId() { return "electrical"; }
 
     bool build (SGPropertyNode* config_props);
-    float propagate( FGElectricalComponent *node, double dt,
-                     float input_volts, float input_amps,
-                     std::string s = "" );
     FGElectricalComponent *find ( const std::string &name );
 
 protected:
     typedef vector<FGElectricalComponent *> comp_list;
 
 private:
+    // The network flattened by compile(): components are numbered in the
+    // order they are first reached from the suppliers, with their outputs,
+    // switches and properties in shared arrays.  solve() walks it with an
+    // explicit stack, depth first from each supplier in turn, in exactly
+    // the order the recursive solver it replaced did, as the results
+    // (which source feeds a bus, the load each supplier sees) depend on
+    // that order.
+    struct Node
+    {
+        FGElectricalComponent *component;
+        FGElectricalSupplier *supplier; // suppliers only
+        int kind;
+        bool battery;
+        int first_output, end_output;   // into _node_outputs
+        int first_switch, end_switch;   // into _switch_nodes
+        int first_prop, end_prop;       // into _prop_nodes
+    };
+
+    struct Frame
+    {
+        int node;
+        int next_output;
+        float volts;
+        float input_amps;
+        float total_load;
+    };
+
+    void compile();
+    void solve( double dt );
+    float propagateCompiled( int node, double dt,
+                             float input_volts, float input_amps );
+    bool enter( int node, double dt, float input_volts, float input_amps,
+                float& load );
+
+    std::vector<Node> _nodes;
+    std::vector<int> _node_outputs;
+    std::vector<SGPropertyNode*> _switch_nodes;
+    std::vector<SGPropertyNode*> _prop_nodes;
+    std::vector<int> _supplier_order;   // externals, alternators, batteries
+    std::vector<float> _volts;
+    std::vector<float> _load_amps;
+    std::vector<Frame> _stack;
+
     std::string name;
     int num;
     std::string path;
@@ -251,6 +297,14 @@ private:
 
     SGPropertyNode_ptr _volts_out;
     SGPropertyNode_ptr _amps_out;
+
+    // inputs of the simplistic volts/amps model
+    SGPropertyNode_ptr _alternator_node;
+    SGPropertyNode_ptr _master_bat_node;
+    SGPropertyNode_ptr _master_alt_node;
+    SGPropertyNode_ptr _engine_rpm_node;
+    SGPropertyNode_ptr _beacon_node;
+    SGPropertyNode_ptr _nav_lights_node;
     SGPropertyNode_ptr _serviceable_node;
     bool _serviceable = true;
 };
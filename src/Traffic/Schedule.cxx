@@ -67,6 +67,7 @@ FGAISchedule::FGAISchedule()
     radius(0),
     groundOffset(0),
     distanceToUser(0),
+    nextEvent(0),
     score(0),
     runCount(0),
     hits(0),
@@ -96,6 +97,7 @@ FGAISchedule::FGAISchedule(const string& model,
       radius(rad),
       groundOffset(grnd),
       distanceToUser(0),
+      nextEvent(0),
       score(0),
       runCount(0),
       hits(0),
@@ -140,6 +142,7 @@ FGAISchedule::FGAISchedule(const FGAISchedule &other)
   flightType         = other.flightType;
   score              = other.score;
   distanceToUser     = other.distanceToUser;
+  nextEvent          = other.nextEvent;
   currentDestination = other.currentDestination;
   firstRun           = other.firstRun;
   runCount           = other.runCount;
@@ -207,6 +210,10 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
          //remainingTimeEnroute,
          deptime = 0;
 
+  // assume there is more to do straight away, unless found otherwise
+  nextEvent = 0;
+  distanceToUser = 0.0;
+
   if (!valid) {
     return true; // processing complete
   }
@@ -248,6 +255,7 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
     if (aiAircraft->getDie()) {
       aiAircraft = NULL;
     } else {
+      nextEvent = now + AI_AIRCRAFT_CHECK_INTERVAL;
       return true; // in visual range, let the AIManager handle it
     }
   }
@@ -264,6 +272,10 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
     return true; // processing complete
   }
   
+  // nothing changes for a distant aircraft until it departs or arrives
+  nextEvent = (flight->getDepartureTime() > now) ? flight->getDepartureTime()
+                                                  : flight->getArrivalTime();
+
   FGAirport* dep = flight->getDepartureAirport();
   FGAirport* arr = flight->getArrivalAirport();
   if (!dep || !arr) {
@@ -324,6 +336,8 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
       valid = false;
   }
 
+  nextEvent = now + AI_AIRCRAFT_CHECK_INTERVAL;
+
 
     return true; // processing complete
 }
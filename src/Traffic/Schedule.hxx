@@ -32,6 +32,9 @@
 #define TRAFFICTOAIDISTTOSTART 150.0
 #define TRAFFICTOAIDISTTODIE   200.0
 
+// seconds between checks whether our AI aircraft is still alive
+#define AI_AIRCRAFT_CHECK_INTERVAL 10
+
 // forward decls
 class FGAIAircraft;
 class FGScheduledFlight;
@@ -57,6 +60,7 @@ class FGAISchedule
   double radius;
   double groundOffset;
   double distanceToUser;
+  time_t nextEvent;
   double score;
   unsigned int runCount;
   unsigned int hits;
@@ -102,6 +106,22 @@ class FGAISchedule
     static SGPath resolveModelPath(const std::string& model);
     
   bool update(time_t now, const SGVec3d& userCart);
+
+  /**
+   * When the last update() expects the next change of state, ignoring
+   * the movement of the user: the departure or arrival of the current
+   * flight, or a periodic check of the AI aircraft.  0 if update() has
+   * more to do straight away.
+   */
+  time_t getNextEventTime() const { return nextEvent; };
+
+  /**
+   * Distance of the current flight to the user as of the last update(),
+   * in nm; 0 if update() did not get as far as computing it.
+   */
+  double getDistanceToUser() const { return distanceToUser; };
+
+  bool isValid() const { return valid; };
   bool init();
 
   double getSpeed         ();
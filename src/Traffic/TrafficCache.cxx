@@ -0,0 +1,551 @@
+// TrafficCache.cxx - binary cache of parsed AI traffic schedules
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "TrafficCache.hxx"
+
+#include <cstring>
+
+#include <simgear/compiler.h>
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+
+#ifdef SG_WINDOWS
+#  include <iterator>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace flightgear
+{
+
+// File layout, all values in host byte order:
+//   "FGTRAFFC", uint32 version, uint32 string count, uint32 entry count
+//   strings: uint32 length, bytes
+//   entries: stamp (uint32 path, int64 mtime), uint32 dependency count,
+//            dependency stamps, uint32 record count, records
+//   records: uint8 type, then the fields as string ids / numbers
+static const char CACHE_MAGIC[8] = {'F', 'G', 'T', 'R', 'A', 'F', 'F', 'C'};
+static const uint32_t CACHE_VERSION = 1;
+
+enum RecordType : uint8_t {
+    RECORD_FLIGHT = 0,
+    RECORD_AIRCRAFT = 1
+};
+
+static const size_t FLIGHT_SIZE = 8 * sizeof(uint32_t) + sizeof(int32_t);
+static const size_t AIRCRAFT_SIZE = 10 * sizeof(uint32_t) + 2 * sizeof(double) + 1;
+
+static int64_t modTimeOf(const std::string& path)
+{
+    SGPath p = SGPath::fromUtf8(path);
+    return p.exists() ? static_cast<int64_t>(p.modTime()) : -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Read-only view of the cache file.
+ */
+class TrafficCache::Mapping
+{
+public:
+    explicit Mapping(const SGPath& path)
+    {
+#ifdef SG_WINDOWS
+        sg_ifstream in(path, std::ios::in | std::ios::binary);
+        if (in.is_open()) {
+            _buffer.assign(std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>());
+            _data = _buffer.data();
+            _size = _buffer.size();
+        }
+#else
+        const std::string p = path.local8BitStr();
+        int fd = ::open(p.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat st;
+        if ((::fstat(fd, &st) == 0) && (st.st_size > 0)) {
+            void* m = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                _data = static_cast<const char*>(m);
+                _size = st.st_size;
+            }
+        }
+
+        ::close(fd);
+#endif
+    }
+
+    ~Mapping()
+    {
+#ifndef SG_WINDOWS
+        if (_data) {
+            ::munmap(const_cast<char*>(_data), _size);
+        }
+#endif
+    }
+
+    const char* data() const
+    { return _data; }
+
+    size_t size() const
+    { return _size; }
+
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+#ifdef SG_WINDOWS
+    std::vector<char> _buffer;
+#endif
+};
+
+/**
+ * Bounds-checked cursor over the mapping.
+ */
+struct TrafficCache::Reader
+{
+    Reader(const TrafficCache& cache, const char* begin, const char* end) :
+        strings(cache._strings), pos(begin), end(end)
+    {}
+
+    template <class T>
+    T read()
+    {
+        T v = T();
+        if (static_cast<size_t>(end - pos) < sizeof(T)) {
+            ok = false;
+            return v;
+        }
+
+        memcpy(&v, pos, sizeof(T));
+        pos += sizeof(T);
+        return v;
+    }
+
+    void readString(std::string& s)
+    {
+        const uint32_t id = read<uint32_t>();
+        if (id >= strings.size()) {
+            ok = false;
+            s.clear();
+            return;
+        }
+
+        s.assign(strings[id].first, strings[id].second);
+    }
+
+    bool skip(size_t bytes)
+    {
+        if (static_cast<size_t>(end - pos) < bytes) {
+            ok = false;
+        } else {
+            pos += bytes;
+        }
+        return ok;
+    }
+
+    const std::vector<std::pair<const char*, uint32_t> >& strings;
+    const char* pos;
+    const char* end;
+    bool ok = true;
+};
+
+/**
+ * Builds a new cache file in memory.
+ */
+class TrafficCache::Writer : public TrafficCache::Sink
+{
+public:
+    void beginEntry(const Stamp& file, const std::vector<Stamp>& dependencies,
+                    uint32_t recordCount)
+    {
+        ++_entryCount;
+        writeStamp(file);
+        write<uint32_t>(dependencies.size());
+        for (const auto& d : dependencies) {
+            writeStamp(d);
+        }
+        write<uint32_t>(recordCount);
+    }
+
+    void addFlight(const FlightRecord& f) override
+    {
+        write<uint8_t>(RECORD_FLIGHT);
+        writeString(f.callsign);
+        writeString(f.fltRules);
+        writeString(f.departurePort);
+        writeString(f.arrivalPort);
+        writeString(f.departureTime);
+        writeString(f.arrivalTime);
+        writeString(f.repeat);
+        writeString(f.requiredAircraft);
+        write<int32_t>(f.cruiseAlt);
+    }
+
+    void addAircraft(const AircraftRecord& a) override
+    {
+        write<uint8_t>(RECORD_AIRCRAFT);
+        writeString(a.model);
+        writeString(a.livery);
+        writeString(a.homePort);
+        writeString(a.registration);
+        writeString(a.requiredAircraft);
+        writeString(a.acType);
+        writeString(a.airline);
+        writeString(a.perfClass);
+        writeString(a.flightType);
+        writeString(a.lastDeparturePort);
+        write<double>(a.radius);
+        write<double>(a.offset);
+        write<uint8_t>(a.heavy ? 1 : 0);
+    }
+
+    bool save(const SGPath& path) const
+    {
+        SGPath tmp(path);
+        tmp.concat(".new");
+        {
+            sg_ofstream out(tmp, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+
+            std::string header(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+            appendRaw(header, CACHE_VERSION);
+            appendRaw(header, static_cast<uint32_t>(_table.size()));
+            appendRaw(header, _entryCount);
+            out.write(header.data(), header.size());
+
+            std::string strings;
+            for (const auto& s : _table) {
+                appendRaw(strings, static_cast<uint32_t>(s.size()));
+                strings += s;
+            }
+            out.write(strings.data(), strings.size());
+            out.write(_body.data(), _body.size());
+            if (!out.good()) {
+                return false;
+            }
+        }
+
+        if (path.exists()) {
+            SGPath(path).remove();
+        }
+        return tmp.rename(path);
+    }
+
+private:
+    template <class T>
+    static void appendRaw(std::string& buf, T v)
+    {
+        buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    template <class T>
+    void write(T v)
+    { appendRaw(_body, v); }
+
+    void writeString(const std::string& s)
+    {
+        auto it = _ids.find(s);
+        if (it == _ids.end()) {
+            it = _ids.insert(std::make_pair(s, static_cast<uint32_t>(_table.size()))).first;
+            _table.push_back(s);
+        }
+        write<uint32_t>(it->second);
+    }
+
+    void writeStamp(const Stamp& s)
+    {
+        writeString(s.path);
+        write<int64_t>(s.modTime);
+    }
+
+    std::unordered_map<std::string, uint32_t> _ids;
+    std::vector<std::string> _table;
+    std::string _body;
+    uint32_t _entryCount = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+TrafficCache::TrafficCache(const SGPath& cacheFile) :
+    _path(cacheFile)
+{
+}
+
+TrafficCache::~TrafficCache()
+{
+}
+
+void TrafficCache::open()
+{
+    _mapping.reset(new Mapping(_path));
+    if (!_mapping->data() || !indexMapping()) {
+        if (_mapping->data()) {
+            SG_LOG(SG_AI, SG_INFO, "Traffic cache " << _path << " is outdated or damaged, rebuilding");
+        }
+        _mapping.reset();
+        _strings.clear();
+        _entries.clear();
+    }
+}
+
+bool TrafficCache::indexMapping()
+{
+    const char* begin = _mapping->data();
+    const char* end = begin + _mapping->size();
+    if ((_mapping->size() < sizeof(CACHE_MAGIC)) ||
+        memcmp(begin, CACHE_MAGIC, sizeof(CACHE_MAGIC)))
+    {
+        return false;
+    }
+
+    Reader r(*this, begin + sizeof(CACHE_MAGIC), end);
+    if (r.read<uint32_t>() != CACHE_VERSION) {
+        return false;
+    }
+
+    const uint32_t stringCount = r.read<uint32_t>();
+    const uint32_t entryCount = r.read<uint32_t>();
+    _strings.reserve(stringCount);
+    for (uint32_t i = 0; r.ok && (i < stringCount); ++i) {
+        const uint32_t len = r.read<uint32_t>();
+        const char* s = r.pos;
+        if (r.skip(len)) {
+            _strings.push_back(std::make_pair(s, len));
+        }
+    }
+
+    for (uint32_t i = 0; r.ok && (i < entryCount); ++i) {
+        const size_t offset = r.pos - begin;
+        std::string path;
+        r.readString(path);
+        r.skip(sizeof(int64_t));
+        const uint32_t depCount = r.read<uint32_t>();
+        r.skip(depCount * (sizeof(uint32_t) + sizeof(int64_t)));
+
+        const uint32_t recordCount = r.read<uint32_t>();
+        for (uint32_t j = 0; r.ok && (j < recordCount); ++j) {
+            switch (r.read<uint8_t>()) {
+            case RECORD_FLIGHT:
+                r.skip(FLIGHT_SIZE);
+                break;
+            case RECORD_AIRCRAFT:
+                r.skip(AIRCRAFT_SIZE);
+                break;
+            default:
+                return false; // damaged, or written by a newer version
+            }
+        }
+
+        _entries[path] = offset;
+    }
+
+    return r.ok && (r.pos == end);
+}
+
+bool TrafficCache::stampsValid(Reader& r) const
+{
+    std::string path;
+    r.readString(path);
+    if (r.read<int64_t>() != modTimeOf(path)) {
+        return false;
+    }
+
+    const uint32_t depCount = r.read<uint32_t>();
+    for (uint32_t i = 0; r.ok && (i < depCount); ++i) {
+        r.readString(path);
+        if (r.read<int64_t>() != modTimeOf(path)) {
+            return false;
+        }
+    }
+
+    return r.ok;
+}
+
+void TrafficCache::replayRecords(Reader& r, Sink& sink) const
+{
+    // re-used between records, so replaying hardly allocates
+    FlightRecord f;
+    AircraftRecord a;
+
+    const uint32_t recordCount = r.read<uint32_t>();
+    for (uint32_t i = 0; r.ok && (i < recordCount); ++i) {
+        // indexMapping() rejected files with any other record type
+        if (r.read<uint8_t>() == RECORD_FLIGHT) {
+            r.readString(f.callsign);
+            r.readString(f.fltRules);
+            r.readString(f.departurePort);
+            r.readString(f.arrivalPort);
+            r.readString(f.departureTime);
+            r.readString(f.arrivalTime);
+            r.readString(f.repeat);
+            r.readString(f.requiredAircraft);
+            f.cruiseAlt = r.read<int32_t>();
+            sink.addFlight(f);
+        } else {
+            r.readString(a.model);
+            r.readString(a.livery);
+            r.readString(a.homePort);
+            r.readString(a.registration);
+            r.readString(a.requiredAircraft);
+            r.readString(a.acType);
+            r.readString(a.airline);
+            r.readString(a.perfClass);
+            r.readString(a.flightType);
+            r.readString(a.lastDeparturePort);
+            a.radius = r.read<double>();
+            a.offset = r.read<double>();
+            a.heavy = r.read<uint8_t>() != 0;
+            sink.addAircraft(a);
+        }
+    }
+}
+
+bool TrafficCache::replay(const SGPath& file, Sink& sink)
+{
+    const std::string key = file.utf8Str();
+    auto it = _entries.find(key);
+    if (!_mapping || (it == _entries.end())) {
+        return false;
+    }
+
+    Reader r(*this, _mapping->data() + it->second, _mapping->data() + _mapping->size());
+    if (!stampsValid(r)) {
+        return false;
+    }
+
+    // the entry was completely checked by indexMapping()
+    replayRecords(r, sink);
+    _used.push_back(key);
+    ++_hits;
+    return true;
+}
+
+void TrafficCache::beginFile(const SGPath& file)
+{
+    const std::string key = file.utf8Str();
+    ++_misses;
+    _used.push_back(key);
+
+    _current = &_newEntries[key];
+    *_current = NewEntry();
+    _current->file.path = key;
+    _current->file.modTime = modTimeOf(key);
+}
+
+void TrafficCache::addDependency(const SGPath& includedFile)
+{
+    if (_current) {
+        Stamp s;
+        s.path = includedFile.utf8Str();
+        s.modTime = modTimeOf(s.path);
+        _current->dependencies.push_back(s);
+    }
+}
+
+void TrafficCache::record(const FlightRecord& flight)
+{
+    if (_current) {
+        Record r = {true, _current->flights.size()};
+        _current->records.push_back(r);
+        _current->flights.push_back(flight);
+    }
+}
+
+void TrafficCache::record(const AircraftRecord& aircraft)
+{
+    if (_current) {
+        Record r = {false, _current->aircraft.size()};
+        _current->records.push_back(r);
+        _current->aircraft.push_back(aircraft);
+    }
+}
+
+void TrafficCache::endFile()
+{
+    _current = nullptr;
+}
+
+void TrafficCache::save()
+{
+    if ((_misses == 0) && (_used.size() == _entries.size())) {
+        return; // unchanged
+    }
+
+    Writer w;
+    for (const auto& key : _used) {
+        auto n = _newEntries.find(key);
+        if (n != _newEntries.end()) {
+            const NewEntry& e(n->second);
+            w.beginEntry(e.file, e.dependencies, e.records.size());
+            for (const Record& rec : e.records) {
+                if (rec.isFlight) {
+                    w.addFlight(e.flights[rec.index]);
+                } else {
+                    w.addAircraft(e.aircraft[rec.index]);
+                }
+            }
+            continue;
+        }
+
+        // still valid entry of the old cache: copy it over
+        const char* base = _mapping->data();
+        Reader r(*this, base + _entries[key], base + _mapping->size());
+        std::vector<Stamp> deps;
+        Stamp file;
+        r.readString(file.path);
+        file.modTime = r.read<int64_t>();
+        const uint32_t depCount = r.read<uint32_t>();
+        for (uint32_t i = 0; i < depCount; ++i) {
+            Stamp d;
+            r.readString(d.path);
+            d.modTime = r.read<int64_t>();
+            deps.push_back(d);
+        }
+
+        Reader count(r);
+        w.beginEntry(file, deps, count.read<uint32_t>());
+        replayRecords(r, w);
+    }
+
+    // the old file must not be mapped while it is replaced
+    _mapping.reset();
+    _strings.clear();
+    _entries.clear();
+
+    SGPath dir = _path.dir();
+    if (!dir.exists()) {
+        SGPath(_path).create_dir(0755);
+    }
+
+    if (!w.save(_path)) {
+        SG_LOG(SG_AI, SG_WARN, "Failed to write traffic cache " << _path);
+    }
+}
+
+} // of namespace flightgear
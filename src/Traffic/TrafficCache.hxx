@@ -0,0 +1,156 @@
+// TrafficCache.hxx - binary cache of parsed AI traffic schedules
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef _TRAFFIC_CACHE_HXX_
+#define _TRAFFIC_CACHE_HXX_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+
+namespace flightgear
+{
+
+/**
+ * Cache of the parsed contents of the traffic schedule XML files.
+ *
+ * Parsing a full world traffic set takes tens of seconds, nearly all of it
+ * in the XML parser.  The cache stores, for each traffic file, the flight
+ * and aircraft records the parser produced, in the order it produced them,
+ * so they can be replayed through the same code instead of re-parsing.
+ * Filtering (missing models, traffic proportion) happens when records are
+ * replayed, as it depends on the current installation and settings.
+ *
+ * An entry is used only while the modification times of the file and of
+ * everything it included are unchanged, as with NavDataCache.  Strings are
+ * interned in a single table; the cache file is memory mapped when read.
+ */
+class TrafficCache
+{
+public:
+    struct FlightRecord
+    {
+        std::string callsign, fltRules, departurePort, arrivalPort,
+            departureTime, arrivalTime, repeat, requiredAircraft;
+        int cruiseAlt = 0;
+    };
+
+    struct AircraftRecord
+    {
+        std::string model, livery, homePort, registration, requiredAircraft,
+            acType, airline, perfClass, flightType;
+        std::string lastDeparturePort; ///< default for homePort
+        double radius = 0.0, offset = 0.0;
+        bool heavy = false;
+    };
+
+    /**
+     * Receives records, from the parser or replayed from the cache.
+     */
+    class Sink
+    {
+    public:
+        virtual ~Sink() = default;
+        virtual void addFlight(const FlightRecord& flight) = 0;
+        virtual void addAircraft(const AircraftRecord& aircraft) = 0;
+    };
+
+    explicit TrafficCache(const SGPath& cacheFile);
+    ~TrafficCache();
+
+    /**
+     * Map the cache file.  A missing, outdated or damaged file is not an
+     * error; it just means every file gets parsed.
+     */
+    void open();
+
+    /**
+     * Replay the records of file into sink, if the cached copy is still
+     * valid.  Returns false if the file needs parsing instead.
+     */
+    bool replay(const SGPath& file, Sink& sink);
+
+    /**
+     * Recording the records of a file which had to be parsed.
+     */
+    void beginFile(const SGPath& file);
+    void addDependency(const SGPath& includedFile);
+    void record(const FlightRecord& flight);
+    void record(const AircraftRecord& aircraft);
+    void endFile();
+
+    /**
+     * Write the cache back if anything changed since it was read.
+     */
+    void save();
+
+    unsigned int hits() const
+    { return _hits; }
+
+    unsigned int misses() const
+    { return _misses; }
+
+private:
+    class Mapping;
+    class Writer;
+    struct Reader;
+
+    struct Stamp
+    {
+        std::string path;
+        int64_t modTime;
+    };
+
+    struct Record
+    {
+        bool isFlight;
+        size_t index;
+    };
+
+    struct NewEntry
+    {
+        Stamp file;
+        std::vector<Stamp> dependencies;
+        std::vector<Record> records;
+        std::vector<FlightRecord> flights;
+        std::vector<AircraftRecord> aircraft;
+    };
+
+    bool indexMapping();
+    bool stampsValid(Reader& r) const;
+    void replayRecords(Reader& r, Sink& sink) const;
+
+    SGPath _path;
+    std::unique_ptr<Mapping> _mapping;
+    std::vector<std::pair<const char*, uint32_t> > _strings;
+    std::unordered_map<std::string, size_t> _entries; ///< path -> offset in mapping
+
+    // files seen this run, in order; new ones are in _newEntries
+    std::vector<std::string> _used;
+    std::map<std::string, NewEntry> _newEntries;
+    NewEntry* _current = nullptr;
+
+    unsigned int _hits = 0, _misses = 0;
+};
+
+} // of namespace flightgear
+
+#endif
@@ -50,6 +50,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <functional>
 #include <boost/foreach.hpp>
 
 #include <simgear/compiler.h>
@@ -64,6 +65,7 @@
 #include <simgear/xml/easyxml.hxx>
 #include <simgear/threads/SGThread.hxx>
 #include <simgear/threads/SGGuard.hxx>
+#include <simgear/timing/timestamp.hxx>
 #include <simgear/scene/tsync/terrasync.hxx>
 
 #include <AIModel/AIAircraft.hxx>
@@ -77,6 +79,7 @@
 #include <Main/fg_props.hxx>
 
 #include "TrafficMgr.hxx"
+#include "TrafficCache.hxx"
 
 using std::sort;
 using std::strcmp;
@@ -87,7 +90,8 @@ using std::vector;
 /**
  * Thread encapsulating parsing the traffic schedules.
  */
-class ScheduleParseThread : public SGThread, public XMLVisitor
+class ScheduleParseThread : public SGThread, public XMLVisitor,
+                            public flightgear::TrafficCache::Sink
 {
 public:
   ScheduleParseThread(FGTrafficManager* traffic) :
@@ -122,6 +126,11 @@ public:
     _trafficDirPaths = dirs;
   }
 
+  void setCacheFile(const SGPath& path)
+  {
+    _cache.reset(new flightgear::TrafficCache(path));
+  }
+
   bool isFinished() const
   {
     SGGuard<SGMutex> g(_lock);
@@ -130,6 +139,10 @@ public:
 
   virtual void run()
   {
+      if (_cache) {
+          _cache->open();
+      }
+
       BOOST_FOREACH(SGPath p, _trafficDirPaths) {
           parseTrafficDir(p);
           if (_cancelThread) {
@@ -137,6 +150,12 @@ public:
           }
       }
 
+      if (_cache) {
+          SG_LOG(SG_AI, SG_INFO, "traffic cache: " << _cache->hits() << " files cached, "
+                 << _cache->misses() << " parsed");
+          _cache->save();
+      }
+
     SGGuard<SGMutex> g(_lock);
     _isFinished = true;
   }
@@ -167,6 +186,9 @@ public:
             SGPath path = globals->get_fg_root();
             path.append("/Traffic/");
             path.append(attval);
+            if (_cache) {
+                _cache->addDependency(path);
+            }
             readXML(path, *this);
         }
         elementValueStack.push_back("");
@@ -226,58 +248,44 @@ public:
         else if (!strcmp(name, "flight")) {
             // We have loaded and parsed all the information belonging to this flight
             // so we temporarily store it.
-            //cerr << "Pusing back flight " << callsign << endl;
-            //cerr << callsign  <<  " " << fltrules     << " "<< departurePort << " " <<  arrivalPort << " "
-            //   << cruiseAlt <<  " " << departureTime<< " "<< arrivalTime   << " " << repeat << endl;
-
-            //Prioritize aircraft
-            string apt = fgGetString("/sim/presets/airport-id");
-            //cerr << "Airport information: " << apt << " " << departurePort << " " << arrivalPort << endl;
-            //if (departurePort == apt) score++;
-            //flights.push_back(new FGScheduledFlight(callsign,
-            //                                fltrules,
-            //                                departurePort,
-            //                                arrivalPort,
-            //                                cruiseAlt,
-            //                                departureTime,
-            //                                arrivalTime,
-            //                                repeat));
-            if (requiredAircraft == "") {
-                char buffer[16];
-                snprintf(buffer, 16, "%d", acCounter);
-                requiredAircraft = buffer;
-            }
-            SG_LOG(SG_AI, SG_DEBUG, "Adding flight: " << callsign << " "
-                   << fltrules << " "
-                   << departurePort << " "
-                   << arrivalPort << " "
-                   << cruiseAlt << " "
-                   << departureTime << " "
-                   << arrivalTime << " " << repeat << " " << requiredAircraft);
-            // For database maintainance purposes, it may be convenient to
-            //
-            if (fgGetBool("/sim/traffic-manager/dumpdata") == true) {
-                SG_LOG(SG_AI, SG_ALERT, "Traffic Dump FLIGHT," << callsign << ","
-                       << fltrules << ","
-                       << departurePort << ","
-                       << arrivalPort << ","
-                       << cruiseAlt << ","
-                       << departureTime << ","
-                       << arrivalTime << "," << repeat << "," << requiredAircraft);
+            flightgear::TrafficCache::FlightRecord flight;
+            flight.callsign = callsign;
+            flight.fltRules = fltrules;
+            flight.departurePort = departurePort;
+            flight.arrivalPort = arrivalPort;
+            flight.departureTime = departureTime;
+            flight.arrivalTime = arrivalTime;
+            flight.repeat = repeat;
+            flight.requiredAircraft = requiredAircraft;
+            flight.cruiseAlt = cruiseAlt;
+            if (_cache) {
+                _cache->record(flight);
             }
 
-            _trafficManager->flights[requiredAircraft].push_back(new FGScheduledFlight(callsign,
-                                                                      fltrules,
-                                                                      departurePort,
-                                                                      arrivalPort,
-                                                                      cruiseAlt,
-                                                                      departureTime,
-                                                                      arrivalTime,
-                                                                      repeat,
-                                                                      requiredAircraft));
+            addFlight(flight);
             requiredAircraft = "";
         } else if (!strcmp(name, "aircraft")) {
-            endAircraft();
+            flightgear::TrafficCache::AircraftRecord aircraft;
+            aircraft.model = mdl;
+            aircraft.livery = livery;
+            aircraft.homePort = homePort;
+            aircraft.registration = registration;
+            aircraft.requiredAircraft = requiredAircraft;
+            aircraft.acType = acType;
+            aircraft.airline = airline;
+            aircraft.perfClass = m_class;
+            aircraft.flightType = flighttype;
+            aircraft.lastDeparturePort = departurePort;
+            aircraft.radius = radius;
+            aircraft.offset = offset;
+            aircraft.heavy = heavy;
+            if (_cache) {
+                _cache->record(aircraft);
+            }
+
+            addAircraft(aircraft);
+            requiredAircraft = homePort = "";
+            score = 0;
         }
 
         elementValueStack.pop_back();
@@ -308,21 +316,58 @@ public:
                "Error: " << message << " (" << line << ',' << column << ')');
     }
 
-private:
-    void endAircraft()
+    // TrafficCache::Sink: records, either just parsed or from the cache
+
+    void addFlight(const flightgear::TrafficCache::FlightRecord& flight) override
+    {
+        std::string required = flight.requiredAircraft;
+        if (required.empty()) {
+            char buffer[16];
+            snprintf(buffer, 16, "%d", acCounter);
+            required = buffer;
+        }
+        SG_LOG(SG_AI, SG_DEBUG, "Adding flight: " << flight.callsign << " "
+               << flight.fltRules << " "
+               << flight.departurePort << " "
+               << flight.arrivalPort << " "
+               << flight.cruiseAlt << " "
+               << flight.departureTime << " "
+               << flight.arrivalTime << " " << flight.repeat << " " << required);
+        // For database maintainance purposes, it may be convenient to
+        //
+        if (fgGetBool("/sim/traffic-manager/dumpdata") == true) {
+            SG_LOG(SG_AI, SG_ALERT, "Traffic Dump FLIGHT," << flight.callsign << ","
+                   << flight.fltRules << ","
+                   << flight.departurePort << ","
+                   << flight.arrivalPort << ","
+                   << flight.cruiseAlt << ","
+                   << flight.departureTime << ","
+                   << flight.arrivalTime << "," << flight.repeat << "," << required);
+        }
+
+        _trafficManager->flights[required].push_back(new FGScheduledFlight(flight.callsign,
+                                                                  flight.fltRules,
+                                                                  flight.departurePort,
+                                                                  flight.arrivalPort,
+                                                                  flight.cruiseAlt,
+                                                                  flight.departureTime,
+                                                                  flight.arrivalTime,
+                                                                  flight.repeat,
+                                                                  required));
+    }
+
+    void addAircraft(const flightgear::TrafficCache::AircraftRecord& aircraft) override
     {
-        string isHeavy = heavy ? "true" : "false";
+        string isHeavy = aircraft.heavy ? "true" : "false";
 
-        if (missingModels.find(mdl) != missingModels.end()) {
+        if (missingModels.find(aircraft.model) != missingModels.end()) {
             // don't stat() or warn again
-            requiredAircraft = homePort = "";
             return;
         }
 
-        if (!FGAISchedule::validModelPath(mdl)) {
-            missingModels.insert(mdl);
-            SG_LOG(SG_AI, SG_DEV_WARN, "TrafficMgr: Missing model path:" << mdl);
-            requiredAircraft = homePort = "";
+        if (!FGAISchedule::validModelPath(aircraft.model)) {
+            missingModels.insert(aircraft.model);
+            SG_LOG(SG_AI, SG_DEV_WARN, "TrafficMgr: Missing model path:" << aircraft.model);
             return;
         }
 
@@ -330,46 +375,47 @@ private:
         (int) (fgGetDouble("/sim/traffic-manager/proportion") * 100);
         int randval = rand() & 100;
         if (randval > proportion) {
-            requiredAircraft = homePort = "";
             return;
         }
 
+        std::string required = aircraft.requiredAircraft;
+        std::string home = aircraft.homePort;
+
         if (fgGetBool("/sim/traffic-manager/dumpdata") == true) {
-            SG_LOG(SG_AI, SG_ALERT, "Traffic Dump AC," << homePort << "," << registration << "," << requiredAircraft
-                   << "," << acType << "," << livery << ","
-                   << airline << ","  << m_class << "," << offset << "," << radius << "," << flighttype << "," << isHeavy << "," << mdl);
+            SG_LOG(SG_AI, SG_ALERT, "Traffic Dump AC," << home << "," << aircraft.registration << "," << required
+                   << "," << aircraft.acType << "," << aircraft.livery << ","
+                   << aircraft.airline << ","  << aircraft.perfClass << "," << aircraft.offset << ","
+                   << aircraft.radius << "," << aircraft.flightType << "," << isHeavy << "," << aircraft.model);
         }
 
-        if (requiredAircraft == "") {
+        if (required == "") {
             char buffer[16];
             snprintf(buffer, 16, "%d", acCounter);
-            requiredAircraft = buffer;
+            required = buffer;
         }
-        if (homePort == "") {
-            homePort = departurePort;
+        if (home == "") {
+            home = aircraft.lastDeparturePort;
         }
 
         // caution, modifying the scheduled aircraft strucutre from the
         // 'wrong' thread. This is safe becuase FGTrafficManager won't touch
         // the structure while we exist.
-        _trafficManager->scheduledAircraft.push_back(new FGAISchedule(mdl,
-                                                     livery,
-                                                     homePort,
-                                                     registration,
-                                                     requiredAircraft,
-                                                     heavy,
-                                                     acType,
-                                                     airline,
-                                                     m_class,
-                                                     flighttype,
-                                                     radius, offset));
+        _trafficManager->scheduledAircraft.push_back(new FGAISchedule(aircraft.model,
+                                                     aircraft.livery,
+                                                     home,
+                                                     aircraft.registration,
+                                                     required,
+                                                     aircraft.heavy,
+                                                     aircraft.acType,
+                                                     aircraft.airline,
+                                                     aircraft.perfClass,
+                                                     aircraft.flightType,
+                                                     aircraft.radius, aircraft.offset));
 
         acCounter++;
-        requiredAircraft = "";
-        homePort = "";
-        score = 0;
     }
 
+private:
     void parseTrafficDir(const SGPath& path)
     {
         SGTimeStamp st;
@@ -383,7 +429,17 @@ private:
             SG_LOG(SG_AI, SG_DEBUG, "parsing traffic in:" << p);
             simgear::PathList trafficFiles = d2.children(simgear::Dir::TYPE_FILE, ".xml");
             BOOST_FOREACH(SGPath xml, trafficFiles) {
+                if (_cache && _cache->replay(xml, *this)) {
+                    continue;
+                }
+
+                if (_cache) {
+                    _cache->beginFile(xml);
+                }
                 readXML(xml, *this);
+                if (_cache) {
+                    _cache->endFile();
+                }
                 if (_cancelThread) {
                     return;
                 }
@@ -398,6 +454,7 @@ private:
   bool _isFinished;
   bool _cancelThread;
   simgear::PathList _trafficDirPaths;
+  std::unique_ptr<flightgear::TrafficCache> _cache;
 
 // parser state
 
@@ -429,8 +486,30 @@ FGTrafficManager::FGTrafficManager() :
   realWxEnabled("/environment/realwx/enabled"),
   metarValid("/environment/metar/valid"),
   active("/sim/traffic-manager/active"),
-  aiDataUpdateNow("/sim/terrasync/ai-data-update-now")
+  aiDataUpdateNow("/sim/terrasync/ai-data-update-now"),
+  queueSeq(0),
+  frameCount(0),
+  lastQueueTime(0)
 {
+    _schedulerNode = fgGetNode("/sim/traffic-manager/scheduler", true);
+    _budgetMs = _schedulerNode->getNode("budget-ms", true);
+    _closingSpeedKt = _schedulerNode->getNode("max-closing-speed-kt", true);
+    _maxIntervalSec = _schedulerNode->getNode("max-interval-sec", true);
+    _roundRobin = _schedulerNode->getNode("round-robin", true);
+    _statUpdates = _schedulerNode->getNode("updates", true);
+    _statTimeMs = _schedulerNode->getNode("time-ms", true);
+    _statPending = _schedulerNode->getNode("pending", true);
+    _statLatency = _schedulerNode->getNode("latency-sec", true);
+
+    if (_budgetMs->getType() == simgear::props::NONE) {
+        _budgetMs->setDoubleValue(1.0);
+    }
+    if (_closingSpeedKt->getType() == simgear::props::NONE) {
+        _closingSpeedKt->setDoubleValue(1200.0);
+    }
+    if (_maxIntervalSec->getType() == simgear::props::NONE) {
+        _maxIntervalSec->setIntValue(900);
+    }
 }
 
 FGTrafficManager::~FGTrafficManager()
@@ -494,6 +573,7 @@ void FGTrafficManager::shutdown()
         cachefile.close();
     }
     scheduledAircraft.clear();
+    scheduleQueue.clear();
     flights.clear();
 
     currAircraft = scheduledAircraft.begin();
@@ -567,6 +647,12 @@ void FGTrafficManager::init()
 
         scheduleParser.reset(new ScheduleParseThread(this));
         scheduleParser->setTrafficDirs(dirs);
+        if (fgGetBool("/sim/traffic-manager/use-cache", true)) {
+            SGPath cacheFile(globals->get_fg_home());
+            cacheFile.append("ai");
+            cacheFile.append("traffic-schedules.cache");
+            scheduleParser->setCacheFile(cacheFile);
+        }
         scheduleParser->start();
     } else {
         fgSetBool("/sim/traffic-manager/heuristics", false);
@@ -614,6 +700,10 @@ void FGTrafficManager::finishInit()
     currAircraft = scheduledAircraft.begin();
     currAircraftClosest = scheduledAircraft.begin();
 
+    lastUserCart = globals->get_aircraft_position_cart();
+    lastQueueTime = globals->get_time_params()->get_cur_time();
+    rebuildScheduleQueue(lastQueueTime);
+
     doingInit = false;
     inited = true;
     active = true;
@@ -743,18 +833,147 @@ void FGTrafficManager::update(double dt)
     }
 
     SGVec3d userCart = globals->get_aircraft_position_cart();
+    time_t now = globals->get_time_params()->get_cur_time();
+
+    SGTimeStamp st;
+    st.stamp();
+
+    if (_roundRobin->getBoolValue()) {
+        updateRoundRobin(now, userCart);
+    } else {
+        updateScheduleQueue(now, userCart);
+    }
 
+    _statTimeMs->setDoubleValue(st.elapsedMSec());
+    _statPending->setIntValue(scheduleQueue.size());
+}
+
+/**
+ * The original scheduler, kept for comparison: one step of one schedule
+ * per frame, cycling through all of them in score order.
+ */
+void FGTrafficManager::updateRoundRobin(time_t now, const SGVec3d& userCart)
+{
     if (currAircraft == scheduledAircraft.end()) {
         currAircraft = scheduledAircraft.begin();
     }
 
-    time_t now = globals->get_time_params()->get_cur_time();
-
     //cerr << "Processing << " << (*currAircraft)->getRegistration() << " with score " << (*currAircraft)->getScore() << endl;
     if ((*currAircraft)->update(now, userCart)) {
         // schedule is done - process another aircraft in next iteration
         currAircraft++;
     }
+
+    _statUpdates->setIntValue(1);
+}
+
+/**
+ * Update the schedules which are due, for as long as the frame budget
+ * allows (but at least one).  Schedules re-queued as due straight away
+ * wait for the next frame.
+ */
+void FGTrafficManager::updateScheduleQueue(time_t now, const SGVec3d& userCart)
+{
+    // After a jump of the user position (relocation) every distance
+    // estimate is wrong, and after a jump of the simulation time every due
+    // time is: start over.  Going back in time would otherwise leave every
+    // schedule waiting for a time which is hours away, going forward
+    // further than a visit interval would process them all as overdue.
+    if (dist(userCart, lastUserCart) * SG_METER_TO_NM > TRAFFICTOAIDISTTOSTART * 0.5) {
+        SG_LOG(SG_AI, SG_DEBUG, "Traffic manager: user moved, re-evaluating all schedules");
+        rebuildScheduleQueue(now);
+    } else if ((now < lastQueueTime) || (now - lastQueueTime > _maxIntervalSec->getIntValue())) {
+        SG_LOG(SG_AI, SG_DEBUG, "Traffic manager: time jumped by " << (now - lastQueueTime)
+               << " sec, re-evaluating all schedules");
+        rebuildScheduleQueue(now);
+    }
+    lastUserCart = userCart;
+    lastQueueTime = now;
+
+    ++frameCount;
+    const double budgetMs = _budgetMs->getDoubleValue();
+    std::greater<QueuedSchedule> heapOrder;
+    SGTimeStamp st;
+    st.stamp();
+
+    int updates = 0;
+    time_t latency = 0;
+    while (!scheduleQueue.empty()) {
+        const QueuedSchedule& top(scheduleQueue.front());
+        if ((top.due > now) || (top.frame == frameCount)) {
+            break;
+        }
+
+        if ((updates > 0) && (st.elapsedMSec() >= budgetMs)) {
+            break;
+        }
+
+        FGAISchedule* schedule = top.schedule;
+        latency = std::max(latency, now - top.due);
+        std::pop_heap(scheduleQueue.begin(), scheduleQueue.end(), heapOrder);
+        scheduleQueue.pop_back();
+
+        schedule->update(now, userCart);
+        ++updates;
+
+        if (schedule->isValid()) {
+            queueSchedule(schedule, nextVisit(schedule, now));
+        }
+    }
+
+    _statUpdates->setIntValue(updates);
+    _statLatency->setIntValue(latency);
+}
+
+void FGTrafficManager::queueSchedule(FGAISchedule* schedule, time_t due)
+{
+    QueuedSchedule entry;
+    entry.due = due;
+    entry.seq = queueSeq++;
+    entry.frame = frameCount;
+    entry.schedule = schedule;
+
+    scheduleQueue.push_back(entry);
+    std::push_heap(scheduleQueue.begin(), scheduleQueue.end(),
+                   std::greater<QueuedSchedule>());
+}
+
+/**
+ * When a schedule next needs an update: when its flight changes state, or
+ * when the user could have come within TRAFFICTOAIDISTTOSTART of it,
+ * whichever comes first.
+ */
+time_t FGTrafficManager::nextVisit(FGAISchedule* schedule, time_t now) const
+{
+    time_t due = schedule->getNextEventTime();
+    if (due < now) {
+        due = now;
+    }
+
+    const double distance = schedule->getDistanceToUser();
+    if (distance >= TRAFFICTOAIDISTTOSTART) {
+        const double closingKt = std::max(_closingSpeedKt->getDoubleValue(), 1.0);
+        const time_t inRange = now +
+            static_cast<time_t>((distance - TRAFFICTOAIDISTTOSTART) / closingKt * 3600.0);
+        due = std::min(due, inRange);
+    }
+
+    return std::min(due, now + static_cast<time_t>(_maxIntervalSec->getIntValue()));
+}
+
+/**
+ * Queue every valid schedule as due now, in score order.  Called between
+ * frames, so the entries are not held back as re-queued.
+ */
+void FGTrafficManager::rebuildScheduleQueue(time_t now)
+{
+    scheduleQueue.clear();
+    scheduleQueue.reserve(scheduledAircraft.size());
+    BOOST_FOREACH(FGAISchedule* schedule, scheduledAircraft) {
+        if (schedule->isValid()) {
+            queueSchedule(schedule, now);
+        }
+    }
 }
 
 void FGTrafficManager::readTimeTableFromFile(SGPath infileName)
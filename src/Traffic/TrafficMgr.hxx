@@ -48,6 +48,7 @@
 
 #include <set>
 #include <memory>
+#include <vector>
 
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/props/propertyObject.hxx>
@@ -87,6 +88,40 @@ private:
     ScheduleVector scheduledAircraft;
     ScheduleVectorIterator currAircraft, currAircraftClosest;
 
+    /**
+     * Schedules ordered by when they next need an update: the next
+     * departure or arrival of their current flight, or the earliest time
+     * the user could get within range of them.  Kept as a binary heap,
+     * earliest first.
+     */
+    struct QueuedSchedule
+    {
+        time_t due;
+        unsigned long seq;   ///< FIFO among equal due times
+        unsigned int frame;  ///< frame in which it was queued
+        FGAISchedule* schedule;
+
+        bool operator>(const QueuedSchedule& other) const
+        {
+            return (due > other.due) || ((due == other.due) && (seq > other.seq));
+        }
+    };
+
+    std::vector<QueuedSchedule> scheduleQueue;
+    unsigned long queueSeq;
+    unsigned int frameCount;
+    SGVec3d lastUserCart;
+    time_t lastQueueTime;
+
+    SGPropertyNode_ptr _schedulerNode, _budgetMs, _closingSpeedKt, _maxIntervalSec,
+        _roundRobin, _statUpdates, _statTimeMs, _statPending, _statLatency;
+
+    void queueSchedule(FGAISchedule* schedule, time_t due);
+    time_t nextVisit(FGAISchedule* schedule, time_t now) const;
+    void rebuildScheduleQueue(time_t now);
+    void updateScheduleQueue(time_t now, const SGVec3d& userCart);
+    void updateRoundRobin(time_t now, const SGVec3d& userCart);
+
     FGScheduledFlightMap flights;
 
     void readTimeTableFromFile(SGPath infilename);
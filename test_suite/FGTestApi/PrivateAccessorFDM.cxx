@@ -33,7 +33,7 @@ FGTestApi::PrivateAccessor::FDM::Accessor::read_FDM_AIWake_AircraftMesh_midPt(Ai
 const std::vector<AeroElement_ptr>
 FGTestApi::PrivateAccessor::FDM::Accessor::read_FDM_AIWake_WakeMesh_elements(WakeMesh* instance) const
 {
-   return instance->elements;
+   return instance->geometry->elements;
 }
 
 int
@@ -42,7 +42,7 @@ FGTestApi::PrivateAccessor::FDM::Accessor::read_FDM_AIWake_WakeMesh_nelm(WakeMes
    return instance->nelm;
 }
 
-double **
+const std::vector<double>
 FGTestApi::PrivateAccessor::FDM::Accessor::read_FDM_AIWake_WakeMesh_Gamma(WakeMesh* instance) const
 {
    return instance->Gamma;
@@ -39,7 +39,7 @@ public:
     // Access variables from src/FDM/AIWake/WakeMesh.hxx.
     const std::vector<AeroElement_ptr> read_FDM_AIWake_WakeMesh_elements(WakeMesh* instance) const;
     int read_FDM_AIWake_WakeMesh_nelm(WakeMesh* instance) const;
-    double **read_FDM_AIWake_WakeMesh_Gamma(WakeMesh* instance) const;
+    const std::vector<double> read_FDM_AIWake_WakeMesh_Gamma(WakeMesh* instance) const;
 
     // Access variables from src/FDM/YASim/Atmosphere.hxx.
     float read_FDM_YASim_Atmosphere_numColumns(std::unique_ptr<yasim::Atmosphere> &instance) const;
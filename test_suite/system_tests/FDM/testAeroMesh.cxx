@@ -113,8 +113,8 @@ void AeroMeshTests::testLiftComputation()
     auto accessor = FGTestApi::PrivateAccessor::FDM::Accessor();
 
     for (int i=1; i<= accessor.read_FDM_AIWake_WakeMesh_nelm(mesh); ++i)
-        CPPUNIT_ASSERT_DOUBLES_EQUAL(accessor.read_FDM_AIWake_WakeMesh_Gamma(accessor.read_FDM_AIWake_AIWakeGroup_aiWakeData(&wg, 1))[i][1],
-                          accessor.read_FDM_AIWake_WakeMesh_Gamma(mesh)[i][1], 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(accessor.read_FDM_AIWake_WakeMesh_Gamma(accessor.read_FDM_AIWake_AIWakeGroup_aiWakeData(&wg, 1))[i-1],
+                          accessor.read_FDM_AIWake_WakeMesh_Gamma(mesh)[i-1], 1e-9);
 }
 
 
@@ -161,8 +161,8 @@ void AeroMeshTests::testFourierLiftingLine()
 
         gamma *= 2.0*b*vel*sinAlpha;
 
-        cout << y << ", " << gamma << ", " << accessor.read_FDM_AIWake_WakeMesh_Gamma(mesh)[i][1] << ", "
-             << accessor.read_FDM_AIWake_WakeMesh_Gamma(mesh)[i][1] / gamma - 1.0 << endl;
+        cout << y << ", " << gamma << ", " << accessor.read_FDM_AIWake_WakeMesh_Gamma(mesh)[i-1] << ", "
+             << accessor.read_FDM_AIWake_WakeMesh_Gamma(mesh)[i-1] / gamma - 1.0 << endl;
     }
 
     nr_free_matrix(mtx, 1, N, 1, N);
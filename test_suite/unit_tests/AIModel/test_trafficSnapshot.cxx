@@ -0,0 +1,127 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_trafficSnapshot.hxx"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include <simgear/math/SGGeodesy.hxx>
+
+#include <AIModel/AITrafficSnapshot.hxx>
+
+
+namespace {
+
+const int TRAFFIC_COUNT = 300;
+const SGGeod CENTER = SGGeod::fromDegFt(4.76, 52.31, 3000.0);
+
+// fill both the snapshot and an equivalent /ai/models style property tree
+void makeTraffic(FGAITrafficSnapshot& traffic, SGPropertyNode* models)
+{
+    unsigned seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return ((seed >> 8) & 0xffff) / 65535.0;
+    };
+
+    traffic.clear();
+    for (int i = 0; i < TRAFFIC_COUNT; ++i) {
+        const SGGeod pos = SGGeod::fromDegFt(CENTER.getLongitudeDeg() + (next() - 0.5) * 6.0,
+                                             CENTER.getLatitudeDeg() + (next() - 0.5) * 4.0,
+                                             next() * 40000.0);
+        const double heading = next() * 360.0;
+        const double speed = 100 + next() * 400;
+        const double vs = (next() - 0.5) * 50.0;
+
+        SGPropertyNode* n = models->getChild("multiplayer", i, true);
+        n->setIntValue("id", i);
+        n->setStringValue("callsign", "MP" + std::to_string(i));
+        n->setDoubleValue("position/latitude-deg", pos.getLatitudeDeg());
+        n->setDoubleValue("position/longitude-deg", pos.getLongitudeDeg());
+        n->setDoubleValue("position/altitude-ft", pos.getElevationFt());
+        n->setDoubleValue("orientation/true-heading-deg", heading);
+        n->setDoubleValue("velocities/true-airspeed-kt", speed);
+        n->setDoubleValue("velocities/vertical-speed-fps", vs);
+        n->setBoolValue("controls/invisible", false);
+
+        traffic.add(i, n->getStringValue("callsign"), "multiplayer",
+                    FGAITrafficSnapshot::FlagMultiplayer, pos, heading, speed, vs, n);
+    }
+
+    traffic.finish();
+}
+
+} // of anonymous namespace
+
+
+void TrafficSnapshotTests::testFindInRange()
+{
+    FGAITrafficSnapshot traffic;
+    SGPropertyNode_ptr models(new SGPropertyNode);
+    makeTraffic(traffic, models);
+    CPPUNIT_ASSERT_EQUAL(size_t(TRAFFIC_COUNT), traffic.size());
+
+    // small ranges use the grid, large ones fall back to a plain scan
+    for (double rangeNm : {2.0, 10.0, 40.0, 500.0}) {
+        const double rangeM = rangeNm * SG_NM_TO_METER;
+        std::vector<size_t> found;
+        traffic.findInRange(CENTER, rangeM, found);
+        std::set<size_t> foundSet(found.begin(), found.end());
+        CPPUNIT_ASSERT_EQUAL(found.size(), foundSet.size());
+
+        for (size_t i = 0; i < traffic.size(); ++i) {
+            const SGGeod pos = SGGeod::fromDeg(traffic.longitudeDeg(i), traffic.latitudeDeg(i));
+            const double d = SGGeodesy::distanceM(CENTER, pos);
+            if (d <= rangeM) {
+                CPPUNIT_ASSERT(foundSet.count(i));
+            } else if (d > rangeM * 1.01) {
+                CPPUNIT_ASSERT(!foundSet.count(i));
+            }
+        }
+    }
+
+    std::vector<size_t> found;
+    traffic.findInRange(CENTER, 10 * SG_NM_TO_METER, found);
+    for (size_t i : found) {
+        CPPUNIT_ASSERT_EQUAL(FGAITrafficSnapshot::hashCallsign("MP" + std::to_string(traffic.id(i))),
+                             traffic.callsignHash(i));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(models->getChild("multiplayer", traffic.id(i))->getDoubleValue("position/altitude-ft"),
+                                     traffic.altitudeFt(i), 1e-6);
+    }
+}
+
+void TrafficSnapshotTests::testVelocity()
+{
+    FGAITrafficSnapshot traffic;
+    traffic.add(1, "EAST", "aircraft", FGAITrafficSnapshot::FlagAircraft,
+                SGGeod::fromDegFt(0.0, 0.0, 10000.0), 90.0, 100.0, 0.0, nullptr);
+    traffic.add(2, "UP", "aircraft", FGAITrafficSnapshot::FlagAircraft,
+                SGGeod::fromDegFt(0.0, 0.0, 10000.0), 0.0, 0.0, 10.0, nullptr);
+    traffic.finish();
+
+    // at 0N 0E, east is +y and up is +x in the earth centered frame
+    const SGVec3d east = traffic.cartVelocity(0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0 * SG_KT_TO_MPS, east.y(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, east.x(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, east.z(), 1e-6);
+
+    const SGVec3d up = traffic.cartVelocity(1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0 * SG_FEET_TO_METER, up.x(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, up.y(), 1e-6);
+}
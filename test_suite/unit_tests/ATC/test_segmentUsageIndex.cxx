@@ -0,0 +1,101 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_segmentUsageIndex.hxx"
+
+#include <cstdlib>
+#include <vector>
+
+#include <ATC/SegmentUsageIndex.hxx>
+#include <ATC/trafficcontrol.hxx>
+
+
+void SegmentUsageIndexTests::testMoveAlongRoute()
+{
+    SegmentUsageIndex index;
+    index.update(1, 10, {11, 12, 13});
+    index.update(2, 12, {13});
+
+    CPPUNIT_ASSERT_EQUAL(size_t(1), index.aircraftOn(10).size());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), index.aircraftIntending(13).size());
+    CPPUNIT_ASSERT(index.isOnOrIntends(1, 12));
+    CPPUNIT_ASSERT(!index.isOnOrIntends(2, 11));
+
+    // aircraft 1 taxies onto segment 11
+    index.update(1, 11, {12, 13});
+    CPPUNIT_ASSERT(index.aircraftOn(10).empty());
+    CPPUNIT_ASSERT_EQUAL(1, index.aircraftOn(11).front());
+    CPPUNIT_ASSERT(index.aircraftIntending(11).empty());
+    CPPUNIT_ASSERT(index.isOnOrIntends(1, 11));
+
+    // re-routed
+    index.update(1, 11, {20, 21});
+    CPPUNIT_ASSERT(!index.isOnOrIntends(1, 12));
+    CPPUNIT_ASSERT(index.isOnOrIntends(1, 21));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), index.aircraftIntending(13).size());
+
+    index.remove(1);
+    CPPUNIT_ASSERT(index.aircraftOn(11).empty());
+    CPPUNIT_ASSERT(index.aircraftIntending(20).empty());
+    CPPUNIT_ASSERT(!index.isOnOrIntends(1, 11));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), index.size());
+}
+
+
+// The index must give the same answers as the pairwise comparison of
+// traffic records it replaces, while aircraft move along their routes.
+void SegmentUsageIndexTests::testMatchesTrafficRecords()
+{
+    const int aircraftCount = 40;
+    const int segmentCount = 60;
+    srand(4711);
+
+    std::vector<FGTrafficRecord> records(aircraftCount);
+    SegmentUsageIndex index;
+    for (int a = 0; a < aircraftCount; ++a) {
+        FGTrafficRecord& rec(records[a]);
+        rec.setId(a + 1);
+        intVec& intentions(rec.getIntentions());
+        const int length = rand() % 12;
+        for (int s = 0; s < length; ++s) {
+            intentions.push_back(1 + rand() % segmentCount);
+        }
+
+        index.update(rec.getId(), rec.getCurrentPosition(), intentions);
+    }
+
+    for (int step = 0; step < 15; ++step) {
+        for (int a = 0; a < aircraftCount; ++a) {
+            // move on to the first intention, as announcePosition() does;
+            // aircraft at the end of their route stay where they are
+            FGTrafficRecord& rec(records[a]);
+            if (!rec.getIntentions().empty()) {
+                rec.setPositionAndIntentions(rec.getIntentions().front(), nullptr);
+            }
+
+            index.update(rec.getId(), rec.getCurrentPosition(), rec.getIntentions());
+        }
+
+        for (int a = 0; a < aircraftCount; ++a) {
+            for (int b = 0; b < aircraftCount; ++b) {
+                CPPUNIT_ASSERT_EQUAL(records[a].checkPositionAndIntentions(records[b]),
+                                     index.isOnOrIntends(records[a].getId(),
+                                                         records[b].getCurrentPosition()));
+            }
+        }
+    }
+}
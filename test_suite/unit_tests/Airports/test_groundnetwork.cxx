@@ -0,0 +1,161 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_groundnetwork.hxx"
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+#include "test_suite/FGTestApi/NavDataCache.hxx"
+
+#include <simgear/debug/logstream.hxx>
+
+#include <Airports/airport.hxx>
+#include <Airports/groundnetwork.hxx>
+#include <Main/fg_props.hxx>
+
+
+// a large hub with a detailed ground network in the base package
+static const char* HUB_ICAO = "EHAM";
+
+static FGGroundNetwork* hubNetwork()
+{
+    FGAirportRef apt = FGAirport::getByIdent(HUB_ICAO);
+    if (!apt) {
+        return nullptr;
+    }
+
+    FGGroundNetwork* net = apt->groundNetwork();
+    if (!net || net->allParkings().empty()) {
+        SG_LOG(SG_GENERAL, SG_WARN, "No ground network for " << HUB_ICAO << ", skipping");
+        return nullptr;
+    }
+
+    return net;
+}
+
+
+// Set up function for each test.
+void GroundNetworkTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("groundnetwork");
+    FGTestApi::setUp::initNavDataCache();
+}
+
+
+// Clean up after each test.
+void GroundNetworkTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void GroundNetworkTests::testShortestRoute()
+{
+    FGGroundNetwork* net = hubNetwork();
+    if (!net) {
+        return;
+    }
+
+    FGRunwayRef rwy = net->airport()->getRunwayByIndex(0);
+    FGTaxiNodeRef runwayNode = net->findNearestNodeOnRunway(rwy->threshold());
+    CPPUNIT_ASSERT(runwayNode.valid());
+
+    FGParkingRef park = net->allParkings().front();
+    FGTaxiRoute route = net->findShortestRoute(park, runwayNode);
+    CPPUNIT_ASSERT(!route.empty());
+
+    // consecutive nodes must be joined by the reported segments, and the
+    // route can never be shorter than the straight line
+    FGTaxiNodeRef node, previous;
+    int segIndex;
+    int count = 0;
+    while (route.next(node, &segIndex)) {
+        if (count == 0) {
+            CPPUNIT_ASSERT(node.ptr() == park.ptr());
+        } else {
+            FGTaxiSegment* seg = net->findSegment(segIndex);
+            CPPUNIT_ASSERT(seg);
+            CPPUNIT_ASSERT(seg->getStart().ptr() == previous.ptr());
+            CPPUNIT_ASSERT(seg->getEnd().ptr() == node.ptr());
+        }
+
+        previous = node;
+        ++count;
+    }
+
+    CPPUNIT_ASSERT(previous.ptr() == runwayNode.ptr());
+    CPPUNIT_ASSERT(route.getDistance() >= dist(park->cart(), runwayNode->cart()));
+
+    // routing again must give the same answer from the reused scratch space
+    FGTaxiRoute again = net->findShortestRoute(park, runwayNode);
+    CPPUNIT_ASSERT_EQUAL(route.getDistance(), again.getDistance());
+    CPPUNIT_ASSERT_EQUAL(route.size(), again.size());
+
+    // a node is trivially reachable from itself
+    FGTaxiRoute self = net->findShortestRoute(park, park);
+    CPPUNIT_ASSERT_EQUAL(1, self.size());
+}
+
+
+void GroundNetworkTests::testRouteCache()
+{
+    FGGroundNetwork* net = hubNetwork();
+    if (!net) {
+        return;
+    }
+
+    SGPropertyNode_ptr cacheNode = fgGetNode("/sim/ai/groundnet/route-cache", true);
+    FGRunwayRef rwy = net->airport()->getRunwayByIndex(0);
+    FGTaxiNodeRef runwayNode = net->findNearestNodeOnRunway(rwy->threshold());
+    FGParkingRef park = net->allParkings().front();
+
+    FGTaxiRoute first = net->findShortestRoute(park, runwayNode);
+    const long searches = cacheNode->getLongValue("searches");
+    const long hits = cacheNode->getLongValue("hits");
+
+    // the same request again is answered from the cache
+    FGTaxiRoute second = net->findShortestRoute(park, runwayNode);
+    CPPUNIT_ASSERT_EQUAL(searches, cacheNode->getLongValue("searches"));
+    CPPUNIT_ASSERT_EQUAL(hits + 1, cacheNode->getLongValue("hits"));
+    CPPUNIT_ASSERT_EQUAL(first.getDistance(), second.getDistance());
+    CPPUNIT_ASSERT_EQUAL(first.size(), second.size());
+
+    // the search does not look at blocks, so they come and go without
+    // dropping the cached routes
+    FGTaxiSegment* seg = net->findSegment(1);
+    CPPUNIT_ASSERT(seg);
+    seg->block(4711, 0, 0);
+    net->blockSegmentsEndingAt(seg, 4711, 0, 0);
+    net->findShortestRoute(park, runwayNode);
+    CPPUNIT_ASSERT_EQUAL(searches, cacheNode->getLongValue("searches"));
+
+    net->unblockAllSegments(60);
+    CPPUNIT_ASSERT(!seg->hasBlock(60));
+    net->findShortestRoute(park, runwayNode);
+    CPPUNIT_ASSERT_EQUAL(searches, cacheNode->getLongValue("searches"));
+
+    net->invalidateRouteCache();
+    net->findShortestRoute(park, runwayNode);
+    CPPUNIT_ASSERT_EQUAL(searches + 1, cacheNode->getLongValue("searches"));
+
+    // a quiet search does not answer a full one, which reports failures
+    net->findShortestRoute(park, runwayNode, false);
+    CPPUNIT_ASSERT_EQUAL(searches + 2, cacheNode->getLongValue("searches"));
+    net->findShortestRoute(park, runwayNode, false);
+    CPPUNIT_ASSERT_EQUAL(searches + 2, cacheNode->getLongValue("searches"));
+    net->findShortestRoute(park, runwayNode, true);
+    CPPUNIT_ASSERT_EQUAL(searches + 2, cacheNode->getLongValue("searches"));
+}
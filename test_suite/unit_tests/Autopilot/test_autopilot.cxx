@@ -0,0 +1,229 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "test_autopilot.hxx"
+
+#include <simgear/props/props.hxx>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <Autopilot/autopilot.hxx>
+#include <Autopilot/inputvalue.hxx>
+#include <Main/fg_props.hxx>
+#include <Main/globals.hxx>
+
+using FGXMLAutopilot::Autopilot;
+using FGXMLAutopilot::InputValue;
+using FGXMLAutopilot::InputValue_ptr;
+
+
+// A gain filter and a slower gain filter updated twice per second.
+static SGPropertyNode_ptr createConfig()
+{
+    SGPropertyNode_ptr config(new SGPropertyNode);
+
+    SGPropertyNode* fast = config->getNode("filter", 0, true);
+    fast->setStringValue("name", "fast");
+    fast->setStringValue("type", "gain");
+    fast->setStringValue("input/property", "/test/input");
+    fast->setDoubleValue("input/offset/expression/product/value[0]", 0.5);
+    fast->setDoubleValue("input/offset/expression/product/value[1]", 2.0);
+    fast->setDoubleValue("gain/value", 2.0);
+    fast->setDoubleValue("gain/scale", 3.0);
+    fast->setStringValue("output/property", "/test/fast");
+
+    SGPropertyNode* slow = config->getNode("filter", 1, true);
+    slow->setStringValue("name", "slow");
+    slow->setStringValue("type", "gain");
+    slow->setDoubleValue("update-interval-secs", 0.5);
+    slow->setStringValue("input/property", "/test/input");
+    slow->setDoubleValue("gain", 1.0);
+    slow->setStringValue("output/property", "/test/slow");
+
+    return config;
+}
+
+
+static InputValue_ptr parseInput(SGPropertyNode* cfg)
+{
+    return new InputValue(*globals->get_props(), *cfg);
+}
+
+
+// Set up function for each test.
+void AutopilotTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("autopilot");
+}
+
+
+// Clean up after each test.
+void AutopilotTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void AutopilotTests::testConstantInputs()
+{
+    SGSharedPtr<Autopilot> ap = new Autopilot(fgGetNode("/sim/systems/autopilot", true),
+                                              createConfig());
+    ap->bind();
+    ap->init();
+
+    for (int i = 0; i < 10; ++i) {
+        const double input = i * 1.5 - 4.0;
+        fgSetDouble("/test/input", input);
+        ap->update(0.1);
+
+        // input offset 0.5 * 2, gain 2 scaled by 3
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(6.0 * (input + 1.0), fgGetDouble("/test/fast"), 1e-9);
+    }
+
+    ap->unbind();
+
+    // numbers, and scale, offset, clipping and expressions made of them,
+    // are folded into a constant
+    SGPropertyNode_ptr cfg(new SGPropertyNode);
+    cfg->setDoubleValue("number", 2.5);
+    InputValue_ptr value = parseInput(cfg->getNode("number"));
+    CPPUNIT_ASSERT(value->is_constant());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.5, value->get_value(), 1e-9);
+
+    cfg->setDoubleValue("scaled/value", 2.0);
+    cfg->setDoubleValue("scaled/scale", 3.0);
+    cfg->setDoubleValue("scaled/offset", 1.0);
+    cfg->setDoubleValue("scaled/max", 5.0);
+    value = parseInput(cfg->getNode("scaled"));
+    CPPUNIT_ASSERT(value->is_constant());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, value->get_value(), 1e-9);
+
+    cfg->setDoubleValue("expression/expression/product/value[0]", 0.5);
+    cfg->setDoubleValue("expression/expression/product/value[1]", 3.0);
+    value = parseInput(cfg->getNode("expression"));
+    CPPUNIT_ASSERT(value->is_constant());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5, value->get_value(), 1e-9);
+
+    // once a property is involved anywhere, it is not
+    cfg->setStringValue("property/property", "/test/input");
+    value = parseInput(cfg->getNode("property"));
+    CPPUNIT_ASSERT(!value->is_constant());
+
+    cfg->setDoubleValue("property-scale/value", 2.0);
+    cfg->setStringValue("property-scale/scale/property", "/test/scale");
+    value = parseInput(cfg->getNode("property-scale"));
+    CPPUNIT_ASSERT(!value->is_constant());
+
+    cfg->setDoubleValue("property-min/value", 2.0);
+    cfg->setStringValue("property-min/min/property", "/test/min");
+    value = parseInput(cfg->getNode("property-min"));
+    CPPUNIT_ASSERT(!value->is_constant());
+
+    cfg->setDoubleValue("property-expression/expression/product/value", 0.5);
+    cfg->setStringValue("property-expression/expression/product/property", "/test/input");
+    value = parseInput(cfg->getNode("property-expression"));
+    CPPUNIT_ASSERT(!value->is_constant());
+
+    // and it is still read every time
+    fgSetDouble("/test/input", 4.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, value->get_value(), 1e-9);
+    fgSetDouble("/test/input", 6.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, value->get_value(), 1e-9);
+}
+
+
+void AutopilotTests::testUpdateInterval()
+{
+    SGSharedPtr<Autopilot> ap = new Autopilot(fgGetNode("/sim/systems/autopilot", true),
+                                              createConfig());
+    ap->bind();
+    ap->init();
+
+    double lastUpdated = 0.0;
+    for (int frame = 1; frame <= 20; ++frame) {
+        fgSetDouble("/test/input", frame);
+        ap->update(0.125);
+
+        // four frames per interval
+        if ((frame % 4) == 0) {
+            lastUpdated = frame;
+        }
+
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(lastUpdated, fgGetDouble("/test/slow"), 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(6.0 * (frame + 1.0), fgGetDouble("/test/fast"), 1e-9);
+    }
+
+    ap->unbind();
+}
+
+
+void AutopilotTests::testConfigurationOrder()
+{
+    // a chain alternating between two rates: each stage must see the
+    // output of the previous one from the same update
+    SGPropertyNode_ptr config(new SGPropertyNode);
+    const char* stages[] = {"/test/input", "/test/a", "/test/b", "/test/c"};
+    for (int i = 0; i < 3; ++i) {
+        SGPropertyNode* filter = config->getNode("filter", i, true);
+        filter->setStringValue("type", "gain");
+        filter->setDoubleValue("gain", 1.0);
+        filter->setDoubleValue("update-interval-secs", (i == 1) ? 0.0 : 0.5);
+        filter->setStringValue("input/property", stages[i]);
+        filter->setStringValue("output/property", stages[i + 1]);
+    }
+
+    SGSharedPtr<Autopilot> ap = new Autopilot(fgGetNode("/sim/systems/autopilot", true),
+                                              config);
+    ap->bind();
+    ap->init();
+
+    for (int frame = 1; frame <= 8; ++frame) {
+        fgSetDouble("/test/input", frame);
+        ap->update(0.125);
+    }
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, fgGetDouble("/test/a"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, fgGetDouble("/test/b"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, fgGetDouble("/test/c"), 1e-9);
+
+    ap->unbind();
+}
+
+
+void AutopilotTests::testProfiling()
+{
+    SGPropertyNode_ptr root = fgGetNode("/sim/systems/autopilot", true);
+    SGSharedPtr<Autopilot> ap = new Autopilot(root, createConfig());
+    ap->bind();
+    ap->init();
+
+    ap->update(0.125);
+    CPPUNIT_ASSERT(!root->getNode("profiling/component"));
+
+    root->setBoolValue("profiling/enabled", true);
+    for (int frame = 0; frame < 4; ++frame) {
+        ap->update(0.125);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::string("fast"),
+                         std::string(root->getStringValue("profiling/component[0]/name")));
+    CPPUNIT_ASSERT_EQUAL(std::string("slow"),
+                         std::string(root->getStringValue("profiling/component[1]/name")));
+    CPPUNIT_ASSERT(root->getDoubleValue("profiling/component[0]/mean-us", -1.0) >= 0.0);
+    CPPUNIT_ASSERT(root->getDoubleValue("profiling/total-us", -1.0) >= 0.0);
+
+    ap->unbind();
+}
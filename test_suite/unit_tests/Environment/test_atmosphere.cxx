@@ -0,0 +1,96 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_atmosphere.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <Environment/atmosphere.hxx>
+
+
+// Set up function for each test.
+void AtmosphereTests::setUp()
+{
+}
+
+
+// Clean up after each test.
+void AtmosphereTests::tearDown()
+{
+}
+
+
+void AtmosphereTests::testTablesMatchModel()
+{
+    using namespace atmodel;
+    FGAltimeter altimeter;
+
+    // the inverse table is spaced evenly in pressure, so it gets coarser
+    // relative to the pressure higher up
+    double maxErrorFt[3] = {0.0, 0.0, 0.0};
+    double maxPressureError = 0.0;
+    for (double ft = -3000.0; ft <= 104000.0; ft += 7.3) {
+        const double pInHg = PT_vs_hpt(ft * foot).first / inHg;
+
+        const int band = (ft < 36000.0) ? 0 : ((ft < 65000.0) ? 1 : 2);
+        maxErrorFt[band] = std::max(maxErrorFt[band],
+                                    std::fabs(altimeter.a_vs_p_ft(pInHg) - ft));
+        maxPressureError = std::max(maxPressureError,
+                                    std::fabs(altimeter.p_vs_a_inHg(ft) - pInHg) / pInHg);
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("below 36000ft: " + std::to_string(maxErrorFt[0]),
+                           maxErrorFt[0] < 0.01);
+    CPPUNIT_ASSERT_MESSAGE("below 65000ft: " + std::to_string(maxErrorFt[1]),
+                           maxErrorFt[1] < 0.1);
+    CPPUNIT_ASSERT_MESSAGE("above 65000ft: " + std::to_string(maxErrorFt[2]),
+                           maxErrorFt[2] < 5.0);
+    CPPUNIT_ASSERT_MESSAGE("pressure: " + std::to_string(maxPressureError),
+                           maxPressureError < 1e-6);
+
+    // standard setting and standard pressure read zero
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, altimeter.reading_ft(ISA::P0 / inHg), 0.01);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ISA::P0 / inHg, altimeter.p_vs_a_inHg(0.0), 1e-5);
+
+    // clamped beyond the ends of the tables
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(altimeter.a_vs_p_ft(0.25), altimeter.a_vs_p_ft(0.01), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(altimeter.a_vs_p_ft(33.75), altimeter.a_vs_p_ft(40.0), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(altimeter.p_vs_a_inHg(105000.0), altimeter.p_vs_a_inHg(200000.0), 1e-9);
+}
+
+
+void AtmosphereTests::testBatchLookups()
+{
+    FGAltimeter altimeter;
+
+    std::vector<double> pressures, altitudes;
+    for (int i = 0; i < 101; ++i) {
+        pressures.push_back(0.1 + i * 0.34);
+        altitudes.push_back(-4000.0 + i * 1100.0);
+    }
+
+    std::vector<double> a(pressures.size()), p(altitudes.size());
+    altimeter.a_vs_p_ft(pressures.data(), a.data(), pressures.size());
+    altimeter.p_vs_a_inHg(altitudes.data(), p.data(), altitudes.size());
+    for (size_t i = 0; i < pressures.size(); ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(altimeter.a_vs_p_ft(pressures[i]), a[i], 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(altimeter.p_vs_a_inHg(altitudes[i]), p[i], 1e-9);
+    }
+}
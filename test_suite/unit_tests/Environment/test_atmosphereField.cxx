@@ -0,0 +1,222 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_atmosphereField.hxx"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <simgear/props/props.hxx>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <AIModel/AIManager.hxx>
+#include <AIModel/AIStatic.hxx>
+#include <Environment/atmospherefield.hxx>
+#include <Environment/environment_ctrl.hxx>
+#include <Main/fg_props.hxx>
+
+
+using Environment::AtmosphereField;
+
+static AtmosphereField::Sample makeSample(double north, double east, double degC)
+{
+    AtmosphereField::Sample s;
+    s.windFromNorthFps = north;
+    s.windFromEastFps = east;
+    s.temperatureDegC = degC;
+    return s;
+}
+
+static void setEntry(SGPropertyNode* table, int index, double elevationFt,
+                     double headingDeg, double speedKt)
+{
+    SGPropertyNode* entry = table->getChild("entry", index, true);
+    entry->setDoubleValue("elevation-ft", elevationFt);
+    entry->setDoubleValue("wind-from-heading-deg", headingDeg);
+    entry->setDoubleValue("wind-speed-kt", speedKt);
+}
+
+
+// Set up function for each test.
+void AtmosphereFieldTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("atmosphereField");
+}
+
+
+// Clean up after each test.
+void AtmosphereFieldTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void AtmosphereFieldTests::testInterpolation()
+{
+    AtmosphereField field;
+    CPPUNIT_ASSERT(!field.valid());
+
+    // aloft: 0, 1000 and 2000ft
+    std::vector<AtmosphereField::Sample> aloft;
+    aloft.push_back(makeSample(0.0, 0.0, 15.0));
+    aloft.push_back(makeSample(10.0, 20.0, 13.0));
+    aloft.push_back(makeSample(30.0, 20.0, 11.0));
+    field.setAloft(0.0, 1000.0, aloft);
+    CPPUNIT_ASSERT(field.valid());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), field.size());
+
+    AtmosphereField::Sample s = field.sample(500.0, 500.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, s.windFromNorthFps, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, s.windFromEastFps, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(14.0, s.temperatureDegC, 1e-9);
+
+    // clamped at both ends of the column
+    s = field.sample(-300.0, 0.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, s.windFromNorthFps, 1e-9);
+    s = field.sample(9000.0, 9000.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(30.0, s.windFromNorthFps, 1e-9);
+
+    // boundary: ground 0 and 1000ft, 0 and 500ft above ground
+    std::vector<AtmosphereField::Sample> boundary;
+    boundary.push_back(makeSample(0.0, 0.0, 15.0));
+    boundary.push_back(makeSample(4.0, 0.0, 14.0));
+    boundary.push_back(makeSample(2.0, 8.0, 13.0));
+    boundary.push_back(makeSample(6.0, 8.0, 12.0));
+    field.setBoundary(0.0, 1000.0, 500.0, 2, boundary);
+    CPPUNIT_ASSERT_EQUAL(size_t(7), field.size());
+
+    // 250ft above ground at 500ft: middle of the cell
+    s = field.sample(750.0, 250.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, s.windFromNorthFps, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, s.windFromEastFps, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(13.5, s.temperatureDegC, 1e-9);
+
+    // ground beyond the rows uses the outermost one
+    s = field.sample(5100.0, 100.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.8, s.windFromNorthFps, 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, s.windFromEastFps, 1e-9);
+
+    // at and above the boundary top: the aloft column
+    s = field.sample(1500.0, 500.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(20.0, s.windFromNorthFps, 1e-9);
+
+    field.takeQueryCount();
+    std::vector<AtmosphereField::Point> points;
+    for (int i = 0; i < 40; ++i) {
+        AtmosphereField::Point p;
+        p.altitudeFt = i * 75.0;
+        p.altitudeAglFt = i * 30.0;
+        points.push_back(p);
+    }
+
+    std::vector<AtmosphereField::Sample> results;
+    field.sample(points, results);
+    CPPUNIT_ASSERT_EQUAL(points.size(), results.size());
+    CPPUNIT_ASSERT_EQUAL(points.size(), field.takeQueryCount());
+    for (size_t i = 0; i < points.size(); ++i) {
+        s = field.sample(points[i].altitudeFt, points[i].altitudeAglFt);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(s.windFromNorthFps, results[i].windFromNorthFps, 1e-12);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(s.windFromEastFps, results[i].windFromEastFps, 1e-12);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(s.temperatureDegC, results[i].temperatureDegC, 1e-12);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(s.pressureInhg, results[i].pressureInhg, 1e-12);
+    }
+
+    field.clearBoundary();
+    CPPUNIT_ASSERT_EQUAL(size_t(3), field.size());
+    s = field.sample(750.0, 250.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(7.5, s.windFromNorthFps, 1e-9);
+}
+
+
+void AtmosphereFieldTests::testMatchesLayerInterpolation()
+{
+    SGPropertyNode_ptr config = fgGetNode("/environment/config", true);
+    setEntry(config->getNode("boundary", true), 0, 0.0, 270.0, 10.0);
+    setEntry(config->getNode("boundary", true), 1, 2000.0, 280.0, 20.0);
+    setEntry(config->getNode("aloft", true), 0, 5000.0, 290.0, 30.0);
+    setEntry(config->getNode("aloft", true), 1, 15000.0, 300.0, 50.0);
+
+    AtmosphereField field;
+    std::unique_ptr<SGSubsystem> controller(
+        Environment::LayerInterpolateController::createInstance(config, &field));
+    controller->bind();
+    controller->init();
+    controller->postinit();
+
+    SGPropertyNode_ptr interpolated = config->getNode("interpolated", true);
+    SGPropertyNode_ptr altitude = fgGetNode("/position/altitude-ft", true);
+    SGPropertyNode_ptr altitudeAgl = fgGetNode("/position/altitude-agl-ft", true);
+
+    // in the boundary layer, in the transition and aloft; all over the
+    // same ground, so the field is built once
+    const double points[][2] = {
+        {3000.0, 1500.0},
+        {3800.0, 2300.0},
+        {8000.0, 6500.0}
+    };
+
+    for (const auto& p : points) {
+        altitude->setDoubleValue(p[0]);
+        altitudeAgl->setDoubleValue(p[1]);
+        controller->update(0.1);
+        CPPUNIT_ASSERT(field.valid());
+
+        const std::string at = " at " + std::to_string(p[0]) + "ft";
+        const AtmosphereField::Sample s = field.sample(p[0], p[1]);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("north" + at,
+            interpolated->getDoubleValue("wind-from-north-fps"), s.windFromNorthFps, 0.5);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("east" + at,
+            interpolated->getDoubleValue("wind-from-east-fps"), s.windFromEastFps, 0.5);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(field.size()),
+                         fgGetInt("/environment/field/points"));
+
+    // AI models are handed their sample of the field
+    FGAIManager aiManager;
+    FGAIManager::ai_list_type models;
+    models.push_back(new FGAIStatic);
+    models.back()->setGeodPos(SGGeod::fromDegFt(0.0, 0.0, 3000.0));
+    aiManager.updateAtmosphere(&field, models, 1500.0);
+    const AtmosphereField::Sample* atmosphere = models.back()->getAtmosphere();
+    CPPUNIT_ASSERT(atmosphere);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(field.sample(3000.0, 1500.0).windFromNorthFps,
+                                 atmosphere->windFromNorthFps, 1e-6);
+
+    // a disabled controller drops the field instead of leaving it stale,
+    // and the models with it
+    config->setBoolValue("enabled", false);
+    controller->update(0.1);
+    CPPUNIT_ASSERT(!field.valid());
+    CPPUNIT_ASSERT_EQUAL(0, fgGetInt("/environment/field/points"));
+    aiManager.updateAtmosphere(&field, models, 1500.0);
+    CPPUNIT_ASSERT(!models.back()->getAtmosphere());
+
+    config->setBoolValue("enabled", true);
+    controller->update(0.1);
+    CPPUNIT_ASSERT(field.valid());
+    aiManager.updateAtmosphere(&field, models, 1500.0);
+    CPPUNIT_ASSERT(models.back()->getAtmosphere());
+
+    // as does a missing environment manager
+    aiManager.updateAtmosphere(nullptr, models, 1500.0);
+    CPPUNIT_ASSERT(!models.back()->getAtmosphere());
+
+    controller->unbind();
+}
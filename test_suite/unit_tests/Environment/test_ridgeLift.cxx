@@ -0,0 +1,135 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_ridgeLift.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include <simgear/constants.h>
+#include <simgear/sg_inlines.h>
+
+#include <Environment/ridge_lift.hxx>
+
+
+namespace {
+
+const double DIST_PROBE_M[] = { 0.0, 250.0, 750.0, 2000.0, -100.0 };
+
+// The lift factor as FGRidgeLift::update_lift_factor() computed it inline.
+double referenceLiftFactor(const double probe_elev_m[5], double slope[4])
+{
+    double adj_slope[4];
+    slope[0] = (probe_elev_m[0] - probe_elev_m[1]) / DIST_PROBE_M[1];
+    slope[1] = (probe_elev_m[1] - probe_elev_m[2]) / DIST_PROBE_M[2];
+    slope[2] = (probe_elev_m[2] - probe_elev_m[3]) / DIST_PROBE_M[3];
+    slope[3] = (probe_elev_m[4] - probe_elev_m[0]) / -DIST_PROBE_M[4];
+
+    for (unsigned i = 0; i < 4; i++)
+        adj_slope[i] = sin(atan(5.0 * pow((fabs(slope[i])), 1.7))) * SG_SIGN<double>(slope[i]);
+
+    adj_slope[0] *= 0.2;
+    adj_slope[1] *= 0.2;
+    if (adj_slope[2] < 0.0) {
+        adj_slope[2] *= 0.5;
+    } else {
+        adj_slope[2] = 0.0;
+    }
+
+    if ((adj_slope[0] >= 0.0) && (adj_slope[3] < 0.0)) {
+        adj_slope[3] = 0.0;
+    } else {
+        adj_slope[3] *= 0.2;
+    }
+    return adj_slope[0] + adj_slope[1] + adj_slope[2] + adj_slope[3];
+}
+
+// The lift as FGRidgeLift::update() computed it inline.
+double referenceLiftMps(const double probe_elev_m[5], double lift_factor,
+                        double user_altitude_agl_m, double wind_speed_kt)
+{
+    const double BOUNDARY1_m = 40.0;
+    double boundary2_m = 130.0;
+    if (lift_factor < 0.0) {
+        double highest_probe_temp = std::max(probe_elev_m[1], probe_elev_m[2]);
+        double highest_probe_downwind_m = std::max(highest_probe_temp, probe_elev_m[3]);
+        boundary2_m = highest_probe_downwind_m - probe_elev_m[0];
+    }
+
+    double agl_factor;
+    if (user_altitude_agl_m < BOUNDARY1_m) {
+        agl_factor = 0.5 + 0.5 * user_altitude_agl_m / BOUNDARY1_m;
+    } else if (user_altitude_agl_m < boundary2_m) {
+        agl_factor = 1.0;
+    } else {
+        agl_factor = exp(-(2 + probe_elev_m[0] / 2000) *
+                         (user_altitude_agl_m - boundary2_m) / std::max(probe_elev_m[0], 200.0));
+    }
+
+    double ground_wind_speed_mps = wind_speed_kt * SG_NM_TO_METER / 3600;
+    return lift_factor * ground_wind_speed_mps * agl_factor;
+}
+
+} // of anonymous namespace
+
+
+// Set up function for each test.
+void RidgeLiftTests::setUp()
+{
+}
+
+
+// Clean up after each test.
+void RidgeLiftTests::tearDown()
+{
+}
+
+
+void RidgeLiftTests::testLiftMatchesReference()
+{
+    // probe 0 at the aircraft, 1..3 upwind, 4 just downwind
+    const double terrain[][5] = {
+        { 500.0, 400.0, 300.0, 300.0, 520.0 },    // windward slope
+        { 800.0, 400.0, 200.0, 150.0, 700.0 },    // ridge top
+        { 300.0, 450.0, 700.0, 900.0, 280.0 },    // lee side
+        { 100.0, 100.0, 100.0, 100.0, 100.0 },    // flat
+        { 1500.0, 1490.0, 1200.0, 1600.0, 1510.0 }
+    };
+    const double heights[] = { 0.0, 20.0, 80.0, 200.0, 600.0, 1500.0 };
+    const double winds[] = { 0.0, 12.0, 35.0 };
+
+    for (const auto& elev : terrain) {
+        double slope[4], expectedSlope[4];
+        const double factor = FGRidgeLift::compute_lift_factor(elev, slope);
+        const double expected = referenceLiftFactor(elev, expectedSlope);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, factor, 1e-12);
+        for (int i = 0; i < 4; ++i) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedSlope[i], slope[i], 1e-12);
+        }
+
+        for (double agl : heights) {
+            for (double wind : winds) {
+                const std::string at = "agl " + std::to_string(agl) +
+                                       " wind " + std::to_string(wind);
+                CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(at,
+                    referenceLiftMps(elev, factor, agl, wind),
+                    FGRidgeLift::compute_lift_mps(elev, factor, agl, wind), 1e-12);
+            }
+        }
+    }
+}
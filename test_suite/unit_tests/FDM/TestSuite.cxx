@@ -19,10 +19,12 @@
 
 #include "test_ls_matrix.hxx"
 #include "testAeroElement.hxx"
+#include "testWakeMesh.hxx"
 #include "testYASimAtmosphere.hxx"
 
 
 // Set up the unit tests.
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(AeroElementTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(LaRCSimMatrixTests, "Unit tests");
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(WakeMeshTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(YASimAtmosphereTests, "Unit tests");
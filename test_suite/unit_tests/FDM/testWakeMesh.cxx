@@ -0,0 +1,106 @@
+#include <vector>
+
+#include <simgear/constants.h>
+#include <simgear/structure/SGSharedPtr.hxx>
+#include <simgear/math/SGVec3.hxx>
+
+#include "FDM/AIWake/WakeMesh.hxx"
+
+#include "testWakeMesh.hxx"
+
+
+namespace {
+
+// Exposes the elements and their strength, to compute the reference sum.
+class TestWakeMesh : public WakeMesh {
+public:
+    TestWakeMesh(double span = 30.0, double chord = 4.0)
+        : WakeMesh(span, chord) {
+        computeAoA(200.0, 0.0023769, 100000.0);
+    }
+
+    const WakeMeshGeometry* getGeometry() const { return geometry.get(); }
+
+    SGVec3d referenceVelocityAt(const SGVec3d& at) const {
+        SGVec3d v(0., 0., 0.);
+        for (int i=0; i<nelm; ++i)
+            v += Gamma[i] * geometry->elements[i]->getInducedVelocity(at);
+        return v;
+    }
+
+    std::vector<SGVec3d> testPoints() const {
+        const std::vector<AeroElement_ptr>& elements = geometry->elements;
+        std::vector<SGVec3d> pts;
+        for (int i=0; i<nelm; ++i) {
+            // Includes the singular points on the vortices themselves.
+            pts.push_back(elements[i]->getCollocationPoint());
+            pts.push_back(elements[i]->getBoundVortexMidPoint());
+            pts.push_back(elements[i]->getBoundVortexStart());
+            pts.push_back(elements[i]->getBoundVortexStart()
+                          + SGVec3d(-100., 0., 0.));
+            pts.push_back(elements[i]->getBoundVortexMidPoint()
+                          + SGVec3d(-50., 1.5, -3.0));
+        }
+        pts.push_back(SGVec3d(500., 20., 10.));
+        pts.push_back(SGVec3d(-2000., -10., 40.));
+        return pts;
+    }
+};
+
+}
+
+
+void WakeMeshTests::testInducedVelocityMatchesElements()
+{
+    SGSharedPtr<TestWakeMesh> mesh = new TestWakeMesh;
+
+    for (const auto& p : mesh->testPoints()) {
+        SGVec3d ref = mesh->referenceVelocityAt(p);
+        SGVec3d v = mesh->getInducedVelocityAt(p);
+        double tol = 1e-9 * (1.0 + norm(ref));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(ref[0], v[0], tol);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(ref[1], v[1], tol);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(ref[2], v[2], tol);
+    }
+}
+
+void WakeMeshTests::testBatchedInducedVelocity()
+{
+    SGSharedPtr<TestWakeMesh> mesh = new TestWakeMesh;
+    std::vector<SGVec3d> pts = mesh->testPoints();
+    size_t count = pts.size();
+
+    std::vector<double> x, y, z;
+    for (const auto& p : pts) {
+        x.push_back(p[0]); y.push_back(p[1]); z.push_back(p[2]);
+    }
+
+    // The velocities are added to the initial values.
+    std::vector<double> vx(count, 1.0), vy(count, 2.0), vz(count, 3.0);
+    mesh->addInducedVelocities(count, x.data(), y.data(), z.data(),
+                               vx.data(), vy.data(), vz.data());
+
+    for (size_t j=0; j<count; ++j) {
+        SGVec3d ref = mesh->referenceVelocityAt(pts[j]);
+        double tol = 1e-9 * (1.0 + norm(ref));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(ref[0] + 1.0, vx[j], tol);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(ref[1] + 2.0, vy[j], tol);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(ref[2] + 3.0, vz[j], tol);
+    }
+}
+
+void WakeMeshTests::testSharedGeometry()
+{
+    SGSharedPtr<TestWakeMesh> mesh1 = new TestWakeMesh(30.0, 4.0);
+    SGSharedPtr<TestWakeMesh> mesh2 = new TestWakeMesh(30.0, 4.0);
+    SGSharedPtr<TestWakeMesh> mesh3 = new TestWakeMesh(60.0, 7.0);
+
+    CPPUNIT_ASSERT(mesh1->getGeometry() == mesh2->getGeometry());
+    CPPUNIT_ASSERT(mesh1->getGeometry() != mesh3->getGeometry());
+
+    // The circulation remains specific to each mesh.
+    mesh2->computeAoA(100.0, 0.0023769, 100000.0);
+    SGVec3d p(-50., 2., -3.);
+    CPPUNIT_ASSERT(norm(mesh1->getInducedVelocityAt(p)
+                        - mesh2->getInducedVelocityAt(p)) > 1e-6);
+}
@@ -1,8 +1,12 @@
 #include "test_flightplan.hxx"
 
+#include <algorithm>
+#include <set>
+
 #include "test_suite/FGTestApi/testGlobals.hxx"
 #include "test_suite/FGTestApi/NavDataCache.hxx"
 
+#include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/misc/strutils.hxx>
 
 #include <Navaids/FlightPlan.hxx>
@@ -16,6 +20,8 @@
 
 #include <Airports/airport.hxx>
 
+#include <Main/globals.hxx>
+
 using namespace flightgear;
 
 
@@ -244,6 +250,152 @@ void FlightplanTests::testAirwayNetworkRoute()
     CPPUNIT_ASSERT_EQUAL(static_cast<int>(route.size()), 18);
 }
 
+// A* over the airway edges as Airway::Network::search2() did before it
+// worked on a prebuilt graph: neighbours straight from the cache, open
+// nodes in a plain heap which is rebuilt when a path improves.
+static bool referenceAirwaySearch(int network, FGPositionedRef start, FGPositionedRef dest,
+                                  std::vector<FGPositionedRef>& path, double& distanceM)
+{
+    struct Open
+    {
+        FGPositionedRef node;
+        int previous;
+        double fromStart;
+        double toDest;
+    };
+
+    NavDataCache* cache = NavDataCache::instance();
+    std::vector<Open> nodes;
+    std::vector<int> open;
+    std::set<PositionedID> closed;
+    auto order = [&nodes](int a, int b) {
+        return (nodes[a].fromStart + nodes[a].toDest) > (nodes[b].fromStart + nodes[b].toDest);
+    };
+
+    nodes.push_back({start, -1, 0.0, SGGeodesy::distanceM(start->geod(), dest->geod())});
+    open.push_back(0);
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), order);
+        const int x = open.back();
+        open.pop_back();
+        FGPositionedRef xp = nodes[x].node;
+        closed.insert(xp->guid());
+
+        if (xp == dest) {
+            distanceM = nodes[x].fromStart;
+            path.clear();
+            for (int n = x; n >= 0; n = nodes[n].previous) {
+                path.insert(path.begin(), nodes[n].node);
+            }
+            return true;
+        }
+
+        for (auto other : cache->airwayEdgesFrom(network, xp->guid())) {
+            if (closed.count(other.second)) {
+                continue;
+            }
+
+            FGPositionedRef yp = cache->loadById(other.second);
+            const double g = nodes[x].fromStart + SGGeodesy::distanceM(xp->geod(), yp->geod());
+            auto y = std::find_if(open.begin(), open.end(),
+                                  [&nodes, &yp](int n) { return nodes[n].node == yp; });
+            if (y != open.end()) {
+                if (g > nodes[*y].fromStart) {
+                    continue;
+                }
+
+                nodes[*y].fromStart = g;
+                nodes[*y].previous = x;
+                std::make_heap(open.begin(), open.end(), order);
+            } else {
+                nodes.push_back({yp, x, g, SGGeodesy::distanceM(yp->geod(), dest->geod())});
+                open.push_back(static_cast<int>(nodes.size()) - 1);
+                std::push_heap(open.begin(), open.end(), order);
+            }
+        }
+    }
+
+    return false;
+}
+
+void FlightplanTests::testAirwayNetworkMatchesReference()
+{
+    const char* cityPairs[][2] = {
+        {"EGPH", "LEMD"},
+        {"EGLL", "LIRF"},
+        {"KJFK", "KLAX"},
+        {"KBOS", "KMIA"}
+    };
+
+    auto highLevelNet = Airway::highLevel();
+    for (auto pair : cityPairs) {
+        FGPositionedRef from = highLevelNet->findClosestNode(FGAirport::findByIdent(pair[0])->geod()).first;
+        FGPositionedRef to = highLevelNet->findClosestNode(FGAirport::findByIdent(pair[1])->geod()).first;
+        CPPUNIT_ASSERT(from && to);
+
+        std::vector<FGPositionedRef> expected;
+        double expectedM = 0.0;
+        CPPUNIT_ASSERT(referenceAirwaySearch(Airway::HighLevel, from, to, expected, expectedM));
+
+        // both ends are on the network, so route() leaves them out
+        WayptVec route;
+        CPPUNIT_ASSERT(highLevelNet->route(new NavaidWaypoint(from, nullptr),
+                                           new NavaidWaypoint(to, nullptr), route));
+        CPPUNIT_ASSERT_EQUAL(expected.size() - 2, route.size());
+
+        double distanceM = 0.0;
+        SGGeod previous = from->geod();
+        for (size_t i = 0; i < route.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(expected[i + 1]->guid(), route[i]->source()->guid());
+            distanceM += SGGeodesy::distanceM(previous, route[i]->position());
+            previous = route[i]->position();
+        }
+        distanceM += SGGeodesy::distanceM(previous, to->geod());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedM, distanceM, 1.0);
+    }
+
+    // an airway not connected to anything else; the transaction is never
+    // committed, so it does not stay in the cache
+    unsigned int generation = NavDataCache::generation();
+    {
+        NavDataCache::Transaction txn(NavDataCache::instance());
+        SGPath awyPath = globals->get_fg_home() / "test_isolated_awy.dat";
+        {
+            sg_ofstream f(awyPath);
+            f << "I\n640 Version\n"
+              << "ZZISA -45.0 -130.0 ZZISB -45.5 -130.5 2 180 450 ZZISL\n"
+              << "99\n";
+        }
+        Airway::loadAWYDat(awyPath);
+        awyPath.remove();
+
+        // the graph built by the searches above is stale now
+        CPPUNIT_ASSERT(NavDataCache::generation() != generation);
+
+        FGPositionedRef isolated = FGPositioned::findClosestWithIdent("ZZISA", SGGeod::fromDeg(-130.0, -45.0));
+        FGPositionedRef isolatedEnd = FGPositioned::findClosestWithIdent("ZZISB", SGGeod::fromDeg(-130.5, -45.5));
+        CPPUNIT_ASSERT(isolated && isolatedEnd);
+        FGPositionedRef egph = highLevelNet->findClosestNode(FGAirport::findByIdent("EGPH")->geod()).first;
+
+        std::vector<FGPositionedRef> expected;
+        double expectedM = 0.0;
+        CPPUNIT_ASSERT(!referenceAirwaySearch(Airway::HighLevel, isolated, egph, expected, expectedM));
+
+        WayptVec route;
+        CPPUNIT_ASSERT(!highLevelNet->route(new NavaidWaypoint(isolated, nullptr),
+                                           new NavaidWaypoint(egph, nullptr), route));
+
+        // but the new airway itself is routable
+        CPPUNIT_ASSERT(highLevelNet->route(new NavaidWaypoint(isolated, nullptr),
+                                          new NavaidWaypoint(isolatedEnd, nullptr), route));
+        generation = NavDataCache::generation();
+    }
+
+    // and so is any graph with the airway in it, once it is rolled back
+    CPPUNIT_ASSERT(NavDataCache::generation() != generation);
+}
+
 void FlightplanTests::testParseICAORoute()
 {
     FGAirportRef kord = FGAirport::findByIdent("KORD");
@@ -320,3 +472,126 @@ void FlightplanTests::testBug1814()
     CPPUNIT_ASSERT_DOUBLES_EQUAL(137, leg->distanceNm(), 0.5);
     CPPUNIT_ASSERT_DOUBLES_EQUAL(101, f->legAtIndex(2)->distanceNm(), 0.5);
 }
+
+// EGCC to EHAM, zig-zagging through legCount - 2 enroute waypoints
+static FlightPlanRef makeLongTestFP(int legCount)
+{
+    FlightPlanRef fp = makeTestFP("EGCC", "23L", "EHAM", "24", "");
+    const SGGeod from = fp->departureAirport()->geod();
+    const SGGeod to = fp->destinationAirport()->geod();
+
+    WayptVec wps;
+    const int enroute = legCount - 2;
+    for (int i = 0; i < enroute; ++i) {
+        const double f = (i + 1.0) / (enroute + 1.0);
+        const double offset = (i % 2) ? 0.05 : -0.05;
+        const SGGeod pos = SGGeod::fromDeg(
+            from.getLongitudeDeg() + f * (to.getLongitudeDeg() - from.getLongitudeDeg()),
+            from.getLatitudeDeg() + f * (to.getLatitudeDeg() - from.getLatitudeDeg()) + offset);
+        wps.push_back(new BasicWaypt(pos, "WP" + std::to_string(i), fp));
+    }
+
+    fp->insertWayptsAtIndex(wps, 1);
+    return fp;
+}
+
+static void checkSameAsFreshPath(FlightPlanRef fp)
+{
+    const RoutePath& cached = fp->routePath();
+    RoutePath fresh(fp);
+    for (int l = 0; l < fp->numLegs(); ++l) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(fresh.trackForIndex(l), cached.trackForIndex(l), 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(fresh.distanceForIndex(l), cached.distanceForIndex(l), 1e-6);
+
+        const SGGeodVec a = fresh.pathForIndex(l), b = cached.pathForIndex(l);
+        CPPUNIT_ASSERT_EQUAL(a.size(), b.size());
+        for (size_t p = 0; p < a.size(); ++p) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(a[p].getLatitudeDeg(), b[p].getLatitudeDeg(), 1e-9);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(a[p].getLongitudeDeg(), b[p].getLongitudeDeg(), 1e-9);
+        }
+    }
+}
+
+void FlightplanTests::testCachedRoutePath()
+{
+    FlightPlanRef fp = makeLongTestFP(40);
+    checkSameAsFreshPath(fp);
+
+    const RoutePath* path = &fp->routePath();
+
+    // insert, in the middle and at both ends
+    fp->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(-1.0, 53.0), "INS1", fp), 20);
+    checkSameAsFreshPath(fp);
+    fp->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(-2.0, 53.5), "INS2", fp), 1);
+    checkSameAsFreshPath(fp);
+    fp->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(4.5, 52.4), "INS3", fp),
+                           fp->numLegs() - 1);
+    checkSameAsFreshPath(fp);
+
+    // duplicate of the previous waypoint, which is skipped, and removing it again
+    fp->insertWayptAtIndex(new BasicWaypt(fp->legAtIndex(10)->waypoint()->position(), "DUP", fp), 11);
+    checkSameAsFreshPath(fp);
+    fp->deleteIndex(11);
+    checkSameAsFreshPath(fp);
+
+    // delete the departure and a run of waypoints
+    fp->deleteIndex(0);
+    checkSameAsFreshPath(fp);
+    for (int i = 0; i < 5; ++i) {
+        fp->deleteIndex(15);
+    }
+    checkSameAsFreshPath(fp);
+
+    // changing a waypoint in place
+    fp->legAtIndex(8)->waypoint()->setFlag(WPT_OVERFLIGHT, true);
+    fp->legAtIndex(8)->markWaypointDirty();
+    checkSameAsFreshPath(fp);
+
+    fp->setFollowLegTrackToFixes(false);
+    checkSameAsFreshPath(fp);
+
+    // the same object is kept throughout
+    CPPUNIT_ASSERT(path == &fp->routePath());
+}
+
+void FlightplanTests::testCachedRoutePathSharedWaypoints()
+{
+    FlightPlanRef fp = makeLongTestFP(20);
+    FlightPlanRef copy = fp->clone("copy");
+    CPPUNIT_ASSERT(fp->legAtIndex(5)->waypoint() == copy->legAtIndex(5)->waypoint());
+    checkSameAsFreshPath(fp);
+    checkSameAsFreshPath(copy);
+
+    // a waypoint shared by both plans, changed without going through either
+    fp->legAtIndex(5)->waypoint()->setFlag(WPT_OVERFLIGHT, true);
+    checkSameAsFreshPath(fp);
+    checkSameAsFreshPath(copy);
+
+    copy->legAtIndex(9)->waypoint()->setFlag(WPT_OVERFLIGHT, true);
+    checkSameAsFreshPath(copy);
+    checkSameAsFreshPath(fp);
+
+    // a waypoint without an owner, as createWP() makes them, in a plan
+    // which is not the active one
+    const SGGeod a = copy->legAtIndex(11)->waypoint()->position();
+    const SGGeod b = copy->legAtIndex(12)->waypoint()->position();
+    WayptRef unowned = new BasicWaypt(SGGeod::fromDeg(0.5 * (a.getLongitudeDeg() + b.getLongitudeDeg()) + 0.2,
+                                                      0.5 * (a.getLatitudeDeg() + b.getLatitudeDeg())),
+                                      "FREE", nullptr);
+    copy->insertWayptAtIndex(unowned, 12);
+    checkSameAsFreshPath(copy);
+
+    const double before = copy->routePath().distanceBetweenIndices(11, 14);
+    unowned->setFlag(WPT_OVERFLIGHT, true);
+    checkSameAsFreshPath(copy);
+    CPPUNIT_ASSERT(copy->routePath().distanceBetweenIndices(11, 14) != before);
+
+    // hold parameters count as changes too
+    Hold* hold = new Hold(copy->legAtIndex(14)->waypoint()->position(), "HOLD", copy);
+    hold->setHoldTime(60.0);
+    copy->insertWayptAtIndex(hold, 15);
+    checkSameAsFreshPath(copy);
+    hold->setHoldRadial(270.0);
+    hold->setLeftHanded();
+    checkSameAsFreshPath(copy);
+}
@@ -37,9 +37,12 @@ class FlightplanTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testRoutePathTrivialFlightPlan);
     CPPUNIT_TEST(testBasicAirways);
     CPPUNIT_TEST(testAirwayNetworkRoute);
+    CPPUNIT_TEST(testAirwayNetworkMatchesReference);
     CPPUNIT_TEST(testBug1814);
     CPPUNIT_TEST(testRoutPathWpt0Midflight);
     CPPUNIT_TEST(testRoutePathVec);
+    CPPUNIT_TEST(testCachedRoutePath);
+    CPPUNIT_TEST(testCachedRoutePathSharedWaypoints);
     
   //  CPPUNIT_TEST(testParseICAORoute);
    // CPPUNIT_TEST(testParseICANLowLevelRoute);
@@ -59,11 +62,14 @@ public:
     void testRoutePathTrivialFlightPlan();
     void testBasicAirways();
     void testAirwayNetworkRoute();
+    void testAirwayNetworkMatchesReference();
     void testParseICAORoute();
     void testParseICANLowLevelRoute();
     void testBug1814();
     void testRoutPathWpt0Midflight();
     void testRoutePathVec();
+    void testCachedRoutePath();
+    void testCachedRoutePathSharedWaypoints();
 };
 
 #endif  // FG_FLIGHTPLAN_UNIT_TESTS_HXX
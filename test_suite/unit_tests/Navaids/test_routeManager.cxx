@@ -11,6 +11,7 @@
 #include <Navaids/NavDataCache.hxx>
 #include <Navaids/navrecord.hxx>
 #include <Navaids/navlist.hxx>
+#include <Navaids/routePath.hxx>
 
 // we need a default GPS instrument, hard to test seperately for now
 #include <Instrumentation/gps.hxx>
@@ -411,3 +412,39 @@ void RouteManagerTests::testHoldFromNasal()
     // get back on course
     FGTestApi::runForTime(60.0);
 }
+
+void RouteManagerTests::testWaypointChangeFromNasal()
+{
+    FlightPlanRef fp1 = makeTestFP("NZCH", "02", "NZAA", "05L",
+                                   "ALADA NS WB WN MAMOD KAPTI OH");
+    fp1->setIdent("testplan");
+
+    auto rm = globals->get_subsystem<FGRouteMgr>();
+    rm->setFlightPlan(fp1);
+
+    // a dog-leg between WB and WN, so flying over it changes the path
+    const SGGeod a = fp1->legAtIndex(3)->waypoint()->position();
+    const SGGeod b = fp1->legAtIndex(4)->waypoint()->position();
+    const double lat = 0.5 * (a.getLatitudeDeg() + b.getLatitudeDeg());
+    const double lon = 0.5 * (a.getLongitudeDeg() + b.getLongitudeDeg()) + 0.3;
+
+    // the waypoint ghost is not the leg ghost, and createWP() gives it no
+    // owner: changing it must still update the cached route path
+    bool ok = FGTestApi::executeNasal(
+        "var fp = flightplan();\n"
+        "var wp = createWP(" + std::to_string(lat) + ", " + std::to_string(lon) + ", \"DOGLG\");\n"
+        "fp.insertWP(wp, 4);\n"
+        "wp.fly_type = \"flyOver\";\n");
+    CPPUNIT_ASSERT(ok);
+
+    FlightPlan::Leg* leg = fp1->legAtIndex(4);
+    CPPUNIT_ASSERT_EQUAL(std::string("DOGLG"), leg->waypoint()->ident());
+    CPPUNIT_ASSERT(leg->waypoint()->flag(WPT_OVERFLIGHT));
+
+    const RoutePath& cached = fp1->routePath();
+    RoutePath fresh(fp1);
+    for (int l = 0; l < fp1->numLegs(); ++l) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(fresh.trackForIndex(l), cached.trackForIndex(l), 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(fresh.distanceForIndex(l), cached.distanceForIndex(l), 1e-6);
+    }
+}
@@ -38,6 +38,7 @@ class RouteManagerTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testDefaultApproach);
     CPPUNIT_TEST(testDirectToLegOnFlightplanAndResume);
     CPPUNIT_TEST(testHoldFromNasal);
+    CPPUNIT_TEST(testWaypointChangeFromNasal);
     CPPUNIT_TEST_SUITE_END();
 
    // void setPositionAndStabilise(FGNavRadio* r, const SGGeod& g);
@@ -57,6 +58,7 @@ public:
     void testDefaultApproach();
     void testDirectToLegOnFlightplanAndResume();
     void testHoldFromNasal();
+    void testWaypointChangeFromNasal();
 private:
     GPS* m_gps = nullptr;
 };
@@ -0,0 +1,225 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_terrainQuery.hxx"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <Main/fg_props.hxx>
+#include <Scenery/terrainquery.hxx>
+
+
+namespace {
+
+const double CELL_SIZE_M = 100.0;
+const double GROUND_M = 500.0;
+const double BRIDGE_M = 600.0;
+
+// Flat ground with a bridge deck across all of it: probes from above the
+// deck find the deck, probes from underneath find the ground.
+class StubTerrainQuery : public FGTerrainQuery
+{
+public:
+    StubTerrainQuery() : FGTerrainQuery(nullptr) {}
+
+    bool loaded = true;
+    int probes = 0;
+
+protected:
+    Result probe(const SGGeod& geod) override
+    {
+        ++probes;
+        Result result;
+        result.valid = loaded;
+        result.elevationM = (geod.getElevationM() >= BRIDGE_M) ? BRIDGE_M : GROUND_M;
+        return result;
+    }
+};
+
+// The centre of the cache cell a position falls into, so nearby points
+// are in the same cell for sure.
+SGGeod cellCenter(double lon, double lat, double elevM)
+{
+    const double cellDeg = CELL_SIZE_M / (60.0 * SG_NM_TO_METER);
+    return SGGeod::fromDegM((floor((lon + 180.0) / cellDeg) + 0.5) * cellDeg - 180.0,
+                            (floor((lat + 90.0) / cellDeg) + 0.5) * cellDeg - 90.0,
+                            elevM);
+}
+
+} // of anonymous namespace
+
+
+// Set up function for each test.
+void TerrainQueryTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("terrainQuery");
+    fgSetDouble("/sim/terrain-query/cache-resolution-m", CELL_SIZE_M);
+    fgSetDouble("/sim/terrain-query/cache-max-age-sec", 10.0);
+}
+
+
+// Clean up after each test.
+void TerrainQueryTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void TerrainQueryTests::testReuse()
+{
+    StubTerrainQuery query;
+    query.init();
+
+    const SGGeod pos = cellCenter(8.53, 47.31, 3000.0);
+    double elev;
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(BRIDGE_M, elev);
+    CPPUNIT_ASSERT_EQUAL(1, query.probes);
+
+    // the same point, and another one in the same cell
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(BRIDGE_M, elev);
+    const SGGeod nearby = SGGeod::fromDegM(pos.getLongitudeDeg() + 1e-5,
+                                           pos.getLatitudeDeg() - 1e-5, 3000.0);
+    CPPUNIT_ASSERT(query.get_elevation_m(nearby, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(1, query.probes);
+
+    // the neighbouring cell is probed
+    const SGGeod next = cellCenter(8.53 + 0.01, 47.31, 3000.0);
+    CPPUNIT_ASSERT(query.get_elevation_m(next, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(2, query.probes);
+
+    // batches go through the cache as well
+    std::vector<SGGeod> points = {pos, next, nearby};
+    std::future<FGTerrainQuery::ResultList> future = query.query(points);
+    query.update(0.1);
+    CPPUNIT_ASSERT(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    const FGTerrainQuery::ResultList results = future.get();
+    CPPUNIT_ASSERT_EQUAL(size_t(3), results.size());
+    for (const auto& r : results) {
+        CPPUNIT_ASSERT(r.valid);
+        CPPUNIT_ASSERT_EQUAL(BRIDGE_M, r.elevationM);
+    }
+    CPPUNIT_ASSERT_EQUAL(2, query.probes);
+
+    CPPUNIT_ASSERT_EQUAL(5, fgGetInt("/sim/terrain-query/cache-hits"));
+    CPPUNIT_ASSERT_EQUAL(2, fgGetInt("/sim/terrain-query/cache-misses"));
+}
+
+
+void TerrainQueryTests::testStartAltitude()
+{
+    StubTerrainQuery query;
+    query.init();
+
+    double elev;
+    CPPUNIT_ASSERT(query.get_elevation_m(cellCenter(8.53, 47.31, 3000.0), elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(BRIDGE_M, elev);
+    CPPUNIT_ASSERT_EQUAL(1, query.probes);
+
+    // starting between the hit and the original start, the deck is still
+    // the first surface below
+    CPPUNIT_ASSERT(query.get_elevation_m(cellCenter(8.53, 47.31, 1000.0), elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(BRIDGE_M, elev);
+    CPPUNIT_ASSERT(query.get_elevation_m(cellCenter(8.53, 47.31, BRIDGE_M), elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(BRIDGE_M, elev);
+    CPPUNIT_ASSERT_EQUAL(1, query.probes);
+
+    // from underneath the deck, the ground is found
+    CPPUNIT_ASSERT(query.get_elevation_m(cellCenter(8.53, 47.31, 550.0), elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(GROUND_M, elev);
+    CPPUNIT_ASSERT_EQUAL(2, query.probes);
+
+    // that hit does not answer for starting above its start altitude,
+    // where the deck is in the way
+    CPPUNIT_ASSERT(query.get_elevation_m(cellCenter(8.53, 47.31, 520.0), elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(GROUND_M, elev);
+    CPPUNIT_ASSERT_EQUAL(2, query.probes);
+    CPPUNIT_ASSERT(query.get_elevation_m(cellCenter(8.53, 47.31, 3000.0), elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(BRIDGE_M, elev);
+    CPPUNIT_ASSERT_EQUAL(3, query.probes);
+}
+
+
+void TerrainQueryTests::testExpiry()
+{
+    StubTerrainQuery query;
+    query.init();
+
+    const SGGeod pos = cellCenter(8.53, 47.31, 3000.0);
+    double elev;
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(1, query.probes);
+
+    query.update(6.0);
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(1, query.probes);
+
+    // older than cache-max-age-sec
+    query.update(6.0);
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(2, query.probes);
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(2, query.probes);
+
+    query.clearCache();
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(3, query.probes);
+
+    // changing the resolution drops the cache as well
+    fgSetDouble("/sim/terrain-query/cache-resolution-m", 2.0 * CELL_SIZE_M);
+    query.update(0.1);
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(4, query.probes);
+}
+
+
+void TerrainQueryTests::testInvalidNotCached()
+{
+    StubTerrainQuery query;
+    query.init();
+
+    // terrain which is not loaded yet
+    query.loaded = false;
+    const SGGeod pos = cellCenter(8.53, 47.31, 3000.0);
+    double elev;
+    CPPUNIT_ASSERT(!query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT(!query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(2, query.probes);
+
+    // the tile arrived
+    query.loaded = true;
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(BRIDGE_M, elev);
+    CPPUNIT_ASSERT(query.get_elevation_m(pos, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(3, query.probes);
+
+    // invalid results in batches are not cached either
+    query.clearCache();
+    query.loaded = false;
+    std::vector<SGGeod> points = {pos, pos};
+    std::future<FGTerrainQuery::ResultList> future = query.query(points);
+    query.update(0.1);
+    const FGTerrainQuery::ResultList results = future.get();
+    CPPUNIT_ASSERT(!results[0].valid);
+    CPPUNIT_ASSERT(!results[1].valid);
+    CPPUNIT_ASSERT_EQUAL(5, query.probes);
+}
@@ -0,0 +1,220 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_terrainRaster.hxx"
+
+#include <chrono>
+
+#include <simgear/bucket/newbucket.hxx>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <Main/fg_props.hxx>
+#include <Scenery/terrainquery.hxx>
+#include <Scenery/terrainraster.hxx>
+
+
+namespace {
+
+// Plane terrain, so bilinear interpolation reproduces it exactly.
+double terrainElevationM(const SGGeod& geod)
+{
+    return 1000.0 + 2000.0 * (geod.getLatitudeDeg() - 47.0)
+        + 3000.0 * (geod.getLongitudeDeg() - 8.0);
+}
+
+class StubTerrainQuery : public FGTerrainQuery
+{
+public:
+    StubTerrainQuery() : FGTerrainQuery(nullptr) {}
+
+    bool loaded = true;
+    int probes = 0;
+
+protected:
+    Result probe(const SGGeod& geod) override
+    {
+        ++probes;
+        Result result;
+        result.valid = loaded;
+        result.elevationM = terrainElevationM(geod);
+        return result;
+    }
+};
+
+void runFrames(StubTerrainQuery& query, FGTerrainRaster& raster, int count,
+               double dt = 0.1)
+{
+    for (int i = 0; i < count; ++i) {
+        query.update(dt);
+        raster.update(dt);
+    }
+}
+
+} // of anonymous namespace
+
+
+// Set up function for each test.
+void TerrainRasterTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("terrainRaster");
+    fgSetInt("/sim/terrain-raster/posts", 9);
+}
+
+
+// Clean up after each test.
+void TerrainRasterTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void TerrainRasterTests::testInterpolation()
+{
+    StubTerrainQuery query;
+    query.init();
+    FGTerrainRaster raster(&query);
+    raster.init();
+
+    const SGGeod pos = SGGeod::fromDeg(8.53, 47.31);
+    double elev;
+    CPPUNIT_ASSERT(!raster.get_elevation_m(pos, elev));
+    runFrames(query, raster, 5);
+    CPPUNIT_ASSERT(raster.get_elevation_m(pos, elev));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(terrainElevationM(pos), elev, 0.01);
+
+    // posts are not put into the elevation cache
+    CPPUNIT_ASSERT_EQUAL(0, fgGetInt("/sim/terrain-query/cache-misses"));
+
+    const SGBucket bucket(pos);
+    const double minLat = bucket.get_center_lat() - 0.5 * bucket.get_height();
+    const double maxLat = bucket.get_center_lat() + 0.5 * bucket.get_height();
+    const double minLon = bucket.get_center_lon() - 0.5 * bucket.get_width();
+    const double maxLon = bucket.get_center_lon() + 0.5 * bucket.get_width();
+
+    // between the posts and at the corners of the tile
+    for (int i = 0; i <= 20; ++i) {
+        const double f = i / 20.0;
+        const SGGeod p = SGGeod::fromDeg(minLon + f * (maxLon - minLon),
+                                         minLat + (1.0 - f) * (maxLat - minLat));
+        if (SGBucket(p).gen_index() != bucket.gen_index())
+            continue; // on the far edge, belongs to the neighbour
+
+        CPPUNIT_ASSERT(raster.get_elevation_m(p, elev));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(terrainElevationM(p), elev, 0.01);
+    }
+
+    // both sides of the western edge agree
+    const SGGeod inside = SGGeod::fromDeg(minLon + 1e-7, 47.31);
+    const SGGeod outside = SGGeod::fromDeg(minLon - 1e-7, 47.31);
+    CPPUNIT_ASSERT(SGBucket(outside).gen_index() != bucket.gen_index());
+    double elevOutside;
+    CPPUNIT_ASSERT(!raster.get_elevation_m(outside, elevOutside));
+    runFrames(query, raster, 5);
+    CPPUNIT_ASSERT(raster.get_elevation_m(inside, elev));
+    CPPUNIT_ASSERT(raster.get_elevation_m(outside, elevOutside));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(elev, elevOutside, 0.01);
+    CPPUNIT_ASSERT_EQUAL(2, fgGetInt("/sim/terrain-raster/rasters"));
+}
+
+
+void TerrainRasterTests::testBackgroundBatches()
+{
+    // no time budget: one point per queue and frame
+    fgSetDouble("/sim/terrain-query/max-time-ms", 0.0);
+
+    StubTerrainQuery query;
+    query.init();
+    FGTerrainRaster raster(&query);
+    raster.init();
+
+    const SGGeod pos = SGGeod::fromDeg(8.53, 47.31);
+    double elev;
+    CPPUNIT_ASSERT(!raster.get_elevation_m(pos, elev));
+
+    std::vector<SGGeod> points(3, SGGeod::fromDegM(8.6, 47.2, 5000.0));
+    std::future<FGTerrainQuery::ResultList> future = query.query(points);
+    runFrames(query, raster, 3);
+
+    // the batch queued after the raster is done first
+    CPPUNIT_ASSERT(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    CPPUNIT_ASSERT(!raster.get_elevation_m(pos, elev));
+    CPPUNIT_ASSERT_EQUAL(1, fgGetInt("/sim/terrain-raster/pending-rasters"));
+
+    runFrames(query, raster, 81);
+    CPPUNIT_ASSERT(raster.get_elevation_m(pos, elev));
+    CPPUNIT_ASSERT_EQUAL(0, fgGetInt("/sim/terrain-raster/pending-rasters"));
+}
+
+
+void TerrainRasterTests::testRetryInvalidPosts()
+{
+    StubTerrainQuery query;
+    query.init();
+    FGTerrainRaster raster(&query);
+    raster.init();
+
+    query.loaded = false;
+    const SGGeod pos = SGGeod::fromDeg(8.53, 47.31);
+    double elev;
+    CPPUNIT_ASSERT(!raster.get_elevation_m(pos, elev));
+    runFrames(query, raster, 5);
+    CPPUNIT_ASSERT_EQUAL(81, query.probes);
+
+    // not asked again right away
+    CPPUNIT_ASSERT(!raster.get_elevation_m(pos, elev));
+    runFrames(query, raster, 5);
+    CPPUNIT_ASSERT(!raster.get_elevation_m(pos, elev));
+    CPPUNIT_ASSERT_EQUAL(81, query.probes);
+
+    // the scenery is loaded by the time the raster is retried
+    query.loaded = true;
+    runFrames(query, raster, 1, 5.0);
+    CPPUNIT_ASSERT(!raster.get_elevation_m(pos, elev));
+    runFrames(query, raster, 5);
+    CPPUNIT_ASSERT_EQUAL(162, query.probes);
+    CPPUNIT_ASSERT(raster.get_elevation_m(pos, elev));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(terrainElevationM(pos), elev, 0.01);
+}
+
+
+void TerrainRasterTests::testMaxAge()
+{
+    fgSetDouble("/sim/terrain-raster/max-age-sec", 10.0);
+
+    StubTerrainQuery query;
+    query.init();
+    FGTerrainRaster raster(&query);
+    raster.init();
+
+    const SGGeod pos = SGGeod::fromDeg(8.53, 47.31);
+    double elev;
+    CPPUNIT_ASSERT(!raster.get_elevation_m(pos, elev));
+    runFrames(query, raster, 5);
+    CPPUNIT_ASSERT(raster.get_elevation_m(pos, elev));
+    CPPUNIT_ASSERT_EQUAL(1, fgGetInt("/sim/terrain-raster/rasters"));
+
+    // kept while in use
+    for (int i = 0; i < 30; ++i) {
+        runFrames(query, raster, 1, 1.0);
+        CPPUNIT_ASSERT(raster.get_elevation_m(pos, elev));
+    }
+
+    runFrames(query, raster, 1, 11.0);
+    CPPUNIT_ASSERT_EQUAL(0, fgGetInt("/sim/terrain-raster/rasters"));
+    CPPUNIT_ASSERT(!raster.get_elevation_m(pos, elev));
+}
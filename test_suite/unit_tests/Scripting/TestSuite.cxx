@@ -18,7 +18,9 @@
  */
 
 #include "testNasalSys.hxx"
+#include "testNasalTimerQueue.hxx"
 
 
 // Set up the unit tests.
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(NasalSysTests, "Unit tests");
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(NasalTimerQueueTests, "Unit tests");
@@ -20,16 +20,30 @@
 
 #include "testNasalSys.hxx"
 
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <Main/fg_props.hxx>
+#include <Main/globals.hxx>
+#include <Scripting/NasalSys.hxx>
+
 
 // Set up function for each test.
 void NasalSysTests::setUp()
 {
+    FGTestApi::setUp::initTestGlobals("NasalSys");
+
+    globals->get_subsystem_mgr()->bind();
+    globals->get_subsystem_mgr()->init();
+
+    FGTestApi::setUp::initStandardNasal();
+    globals->get_subsystem_mgr()->postinit();
 }
 
 
 // Clean up after each test.
 void NasalSysTests::tearDown()
 {
+    FGTestApi::tearDown::shutdownTestGlobals();
 }
 
 
@@ -38,3 +52,43 @@ void NasalSysTests::testDummy()
 {
     CPPUNIT_ASSERT(1 != 2);
 }
+
+
+// A deferred callback which dirties another deferred listener and then
+// removes it: the removed listener must not be called, nor be left in the
+// pending list once it is deleted.
+void NasalSysTests::testDeferredListenerRemovedWhileDirty()
+{
+    auto nasal = globals->get_subsystem<FGNasalSys>();
+    CPPUNIT_ASSERT(nasal);
+
+    bool ok = FGTestApi::executeNasal(R"(
+        var idA = _setlistener("/test/deferred/a", func {
+            setprop("/test/deferred/a-calls", getprop("/test/deferred/a-calls") + 1);
+        }, 0, 1, 1);
+
+        _setlistener("/test/deferred/b", func {
+            setprop("/test/deferred/a", 2);
+            removelistener(idA);
+            setprop("/test/deferred/b-calls", getprop("/test/deferred/b-calls") + 1);
+        }, 0, 1, 1);
+    )");
+    CPPUNIT_ASSERT(ok);
+
+    fgSetInt("/test/deferred/a-calls", 0);
+    fgSetInt("/test/deferred/b-calls", 0);
+
+    // only recorded, nothing called yet
+    fgSetInt("/test/deferred/b", 1);
+    CPPUNIT_ASSERT_EQUAL(0, fgGetInt("/test/deferred/b-calls"));
+
+    nasal->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(1, fgGetInt("/test/deferred/b-calls"));
+
+    // the listener of a was removed after it was dirtied
+    nasal->update(0.1);
+    nasal->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(0, fgGetInt("/test/deferred/a-calls"));
+    CPPUNIT_ASSERT_EQUAL(1, fgGetInt("/test/deferred/b-calls"));
+    CPPUNIT_ASSERT_EQUAL(0, fgGetInt("/sim/nasal-listeners/deferred-calls"));
+}
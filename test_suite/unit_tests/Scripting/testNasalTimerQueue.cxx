@@ -0,0 +1,130 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "Scripting/NasalTimerQueue.hxx"
+
+#include "testNasalTimerQueue.hxx"
+
+
+namespace {
+
+struct RecordingEntry : public NasalTimerQueue::Entry
+{
+    RecordingEntry(int i, std::vector<int>& l) : id(i), log(l) {}
+
+    void expired(naContext) override
+    {
+        log.push_back(id);
+        if (cancelOther) {
+            queue->cancel(cancelOther);
+        }
+        if (queue && (rescheduleDelay >= 0.0)) {
+            queue->schedule(this, rescheduleDelay);
+        }
+    }
+
+    int id;
+    std::vector<int>& log;
+    NasalTimerQueue* queue = nullptr;
+    NasalTimerQueue::Entry* cancelOther = nullptr;
+    double rescheduleDelay = -1.0;
+};
+
+} // of anonymous namespace
+
+
+void NasalTimerQueueTests::testExpiryOrder()
+{
+    std::vector<int> fired;
+    NasalTimerQueue queue;
+    std::vector<RecordingEntry> entries;
+    for (int i = 0; i < 100; ++i) {
+        entries.emplace_back(i, fired);
+    }
+
+    // schedule in reverse order of expiry, with duplicates
+    for (int i = 0; i < 100; ++i) {
+        queue.schedule(&entries[i], (99 - i) / 2);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(100), queue.size());
+
+    queue.advance(10.0);
+    CPPUNIT_ASSERT_EQUAL(22u, queue.fireExpired(nullptr));
+    queue.advance(100.0);
+    CPPUNIT_ASSERT_EQUAL(78u, queue.fireExpired(nullptr));
+    CPPUNIT_ASSERT(queue.empty());
+
+    // ties keep the order in which they were scheduled
+    CPPUNIT_ASSERT_EQUAL(98, fired[0]);
+    CPPUNIT_ASSERT_EQUAL(99, fired[1]);
+    CPPUNIT_ASSERT_EQUAL(0, fired[98]);
+    CPPUNIT_ASSERT_EQUAL(1, fired[99]);
+}
+
+void NasalTimerQueueTests::testCancel()
+{
+    std::vector<int> fired;
+    NasalTimerQueue queue;
+    RecordingEntry a(1, fired), b(2, fired), c(3, fired);
+    queue.schedule(&a, 1.0);
+    queue.schedule(&b, 2.0);
+    queue.schedule(&c, 3.0);
+
+    queue.cancel(&b);
+    CPPUNIT_ASSERT(!b.isScheduled());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), queue.size());
+
+    // moving an entry to a new due time
+    queue.schedule(&a, 5.0);
+    queue.advance(4.0);
+    CPPUNIT_ASSERT_EQUAL(1u, queue.fireExpired(nullptr));
+    CPPUNIT_ASSERT_EQUAL(3, fired.back());
+    CPPUNIT_ASSERT(a.isScheduled());
+}
+
+void NasalTimerQueueTests::testCancelWithinBatch()
+{
+    std::vector<int> fired;
+    NasalTimerQueue queue;
+    RecordingEntry a(1, fired), b(2, fired);
+    a.queue = &queue;
+    a.cancelOther = &b;
+    queue.schedule(&a, 0.0);
+    queue.schedule(&b, 0.0);
+
+    CPPUNIT_ASSERT_EQUAL(1u, queue.fireExpired(nullptr));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), fired.size());
+    CPPUNIT_ASSERT(!b.isScheduled());
+}
+
+void NasalTimerQueueTests::testRescheduleFromCallback()
+{
+    std::vector<int> fired;
+    NasalTimerQueue queue;
+    RecordingEntry a(1, fired);
+    a.queue = &queue;
+    a.rescheduleDelay = 0.0;
+    queue.schedule(&a, 0.0);
+
+    // a zero-delay timer re-arming itself fires once per call, not forever
+    CPPUNIT_ASSERT_EQUAL(1u, queue.fireExpired(nullptr));
+    CPPUNIT_ASSERT_EQUAL(1u, queue.fireExpired(nullptr));
+    CPPUNIT_ASSERT(a.isScheduled());
+    queue.cancel(&a);
+}
@@ -0,0 +1,416 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "test_electrical.hxx"
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/props/props.hxx>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <Main/fg_props.hxx>
+#include <Main/globals.hxx>
+#include <Systems/electrical.hxx>
+
+
+// Laid out like the classic single engine electrical systems shipped with
+// the base package: battery, alternator and external power feeding a
+// master bus, an avionics bus behind a switch, breakers on some outputs and
+// a charging path back into the battery.
+static const char* ELECTRICAL_XML = R"(<?xml version="1.0"?>
+<PropertyList>
+  <supplier>
+    <name>Battery 1</name>
+    <prop>/systems/electrical/suppliers/battery[0]</prop>
+    <kind>battery</kind>
+    <volts>24</volts>
+    <amp-hours>12</amp-hours>
+    <charge-amps>7</charge-amps>
+  </supplier>
+  <supplier>
+    <name>Alternator 1</name>
+    <prop>/systems/electrical/suppliers/alternator[0]</prop>
+    <kind>alternator</kind>
+    <rpm-source>/engines/engine[0]/rpm</rpm-source>
+    <rpm-threshold>800.0</rpm-threshold>
+    <volts>28</volts>
+    <amps>60</amps>
+  </supplier>
+  <supplier>
+    <name>External</name>
+    <prop>/systems/electrical/suppliers/external</prop>
+    <kind>external</kind>
+    <volts>28</volts>
+    <amps>100</amps>
+  </supplier>
+
+  <bus>
+    <name>Master Bus</name>
+    <prop>/systems/electrical/outputs/bus</prop>
+  </bus>
+  <bus>
+    <name>Avionics Bus</name>
+    <prop>/systems/electrical/outputs/avionics-bus</prop>
+  </bus>
+
+  <output><name>Starter</name><prop>/systems/electrical/outputs/starter</prop><rated-draw>50</rated-draw></output>
+  <output><name>Landing Light</name><prop>/systems/electrical/outputs/landing-lights</prop><rated-draw>8</rated-draw></output>
+  <output><name>Beacon</name><prop>/systems/electrical/outputs/beacon</prop><rated-draw>3</rated-draw></output>
+  <output><name>Nav Lights</name><prop>/systems/electrical/outputs/nav-lights</prop><rated-draw>2</rated-draw></output>
+  <output><name>Pitot Heat</name><prop>/systems/electrical/outputs/pitot-heat</prop><rated-draw>6</rated-draw></output>
+  <output><name>Flaps</name><prop>/systems/electrical/outputs/flaps</prop><rated-draw>5</rated-draw></output>
+  <output><name>Turn Coordinator</name><prop>/systems/electrical/outputs/turn-coordinator</prop></output>
+  <output><name>Comm 0</name><prop>/systems/electrical/outputs/comm[0]</prop><rated-draw>1</rated-draw></output>
+  <output><name>Nav 0</name><prop>/systems/electrical/outputs/nav[0]</prop><rated-draw>1</rated-draw></output>
+  <output><name>ADF</name><prop>/systems/electrical/outputs/adf</prop></output>
+  <output><name>Transponder</name><prop>/systems/electrical/outputs/transponder</prop></output>
+  <output><name>GPS</name><prop>/systems/electrical/outputs/gps</prop></output>
+
+  <connector>
+    <input>Battery 1</input>
+    <output>Master Bus</output>
+    <switch><prop>/controls/engines/engine[0]/master-bat</prop></switch>
+  </connector>
+  <connector>
+    <input>Alternator 1</input>
+    <output>Master Bus</output>
+    <switch><prop>/controls/engines/engine[0]/master-alt</prop></switch>
+  </connector>
+  <connector>
+    <input>External</input>
+    <output>Master Bus</output>
+    <switch><prop>/controls/electric/external-power</prop><initial-state>off</initial-state></switch>
+  </connector>
+  <connector>
+    <input>Master Bus</input>
+    <output>Battery 1</output>
+    <switch><prop>/controls/engines/engine[0]/master-bat</prop></switch>
+  </connector>
+  <connector>
+    <input>Master Bus</input>
+    <output>Avionics Bus</output>
+    <switch><prop>/controls/switches/master-avionics</prop></switch>
+  </connector>
+  <connector>
+    <input>Master Bus</input>
+    <output>Starter</output>
+    <switch><prop>/controls/switches/starter</prop><initial-state>off</initial-state></switch>
+  </connector>
+  <connector>
+    <input>Master Bus</input>
+    <output>Landing Light</output>
+    <switch><prop>/controls/switches/landing-light</prop></switch>
+    <switch><prop>/controls/circuit-breakers/landing-light</prop><rating-amps>10</rating-amps></switch>
+  </connector>
+  <connector>
+    <input>Master Bus</input>
+    <output>Beacon</output>
+    <switch><prop>/controls/switches/flashing-beacon</prop></switch>
+  </connector>
+  <connector>
+    <input>Master Bus</input>
+    <output>Nav Lights</output>
+    <switch><prop>/controls/switches/nav-lights</prop></switch>
+  </connector>
+  <connector>
+    <input>Master Bus</input>
+    <output>Pitot Heat</output>
+    <switch><prop>/controls/anti-ice/pitot-heat</prop><initial-state>off</initial-state></switch>
+  </connector>
+  <connector>
+    <input>Master Bus</input>
+    <output>Flaps</output>
+    <output>Turn Coordinator</output>
+  </connector>
+  <connector>
+    <input>Avionics Bus</input>
+    <output>Comm 0</output>
+    <output>Nav 0</output>
+    <output>ADF</output>
+    <output>Transponder</output>
+    <switch><prop>/controls/circuit-breakers/radios</prop><rating-amps>15</rating-amps></switch>
+  </connector>
+  <connector>
+    <input>Avionics Bus</input>
+    <output>GPS</output>
+  </connector>
+</PropertyList>
+)";
+
+// The recursive solver FGElectricalSystem::update() used before the
+// network was compiled, run on the components of a system which is never
+// updated itself.
+class ReferenceSolver
+{
+public:
+    ReferenceSolver(FGElectricalSystem& system, SGPropertyNode* xml)
+    {
+        for (auto s : xml->getChildren("supplier")) {
+            _suppliers.push_back(static_cast<FGElectricalSupplier*>(system.find(s->getStringValue("name"))));
+        }
+
+        // every component the suppliers, buses and outputs lead to
+        std::vector<FGElectricalComponent*> pending;
+        for (const char* kind : {"supplier", "bus", "output"}) {
+            for (auto c : xml->getChildren(kind)) {
+                pending.push_back(system.find(c->getStringValue("name")));
+            }
+        }
+        while (!pending.empty()) {
+            FGElectricalComponent* c = pending.back();
+            pending.pop_back();
+            if (_components.insert(c).second) {
+                for (int i = 0; i < c->get_num_outputs(); ++i) {
+                    pending.push_back(c->get_output(i));
+                }
+            }
+        }
+
+        _serviceable_node = fgGetNode("/systems/electrical/serviceable", true);
+    }
+
+    void solve(double dt)
+    {
+        _serviceable = _serviceable_node->getBoolValue();
+
+        // zero out the voltage before we start, but don't clear the
+        // requested load values.
+        for (auto c : _components) {
+            c->set_volts(0.0);
+        }
+
+        // the "external" suppliers first, then the alternators, then the
+        // batteries
+        for (auto model : {FGElectricalSupplier::FG_EXTERNAL,
+                           FGElectricalSupplier::FG_ALTERNATOR,
+                           FGElectricalSupplier::FG_BATTERY}) {
+            for (auto node : _suppliers) {
+                if (node->get_model() == model) {
+                    float load = propagate(node, dt, node->get_output_volts(),
+                                           node->get_output_amps());
+                    node->apply_load(load, dt);
+                }
+            }
+        }
+    }
+
+private:
+    // propagate the electrical current through the network, returns the
+    // total current drawn by the children of this node.
+    float propagate(FGElectricalComponent* node, double dt,
+                    float input_volts, float input_amps)
+    {
+        float total_load = 0.0;
+
+        // determine the current to carry forward
+        float volts = 0.0;
+        if (!_serviceable) {
+            volts = 0;
+        } else if (node->get_kind() == FGElectricalComponent::FG_SUPPLIER) {
+            FGElectricalSupplier* supplier = static_cast<FGElectricalSupplier*>(node);
+            if (supplier->get_model() == FGElectricalSupplier::FG_BATTERY) {
+                float battery_volts = supplier->get_output_volts();
+                if (battery_volts < (input_volts - 0.1)) {
+                    // special handling of a battery charge condition
+                    supplier->apply_load(-supplier->get_charge_amps(), dt);
+                    return supplier->get_charge_amps();
+                }
+            }
+            volts = input_volts;
+        } else if (node->get_kind() == FGElectricalComponent::FG_BUS) {
+            volts = input_volts;
+        } else if (node->get_kind() == FGElectricalComponent::FG_OUTPUT) {
+            volts = input_volts;
+            if (volts > 1.0) {
+                // draw current if we have voltage
+                total_load = node->get_load_amps();
+            }
+        } else if (node->get_kind() == FGElectricalComponent::FG_CONNECTOR) {
+            if (static_cast<FGElectricalConnector*>(node)->get_state()) {
+                volts = input_volts;
+            } else {
+                volts = 0.0;
+            }
+        }
+
+        // if this node has found a stronger power source, update the
+        // value and propagate to all children
+        if (volts > node->get_volts()) {
+            node->set_volts(volts);
+            for (int i = 0; i < node->get_num_outputs(); ++i) {
+                FGElectricalComponent* child = node->get_output(i);
+                // send current equal to load
+                total_load += propagate(child, dt, volts, child->get_load_amps());
+            }
+
+            // if not an output node, register the downstream current draw
+            // (sum of all children) with this node.
+            if (node->get_kind() != FGElectricalComponent::FG_OUTPUT) {
+                node->set_load_amps(total_load);
+            }
+            node->set_available_amps(input_amps - total_load);
+            node->publishVoltageToProps();
+            return total_load;
+        }
+
+        return 0.0;
+    }
+
+    std::vector<FGElectricalSupplier*> _suppliers;
+    std::set<FGElectricalComponent*> _components;
+    SGPropertyNode_ptr _serviceable_node;
+    bool _serviceable = true;
+};
+
+
+// Run the compiled solver of one system and the reference solver on the
+// components of another, both built from the same configuration, through
+// an engine run, switches going on and off and the system failing, and
+// check they come to the same results.
+static void checkCompiledMatchesRecursive(const SGPath& configPath)
+{
+    SGPropertyNode_ptr config(new SGPropertyNode);
+    config->setStringValue("path", configPath.utf8Str());
+
+    // each has its own battery charge; they share switches and outputs
+    FGElectricalSystem reference(config);
+    FGElectricalSystem compiled(config);
+    reference.bind();
+    reference.init();
+    compiled.bind();
+    compiled.init();
+
+    SGPropertyNode_ptr xml(new SGPropertyNode);
+    readProperties(configPath, xml);
+    ReferenceSolver solver(reference, xml);
+
+    std::vector<SGPropertyNode_ptr> outputs;
+    std::vector<std::string> names;
+    for (const char* kind : {"supplier", "bus", "output"}) {
+        for (auto c : xml->getChildren(kind)) {
+            for (auto prop : c->getChildren("prop")) {
+                outputs.push_back(fgGetNode(prop->getStringValue(), true));
+            }
+            names.push_back(c->getStringValue("name"));
+        }
+    }
+
+    std::vector<std::string> switches;
+    for (auto c : xml->getChildren("connector")) {
+        for (auto sw : c->getChildren("switch")) {
+            const std::string prop = sw->getStringValue("prop");
+            if (std::find(switches.begin(), switches.end(), prop) == switches.end()) {
+                switches.push_back(prop);
+            }
+        }
+    }
+    CPPUNIT_ASSERT(!switches.empty());
+
+    SGPropertyNode_ptr rpm = fgGetNode("/engines/engine[0]/rpm", true);
+    SGPropertyNode_ptr serviceable = fgGetNode("/systems/electrical/serviceable", true);
+    serviceable->setBoolValue(true);
+
+    const double dt = 0.5;
+    std::vector<float> expected(outputs.size()), actual(outputs.size());
+
+    for (int frame = 0; frame < 2000; ++frame) {
+        // engine running up and down, with a stretch below the alternator
+        // threshold and the battery running low
+        rpm->setDoubleValue((frame % 400 < 250) ? (frame % 400) * 10.0 : 0.0);
+        fgSetBool(switches[(frame * 7) % switches.size()], (frame / 13) % 3 != 0);
+        serviceable->setBoolValue(frame % 500 < 480);
+
+        // outputs without voltage keep their previous value: reset them so
+        // each solver's result is seen on its own
+        for (auto p : outputs) {
+            p->setFloatValue(-1.0);
+        }
+        solver.solve(dt);
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            expected[i] = outputs[i]->getFloatValue();
+        }
+
+        for (auto p : outputs) {
+            p->setFloatValue(-1.0);
+        }
+        compiled.update(dt);
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            actual[i] = outputs[i]->getFloatValue();
+        }
+
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(outputs[i]->getPath() + " at frame " + std::to_string(frame),
+                                         expected[i], actual[i]);
+        }
+
+        // the components see the same voltage and currents as well
+        for (const auto& name : names) {
+            FGElectricalComponent* r = reference.find(name);
+            FGElectricalComponent* c = compiled.find(name);
+            CPPUNIT_ASSERT(r && c);
+            const std::string at = name + " at frame " + std::to_string(frame);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("volts of " + at, r->get_volts(), c->get_volts());
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("load of " + at, r->get_load_amps(), c->get_load_amps());
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("available amps of " + at,
+                                         r->get_available_amps(), c->get_available_amps());
+        }
+    }
+
+    compiled.unbind();
+    reference.unbind();
+}
+
+
+// Set up function for each test.
+void ElectricalTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("electrical");
+}
+
+
+// Clean up after each test.
+void ElectricalTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void ElectricalTests::testCompiledMatchesRecursive()
+{
+    const SGPath configPath = globals->get_fg_home() / "test_electrical.xml";
+    {
+        sg_ofstream f(configPath);
+        f << ELECTRICAL_XML;
+    }
+
+    checkCompiledMatchesRecursive(configPath);
+}
+
+
+void ElectricalTests::testCompiledMatchesRecursiveC172p()
+{
+    checkCompiledMatchesRecursive(SGPath::fromUtf8(FGSRCDIR) /
+                                  "test_suite/unit_tests/Systems/data/c172p-electrical.xml");
+}
@@ -0,0 +1,294 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_trafficCache.hxx"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+#include <Traffic/TrafficCache.hxx>
+
+using flightgear::TrafficCache;
+
+namespace {
+
+// Collects replayed records, and the order they came in.
+class RecordingSink : public TrafficCache::Sink
+{
+public:
+    void addFlight(const TrafficCache::FlightRecord& record) override
+    {
+        flights.push_back(record);
+        order += 'F';
+    }
+
+    void addAircraft(const TrafficCache::AircraftRecord& record) override
+    {
+        aircraft.push_back(record);
+        order += 'A';
+    }
+
+    std::vector<TrafficCache::FlightRecord> flights;
+    std::vector<TrafficCache::AircraftRecord> aircraft;
+    std::string order;
+};
+
+TrafficCache::FlightRecord makeFlight(const std::string& callsign, int cruiseAlt)
+{
+    TrafficCache::FlightRecord f;
+    f.callsign = callsign;
+    f.fltRules = "IFR";
+    f.departurePort = "EHAM";
+    f.arrivalPort = "EGLL";
+    f.departureTime = "0/07:20:00";
+    f.arrivalTime = "0/08:25:00";
+    f.repeat = "WEEK";
+    f.requiredAircraft = "KLM-B737";
+    f.cruiseAlt = cruiseAlt;
+    return f;
+}
+
+TrafficCache::AircraftRecord makeAircraft()
+{
+    TrafficCache::AircraftRecord a;
+    a.model = "Aircraft/737/Models/737.xml";
+    a.livery = "KLM";
+    a.homePort = "EHAM";
+    a.registration = "PH-BXA";
+    a.requiredAircraft = "KLM-B737";
+    a.acType = "B738";
+    a.airline = "KLM";
+    a.perfClass = "jet_transport";
+    a.flightType = "gate";
+    a.lastDeparturePort = "EGLL";
+    a.radius = 18.0;
+    a.offset = 4.5;
+    a.heavy = true;
+    return a;
+}
+
+// What the schedule parser does for a file it had to parse.
+void recordSchedule(TrafficCache& cache, const SGPath& source, const SGPath& include)
+{
+    cache.beginFile(source);
+    cache.addDependency(include);
+    cache.record(makeFlight("KLM1001", 240));
+    cache.record(makeAircraft());
+    cache.record(makeFlight("KLM1002", 350));
+    cache.endFile();
+}
+
+void checkFlight(const TrafficCache::FlightRecord& expected, const TrafficCache::FlightRecord& actual)
+{
+    CPPUNIT_ASSERT_EQUAL(expected.callsign, actual.callsign);
+    CPPUNIT_ASSERT_EQUAL(expected.fltRules, actual.fltRules);
+    CPPUNIT_ASSERT_EQUAL(expected.departurePort, actual.departurePort);
+    CPPUNIT_ASSERT_EQUAL(expected.arrivalPort, actual.arrivalPort);
+    CPPUNIT_ASSERT_EQUAL(expected.departureTime, actual.departureTime);
+    CPPUNIT_ASSERT_EQUAL(expected.arrivalTime, actual.arrivalTime);
+    CPPUNIT_ASSERT_EQUAL(expected.repeat, actual.repeat);
+    CPPUNIT_ASSERT_EQUAL(expected.requiredAircraft, actual.requiredAircraft);
+    CPPUNIT_ASSERT_EQUAL(expected.cruiseAlt, actual.cruiseAlt);
+}
+
+void checkAircraft(const TrafficCache::AircraftRecord& expected, const TrafficCache::AircraftRecord& actual)
+{
+    CPPUNIT_ASSERT_EQUAL(expected.model, actual.model);
+    CPPUNIT_ASSERT_EQUAL(expected.livery, actual.livery);
+    CPPUNIT_ASSERT_EQUAL(expected.homePort, actual.homePort);
+    CPPUNIT_ASSERT_EQUAL(expected.registration, actual.registration);
+    CPPUNIT_ASSERT_EQUAL(expected.requiredAircraft, actual.requiredAircraft);
+    CPPUNIT_ASSERT_EQUAL(expected.acType, actual.acType);
+    CPPUNIT_ASSERT_EQUAL(expected.airline, actual.airline);
+    CPPUNIT_ASSERT_EQUAL(expected.perfClass, actual.perfClass);
+    CPPUNIT_ASSERT_EQUAL(expected.flightType, actual.flightType);
+    CPPUNIT_ASSERT_EQUAL(expected.lastDeparturePort, actual.lastDeparturePort);
+    CPPUNIT_ASSERT_EQUAL(expected.radius, actual.radius);
+    CPPUNIT_ASSERT_EQUAL(expected.offset, actual.offset);
+    CPPUNIT_ASSERT_EQUAL(expected.heavy, actual.heavy);
+}
+
+void checkReplayed(const RecordingSink& sink)
+{
+    CPPUNIT_ASSERT_EQUAL(std::string("FAF"), sink.order);
+    checkFlight(makeFlight("KLM1001", 240), sink.flights[0]);
+    checkFlight(makeFlight("KLM1002", 350), sink.flights[1]);
+    checkAircraft(makeAircraft(), sink.aircraft[0]);
+}
+
+void writeFile(const SGPath& path, const std::string& contents)
+{
+    sg_ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+}
+
+std::string readFile(const SGPath& path)
+{
+    sg_ifstream in(path, std::ios::in | std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Rewrite a file until its modification time (in seconds) has moved on.
+void touch(const SGPath& path)
+{
+    const time_t before = SGPath::fromUtf8(path.utf8Str()).modTime();
+    do {
+        SGTimeStamp::sleepForMSec(100);
+        writeFile(path, "<?xml version=\"1.0\"?>\n<trafficlist/>\n");
+    } while (SGPath::fromUtf8(path.utf8Str()).modTime() == before);
+}
+
+} // of anonymous namespace
+
+
+// Set up function for each test.
+void TrafficCacheTests::setUp()
+{
+    _dir = simgear::Dir::tempDir("fgtrafficcache").path();
+    _cacheFile = _dir / "traffic.cache";
+    _source = _dir / "KLM.xml";
+    _include = _dir / "KLM-fleet.xml";
+    writeFile(_source, "<?xml version=\"1.0\"?>\n<trafficlist include=\"KLM-fleet.xml\"/>\n");
+    writeFile(_include, "<?xml version=\"1.0\"?>\n<trafficlist/>\n");
+}
+
+
+// Clean up after each test.
+void TrafficCacheTests::tearDown()
+{
+    simgear::Dir(_dir).remove(true);
+}
+
+
+// Parse (record) the schedule file into a new cache file.
+void TrafficCacheTests::writeCache()
+{
+    TrafficCache cache(_cacheFile);
+    cache.open();
+    RecordingSink sink;
+    CPPUNIT_ASSERT(!cache.replay(_source, sink));
+    recordSchedule(cache, _source, _include);
+    cache.save();
+    CPPUNIT_ASSERT(_cacheFile.exists());
+}
+
+
+// The cached copy must not be used: the file is parsed again, and the
+// cache written back is good for the next run.
+void TrafficCacheTests::checkParsedAgain()
+{
+    {
+        TrafficCache cache(_cacheFile);
+        cache.open();
+        RecordingSink sink;
+        CPPUNIT_ASSERT(!cache.replay(_source, sink));
+        CPPUNIT_ASSERT(sink.order.empty());
+
+        recordSchedule(cache, _source, _include);
+        cache.save();
+        CPPUNIT_ASSERT_EQUAL(0u, cache.hits());
+        CPPUNIT_ASSERT_EQUAL(1u, cache.misses());
+    }
+
+    TrafficCache cache(_cacheFile);
+    cache.open();
+    RecordingSink sink;
+    CPPUNIT_ASSERT(cache.replay(_source, sink));
+    checkReplayed(sink);
+}
+
+
+void TrafficCacheTests::testRoundTrip()
+{
+    writeCache();
+
+    TrafficCache cache(_cacheFile);
+    cache.open();
+    RecordingSink sink;
+    CPPUNIT_ASSERT(cache.replay(_source, sink));
+    checkReplayed(sink);
+    CPPUNIT_ASSERT_EQUAL(1u, cache.hits());
+    CPPUNIT_ASSERT_EQUAL(0u, cache.misses());
+
+    // files which were never parsed are not in the cache
+    RecordingSink other;
+    CPPUNIT_ASSERT(!cache.replay(_dir / "AFR.xml", other));
+    CPPUNIT_ASSERT(other.order.empty());
+}
+
+
+void TrafficCacheTests::testSourceChanged()
+{
+    writeCache();
+    touch(_source);
+    checkParsedAgain();
+}
+
+
+void TrafficCacheTests::testIncludeChanged()
+{
+    writeCache();
+    touch(_include);
+    checkParsedAgain();
+
+    // the cache is valid again now, until the included file goes away
+    _include.remove();
+    checkParsedAgain();
+}
+
+
+void TrafficCacheTests::testTruncatedFile()
+{
+    writeCache();
+    const std::string data = readFile(_cacheFile);
+
+    writeFile(_cacheFile, data.substr(0, data.size() / 2));
+    checkParsedAgain();
+
+    writeFile(_cacheFile, data.substr(0, data.size() - 1));
+    checkParsedAgain();
+
+    writeFile(_cacheFile, std::string());
+    checkParsedAgain();
+}
+
+
+void TrafficCacheTests::testUnknownRecordType()
+{
+    writeCache();
+    std::string data = readFile(_cacheFile);
+
+    // The records of the file end with the aircraft and the second flight;
+    // an aircraft is its type byte, ten string ids, two doubles and the
+    // heavy flag, a flight its type byte, eight string ids and the cruise
+    // altitude.  A record type the reader does not know must not be read
+    // as some other record of the same size.
+    const size_t flightSize = 1 + 8 * sizeof(uint32_t) + sizeof(int32_t);
+    const size_t aircraftSize = 1 + 10 * sizeof(uint32_t) + 2 * sizeof(double) + 1;
+    CPPUNIT_ASSERT(data.size() > flightSize + aircraftSize);
+    const size_t typeOffset = data.size() - flightSize - aircraftSize;
+    CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(data[typeOffset]));
+    data[typeOffset] = 7;
+    writeFile(_cacheFile, data);
+    checkParsedAgain();
+}
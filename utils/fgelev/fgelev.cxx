@@ -20,9 +20,30 @@
 #include <config.h>
 #endif
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <simgear/compiler.h>
+
+#ifdef SG_WINDOWS
+#  include <iterator>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
 
 #include <osg/ArgumentParser>
 #include <osg/Image>
@@ -87,6 +108,242 @@ intersect(sg::BVHNode& node, sg::BVHPager& pager,
     return true;
 }
 
+static std::mutex stderrMutex;
+
+struct Point {
+    std::string id;
+    double lon;
+    double lat;
+};
+
+struct Result {
+    bool found = false;
+    bool solid = false;
+    double elevation = -1000;
+};
+
+static Result
+elevation(sg::BVHNode& node, sg::BVHPager& pager, unsigned expire,
+          double lon, double lat)
+{
+    // Increment the paging relevant number
+    pager.setUseStamp(1 + pager.getUseStamp());
+    // and expire everything not accessed for the past expire requests
+    pager.update(expire);
+
+    SGVec3d start = SGVec3d::fromGeod(SGGeod::fromDegM(lon, lat, 10000));
+    SGVec3d end = SGVec3d::fromGeod(SGGeod::fromDegM(lon, lat, -1000));
+
+    const simgear::BVHMaterial* material = NULL;
+    // Try to find an intersection
+    bool found = intersect(node, pager, start, end, 0, &material);
+    double scale = 1e-5;
+    while (!found && scale <= 1) {
+        found = intersect(node, pager, start, end, scale, &material);
+        scale *= 2;
+    }
+    if (1e-5 < scale) {
+        std::lock_guard<std::mutex> lock(stderrMutex);
+        std::cerr << "Found hole of minimum diameter "
+                  << scale << "m at lon = " << lon
+                  << "deg lat = " << lat << "deg" << std::endl;
+    }
+
+    Result result;
+    if (found) {
+        result.found = true;
+        result.solid = material && material->get_solid();
+        result.elevation = SGGeod::fromCart(end).getElevationM();
+    }
+    return result;
+}
+
+static void
+printResult(std::ostream& out, const std::string& id, const Result& result,
+            bool printSolidness)
+{
+    out << id << ": ";
+    if (!result.found) {
+        out << "-1000" << '\n';
+    } else {
+        out << std::fixed << std::setprecision(3) << result.elevation;
+        if( printSolidness )
+            out <<  " " << (result.solid ? "solid" : "-");
+        out << '\n';
+    }
+}
+
+// Read-only view of a batch file, mapped where the platform allows.
+class InputFile {
+public:
+    explicit InputFile(const std::string& path)
+    {
+#ifdef SG_WINDOWS
+        std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+        if (in.is_open()) {
+            _buffer.assign(std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>());
+            _data = _buffer.data();
+            _size = _buffer.size();
+            _ok = true;
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+
+        struct stat st;
+        if (::fstat(fd, &st) == 0) {
+            _ok = true;
+            if (st.st_size > 0) {
+                void* m = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (m != MAP_FAILED) {
+                    _data = static_cast<const char*>(m);
+                    _size = st.st_size;
+                } else {
+                    _ok = false;
+                }
+            }
+        }
+
+        ::close(fd);
+#endif
+    }
+
+    ~InputFile()
+    {
+#ifndef SG_WINDOWS
+        if (_data)
+            ::munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+
+    bool ok() const
+    { return _ok; }
+    const char* data() const
+    { return _data; }
+    size_t size() const
+    { return _size; }
+
+private:
+    bool _ok = false;
+    const char* _data = nullptr;
+    size_t _size = 0;
+#ifdef SG_WINDOWS
+    std::vector<char> _buffer;
+#endif
+};
+
+// Text batch: one "id lon lat" per line, like the interactive mode.
+static bool
+parseText(const InputFile& file, std::vector<Point>& points)
+{
+    const char* pos = file.data();
+    const char* end = pos + file.size();
+    std::string line;
+    while (pos < end) {
+        const char* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (!eol)
+            eol = end;
+        line.assign(pos, eol);
+        pos = eol + 1;
+
+        const char* c = line.c_str();
+        while (*c && std::isspace(static_cast<unsigned char>(*c)))
+            ++c;
+        if (!*c)
+            continue; // blank line
+
+        const char* idEnd = c;
+        while (*idEnd && !std::isspace(static_cast<unsigned char>(*idEnd)))
+            ++idEnd;
+
+        Point point;
+        point.id.assign(c, idEnd);
+        char* next;
+        point.lon = std::strtod(idEnd, &next);
+        if (next == idEnd)
+            return false;
+        const char* latStart = next;
+        point.lat = std::strtod(latStart, &next);
+        if (next == latStart)
+            return false;
+        points.push_back(point);
+    }
+    return true;
+}
+
+// Binary batch: packed pairs of float64 lon, lat in host byte order.
+static bool
+parseBinary(const InputFile& file, std::vector<Point>& points)
+{
+    const size_t recordSize = 2 * sizeof(double);
+    if (file.size() % recordSize)
+        return false;
+
+    const size_t count = file.size() / recordSize;
+    points.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        double lonLat[2];
+        std::memcpy(lonLat, file.data() + i * recordSize, recordSize);
+        points[i].lon = lonLat[0];
+        points[i].lat = lonLat[1];
+    }
+    return true;
+}
+
+// Evaluate the points on the given number of threads.  Every thread pages
+// its own copy of the world tree, so points are sorted by degree tile and
+// every thread gets a contiguous run of tiles to keep those copies small.
+static bool
+evaluateBatch(const std::vector<Point>& points, std::vector<Result>& results,
+              unsigned threadCount, unsigned expire,
+              const osg::ref_ptr<simgear::SGReaderWriterOptions>& options)
+{
+    std::vector<size_t> order(points.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    auto tileOf = [&points](size_t i) {
+        return std::make_pair(std::floor(points[i].lat), std::floor(points[i].lon));
+    };
+    std::stable_sort(order.begin(), order.end(), [&tileOf](size_t a, size_t b) {
+        return tileOf(a) < tileOf(b);
+    });
+
+    results.assign(points.size(), Result());
+    threadCount = std::max(1u, std::min<unsigned>(threadCount, points.size()));
+    std::atomic<bool> ok(true);
+
+    auto worker = [&](size_t first, size_t last) {
+        SGSharedPtr<sg::BVHNode> node;
+        node = sg::BVHPageNodeOSG::load("w180s90-360x180.spt", options);
+        if (!node.valid()) {
+            ok = false;
+            return;
+        }
+
+        sg::BVHPager pager;
+        for (size_t k = first; k < last; ++k) {
+            const Point& point = points[order[k]];
+            results[order[k]] = elevation(*node, pager, expire,
+                                          point.lon, point.lat);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const size_t perThread = (points.size() + threadCount - 1) / threadCount;
+    for (unsigned t = 1; t < threadCount; ++t) {
+        const size_t first = std::min(points.size(), t * perThread);
+        const size_t last = std::min(points.size(), first + perThread);
+        threads.emplace_back(worker, first, last);
+    }
+    worker(0, std::min(points.size(), perThread));
+    for (auto& thread : threads)
+        thread.join();
+
+    return ok;
+}
+
 int
 main(int argc, char** argv)
 {
@@ -101,6 +358,15 @@ main(int argc, char** argv)
 
     bool printSolidness = arguments.read("--print-solidness");
 
+    std::string inputFile;
+    bool batch = arguments.read("--input", inputFile);
+    bool binary = arguments.read("--binary");
+    std::string outputFile;
+    arguments.read("--output", outputFile);
+    unsigned threadCount;
+    if (arguments.read("--threads", threadCount)) {
+    } else threadCount = std::max(1u, std::thread::hardware_concurrency());
+
     std::string fg_root;
     if (arguments.read("--fg-root", fg_root)) {
     } else if (const char *fg_root_env = std::getenv("FG_ROOT")) {
@@ -180,7 +446,59 @@ main(int argc, char** argv)
     arguments.reportRemainingOptionsAsUnrecognized();
     arguments.writeErrorMessages(std::cerr);
 
-    // Get the whole world bvh tree
+    if (batch) {
+        InputFile file(inputFile);
+        std::vector<Point> points;
+        if (!file.ok() ||
+            !(binary ? parseBinary(file, points) : parseText(file, points))) {
+            SG_LOG(SG_GENERAL, SG_ALERT, arguments.getApplicationName()
+                   << ": Cannot read " << inputFile);
+            return EXIT_FAILURE;
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        std::vector<Result> results;
+        if (!evaluateBatch(points, results, threadCount, expire, options)) {
+            SG_LOG(SG_GENERAL, SG_ALERT, arguments.getApplicationName()
+                   << ": No data loaded");
+            return EXIT_FAILURE;
+        }
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - startTime;
+
+        std::ofstream outFile;
+        if (!outputFile.empty()) {
+            outFile.open(outputFile.c_str(), binary ? std::ios::out | std::ios::binary
+                                                    : std::ios::out);
+            if (!outFile.is_open()) {
+                SG_LOG(SG_GENERAL, SG_ALERT, arguments.getApplicationName()
+                       << ": Cannot write " << outputFile);
+                return EXIT_FAILURE;
+            }
+        }
+        std::ostream& out = outputFile.empty() ? std::cout : outFile;
+
+        if (binary) {
+            // packed float64 elevations, -1000 where no ground was found
+            for (const auto& result : results)
+                out.write(reinterpret_cast<const char*>(&result.elevation),
+                          sizeof(result.elevation));
+        } else {
+            for (size_t i = 0; i < points.size(); ++i)
+                printResult(out, points[i].id, results[i], printSolidness);
+        }
+        out.flush();
+
+        std::cerr << points.size() << " points in " << std::fixed
+                  << std::setprecision(3) << elapsed.count() << "s on "
+                  << threadCount << " threads ("
+                  << std::setprecision(0)
+                  << (elapsed.count() > 0 ? points.size() / elapsed.count() : 0.0)
+                  << " points/s)" << std::endl;
+        return out.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Interactive mode: get the whole world bvh tree
     SGSharedPtr<sg::BVHNode> node;
     node = sg::BVHPageNodeOSG::load("w180s90-360x180.spt", options);
 
@@ -195,11 +513,6 @@ main(int argc, char** argv)
     sg::BVHPager pager;
 
     while (std::cin.good()) {
-        // Increment the paging relevant number
-        pager.setUseStamp(1 + pager.getUseStamp());
-        // and expire everything not accessed for the past 30 requests
-        pager.update(expire);
-
         std::string id;
         std::cin >> id;
         double lon, lat;
@@ -208,33 +521,10 @@ main(int argc, char** argv)
             return EXIT_FAILURE;
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
-        SGVec3d start = SGVec3d::fromGeod(SGGeod::fromDegM(lon, lat, 10000));
-        SGVec3d end = SGVec3d::fromGeod(SGGeod::fromDegM(lon, lat, -1000));
-
-        const simgear::BVHMaterial* material = NULL;
-        // Try to find an intersection
-        bool found = intersect(*node, pager, start, end, 0, &material);
-        double scale = 1e-5;
-        while (!found && scale <= 1) {
-            found = intersect(*node, pager, start, end, scale, &material);
-            scale *= 2;
-        }
-        if (1e-5 < scale)
-            std::cerr << "Found hole of minimum diameter "
-                      << scale << "m at lon = " << lon
-                      << "deg lat = " << lat << "deg" << std::endl;
-
-        std::cout << id << ": ";
-        string solid = material && material->get_solid() ? "solid" : "-";
-        if (!found) {
-            std::cout << "-1000" << std::endl;
-        } else {
-            SGGeod geod = SGGeod::fromCart(end);
-            std::cout << std::fixed << std::setprecision(3) << geod.getElevationM();
-            if( printSolidness )
-                std::cout <<  " " << (material && material->get_solid() ? "solid" : "-");
-            std::cout << std::endl;
-        }
+        printResult(std::cout, id, elevation(*node, pager, expire, lon, lat),
+                    printSolidness);
+        // answer right away, the caller may wait for it before the next point
+        std::cout.flush();
     }
 
     return EXIT_SUCCESS;
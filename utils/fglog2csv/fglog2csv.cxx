@@ -0,0 +1,189 @@
+// fglog2csv.cxx -- convert binary FGLogger output to CSV
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Must match FGLogger::ColumnType / FGLogger::BINARY_* in src/Main/logger.hxx
+enum ColumnType {
+    COLUMN_BOOL = 0,
+    COLUMN_INT = 1,
+    COLUMN_DOUBLE = 2,
+    COLUMN_STRING = 3,
+    COLUMN_FLOAT = 4
+};
+
+static const char BINARY_MAGIC[8] = { 'F', 'G', 'L', 'O', 'G', 'B', 'I', 'N' };
+static const uint32_t BINARY_VERSION = 2;
+
+template <typename T>
+static bool readBinary(std::istream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+static bool readBinaryString(std::istream& in, std::string& value)
+{
+    uint16_t len;
+    if (!readBinary(in, len))
+        return false;
+
+    value.resize(len);
+    return (len == 0) || static_cast<bool>(in.read(&value[0], len));
+}
+
+static void usage()
+{
+    std::cerr << "Usage: fglog2csv <binary log> [<csv file>]" << std::endl;
+    std::cerr << "Writes to stdout when no CSV file is given." << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    if ((argc < 2) || (argc > 3)) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream in(argv[1], std::ios_base::in | std::ios_base::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream file;
+    if (argc == 3) {
+        file.open(argv[2], std::ios_base::out);
+        if (!file) {
+            std::cerr << "Cannot write " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& out = (argc == 3) ? file : std::cout;
+
+    char magic[sizeof(BINARY_MAGIC)];
+    uint32_t version, count;
+    uint8_t delimiter;
+    if (!in.read(magic, sizeof(magic)) ||
+        (memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0) ||
+        !readBinary(in, version) || !readBinary(in, delimiter) ||
+        !readBinary(in, count)) {
+        std::cerr << argv[1] << " is not a binary FlightGear log" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // version 1 is the same layout without float columns
+    if ((version < 1) || (version > BINARY_VERSION)) {
+        std::cerr << argv[1] << ": unsupported log version " << version << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint8_t> types(count);
+    out << "Time";
+    for (uint32_t i = 0; i < count; i++) {
+        std::string title;
+        if (!readBinary(in, types[i]) || !readBinaryString(in, title) ||
+            (types[i] > COLUMN_FLOAT)) {
+            std::cerr << argv[1] << ": corrupt column header" << std::endl;
+            return EXIT_FAILURE;
+        }
+        out << static_cast<char>(delimiter) << title;
+    }
+    out << '\n';
+
+    // Values are formatted the way SGPropertyNode::getStringValue() does,
+    // so the result matches what a CSV log would have contained: doubles
+    // with 10 significant digits, floats with the stream default.
+    std::ostringstream value;
+    value.precision(10);
+    double time;
+    size_t rows = 0;
+    while (readBinary(in, time)) {
+        out << time;
+        for (uint32_t i = 0; i < count; i++) {
+            bool ok = true;
+            out << static_cast<char>(delimiter);
+            switch (types[i]) {
+            case COLUMN_BOOL: {
+                uint8_t b = 0;
+                ok = readBinary(in, b);
+                out << (b ? "true" : "false");
+                break;
+            }
+            case COLUMN_INT: {
+                int64_t l = 0;
+                ok = readBinary(in, l);
+                out << l;
+                break;
+            }
+            case COLUMN_FLOAT: {
+                float f = 0.0f;
+                ok = readBinary(in, f);
+                out << f;
+                break;
+            }
+            case COLUMN_DOUBLE: {
+                double d = 0.0;
+                ok = readBinary(in, d);
+                value.str(std::string());
+                value << d;
+                out << value.str();
+                break;
+            }
+            case COLUMN_STRING: {
+                std::string s;
+                ok = readBinaryString(in, s);
+                out << s;
+                break;
+            }
+            }
+
+            if (!ok) {
+                std::cerr << argv[1] << ": truncated row " << rows
+                          << ", stopping" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        out << '\n';
+        if (!out) {
+            std::cerr << "Error writing row " << rows << std::endl;
+            return EXIT_FAILURE;
+        }
+        ++rows;
+    }
+
+    out.flush();
+    if (argc == 3)
+        file.close();
+
+    if (!out) {
+        std::cerr << "Error writing " << ((argc == 3) ? argv[2] : "output")
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}